@@ -68,6 +68,7 @@
  * @brief Enesim API
  */
 
+#include <stdio.h>
 #include <inttypes.h>
 
 #include <Eina.h>
@@ -135,6 +136,7 @@ extern "C" {
 #include "enesim_renderer_grid.h"
 #include "enesim_renderer_image.h"
 #include "enesim_renderer_importer.h"
+#include "enesim_renderer_layer.h"
 #include "enesim_renderer_perlin.h"
 #include "enesim_renderer_pattern.h"
 #include "enesim_renderer_proxy.h"
@@ -154,6 +156,7 @@ extern "C" {
 #include "enesim_renderer_path.h"
 #include "enesim_renderer_rectangle.h"
 #include "enesim_renderer_text_span.h"
+#include "enesim_renderer_text_grid.h"
 
 #include "enesim_renderer_map_quad.h"
 
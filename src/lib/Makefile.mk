@@ -67,6 +67,8 @@ src/lib/enesim_rectangle.c \
 src/lib/enesim_renderer.c \
 src/lib/enesim_renderer_opengl_private.h \
 src/lib/enesim_renderer_private.h \
+src/lib/enesim_renderer_profile.c \
+src/lib/enesim_renderer_profile_private.h \
 src/lib/enesim_renderer_sw.c \
 src/lib/enesim_renderer_sw_private.h \
 src/lib/enesim_stream_private.h \
@@ -23,10 +23,76 @@
 
 #include "enesim_color_private.h"
 #include "enesim_converter_private.h"
+
+#ifdef ENS_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 /*============================================================================*
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
+/* 16.16 reciprocals of the alpha, scaled by 255. A premultiplied component
+ * multiplied by it gives exactly the same value as (c * 255) / a
+ */
+static uint32_t _unpremul[256];
+
+static inline uint32_t _unpremul_component(uint32_t c, uint32_t r)
+{
+	c = (c * r) >> 16;
+	/* a component bigger than the alpha is not valid premultiplied data */
+	return c > 255 ? 255 : c;
+}
+
+static inline uint32_t _unpremul_pixel(uint32_t p)
+{
+	uint32_t pa = p >> 24;
+	uint32_t r;
+
+	if (pa == 0 || pa == 255)
+		return p;
+	r = _unpremul[pa];
+	return (pa << 24) |
+			(_unpremul_component(enesim_color_red_get(p), r) << 16) |
+			(_unpremul_component(enesim_color_green_get(p), r) << 8) |
+			_unpremul_component(enesim_color_blue_get(p), r);
+}
+
+static void _1d_argb8888_none_argb8888_pre(uint32_t *dst, uint32_t *src,
+		uint32_t len)
+{
+#ifdef ENS_HAVE_SSE2
+	const __m128i opaque = _mm_set1_epi32(0xff);
+	const __m128i transparent = _mm_setzero_si128();
+
+	/* groups of fully opaque or fully transparent pixels are copied */
+	while (len >= 4)
+	{
+		__m128i p, a, same;
+
+		p = _mm_loadu_si128((__m128i *)src);
+		a = _mm_srli_epi32(p, 24);
+		same = _mm_or_si128(_mm_cmpeq_epi32(a, opaque),
+				_mm_cmpeq_epi32(a, transparent));
+		if (_mm_movemask_epi8(same) == 0xffff)
+		{
+			_mm_storeu_si128((__m128i *)dst, p);
+		}
+		else
+		{
+			dst[0] = _unpremul_pixel(src[0]);
+			dst[1] = _unpremul_pixel(src[1]);
+			dst[2] = _unpremul_pixel(src[2]);
+			dst[3] = _unpremul_pixel(src[3]);
+		}
+		src += 4;
+		dst += 4;
+		len -= 4;
+	}
+#endif
+	while (len--)
+		*dst++ = _unpremul_pixel(*src++);
+}
+
 static void _2d_argb8888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t dw, uint32_t dh,
 		Enesim_Buffer_Sw_Data *sdata, uint32_t sw EINA_UNUSED, uint32_t sh EINA_UNUSED)
 {
@@ -37,28 +103,7 @@ static void _2d_argb8888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t
 
 	while (dh--)
 	{
-		uint32_t *ddst = (uint32_t *)dst;
-		uint32_t *ssrc = (uint32_t *)src;
-		uint32_t ddw = dw;
-		while (ddw--)
-		{
-			uint8_t pa;
-
-			pa = (*ssrc >> 24);
-			if ((pa > 0) && (pa < 255))
-			{
-				*ddst = (pa << 24)|
-					(((enesim_color_red_get(*ssrc) * 255) / pa) << 16) |
-					(((enesim_color_green_get(*ssrc) * 255) / pa) << 8) |
-					((enesim_color_blue_get(*ssrc) * 255) / pa);
-			}
-			else
-			{
-				*ddst = *ssrc;
-			}
-			ssrc++;
-			ddst++;
-		}
+		_1d_argb8888_none_argb8888_pre((uint32_t *)dst, (uint32_t *)src, dw);
 		dst += dstride;
 		src += sstride;
 	}
@@ -69,6 +114,11 @@ static void _2d_argb8888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t
  *============================================================================*/
 void enesim_converter_argb8888_init(void)
 {
+	uint32_t a;
+
+	_unpremul[0] = 0;
+	for (a = 1; a < 256; a++)
+		_unpremul[a] = ((255 << 16) + a - 1) / a;
 	enesim_converter_surface_register(
 			ENESIM_CONVERTER_2D(_2d_argb8888_none_argb8888_pre),
 			ENESIM_BUFFER_FORMAT_ARGB8888,
@@ -32,19 +32,29 @@ static void _2d_bgr888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t d
 	uint8_t *dst = data->bgr888.plane0;
 	uint8_t *src = (uint8_t *)sdata->argb8888_pre.plane0;
 	size_t dstride = data->bgr888.plane0_stride;
-	size_t sstride = data->argb8888_pre.plane0_stride;
+	size_t sstride = sdata->argb8888_pre.plane0_stride;
 
 	while (dh--)
 	{
 		uint8_t *ddst = dst;
 		uint32_t *ssrc = (uint32_t *)src;
 		uint32_t ddw = dw;
+
+		/* the blue goes first, same order as the source */
+		while (ddw >= 4)
+		{
+			enesim_converter_store_24bpp(ddst,
+					ssrc[0] & 0xffffff, ssrc[1] & 0xffffff,
+					ssrc[2] & 0xffffff, ssrc[3] & 0xffffff);
+			ddst += 12;
+			ssrc += 4;
+			ddw -= 4;
+		}
 		while (ddw--)
 		{
 			*ddst++ = *ssrc & 0xff;
 			*ddst++ = (*ssrc >> 8) & 0xff;
 			*ddst++ = (*ssrc >> 16) & 0xff;
-			//printf("%02x%02x%02x\n", *(ddst - 3), *(ddst - 2), *(ddst - 1));
 			ssrc++;
 		}
 		dst += dstride;
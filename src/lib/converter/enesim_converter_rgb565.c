@@ -23,30 +23,67 @@
 #include "enesim_buffer.h"
 
 #include "enesim_converter_private.h"
+
+#ifdef ENS_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 /*============================================================================*
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
+static inline uint16_t _argb8888_pre_to_rgb565(uint32_t p)
+{
+	return ((p & 0xf80000) >> 8) | ((p & 0xfc00) >> 5) | ((p & 0xf8) >> 3);
+}
+
+static void _1d_rgb565_none_argb8888_pre(uint16_t *dst, uint32_t *src,
+		uint32_t len)
+{
+#ifdef ENS_HAVE_SSE2
+	const __m128i rmask = _mm_set1_epi32(0xf800);
+	const __m128i gmask = _mm_set1_epi32(0x07e0);
+	const __m128i bmask = _mm_set1_epi32(0x001f);
+
+	while (len >= 8)
+	{
+		__m128i p0, p1;
+		__m128i c0, c1;
+
+		p0 = _mm_loadu_si128((__m128i *)src);
+		p1 = _mm_loadu_si128((__m128i *)(src + 4));
+		c0 = _mm_or_si128(_mm_or_si128(
+				_mm_and_si128(_mm_srli_epi32(p0, 8), rmask),
+				_mm_and_si128(_mm_srli_epi32(p0, 5), gmask)),
+				_mm_and_si128(_mm_srli_epi32(p0, 3), bmask));
+		c1 = _mm_or_si128(_mm_or_si128(
+				_mm_and_si128(_mm_srli_epi32(p1, 8), rmask),
+				_mm_and_si128(_mm_srli_epi32(p1, 5), gmask)),
+				_mm_and_si128(_mm_srli_epi32(p1, 3), bmask));
+		/* sign extend so the signed saturation keeps the 16 bits */
+		c0 = _mm_srai_epi32(_mm_slli_epi32(c0, 16), 16);
+		c1 = _mm_srai_epi32(_mm_slli_epi32(c1, 16), 16);
+		_mm_storeu_si128((__m128i *)dst, _mm_packs_epi32(c0, c1));
+
+		src += 8;
+		dst += 8;
+		len -= 8;
+	}
+#endif
+	while (len--)
+		*dst++ = _argb8888_pre_to_rgb565(*src++);
+}
+
 static void _2d_rgb565_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t dw, uint32_t dh,
 		Enesim_Buffer_Sw_Data *sdata, uint32_t sw EINA_UNUSED, uint32_t sh EINA_UNUSED)
 {
-	uint16_t *dst = data->rgb565.plane0;
-	uint32_t *src = sdata->argb8888_pre.plane0;
+	uint8_t *dst = (uint8_t *)data->rgb565.plane0;
+	uint8_t *src = (uint8_t *)sdata->argb8888_pre.plane0;
 	size_t dstride = data->rgb565.plane0_stride;
-	size_t sstride = data->argb8888_pre.plane0_stride / 4;
+	size_t sstride = sdata->argb8888_pre.plane0_stride;
 
 	while (dh--)
 	{
-		uint16_t *ddst = dst;
-		uint32_t *ssrc = src;
-		uint32_t ddw = dw;
-		while (ddw--)
-		{
-			*dst = ((*src & 0xf80000) >> 8) | ((*src & 0xfc00) >> 5)
-					| ((*src & 0xf8) >> 3);
-			ssrc++;
-			ddst++;
-		}
+		_1d_rgb565_none_argb8888_pre((uint16_t *)dst, (uint32_t *)src, dw);
 		dst += dstride;
 		src += sstride;
 	}
@@ -39,6 +39,19 @@ static void _2d_rgb888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t d
 		uint8_t *ddst = dst;
 		uint32_t *ssrc = (uint32_t *)src;
 		uint32_t ddw = dw;
+
+		/* the red goes first, swap the red and the blue */
+		while (ddw >= 4)
+		{
+			enesim_converter_store_24bpp(ddst,
+					((ssrc[0] >> 16) & 0xff) | (ssrc[0] & 0xff00) | ((ssrc[0] & 0xff) << 16),
+					((ssrc[1] >> 16) & 0xff) | (ssrc[1] & 0xff00) | ((ssrc[1] & 0xff) << 16),
+					((ssrc[2] >> 16) & 0xff) | (ssrc[2] & 0xff00) | ((ssrc[2] & 0xff) << 16),
+					((ssrc[3] >> 16) & 0xff) | (ssrc[3] & 0xff00) | ((ssrc[3] & 0xff) << 16));
+			ddst += 12;
+			ssrc += 4;
+			ddw -= 4;
+		}
 		while (ddw--)
 		{
 			*ddst++ = (*ssrc >> 16) & 0xff;
@@ -31,7 +31,7 @@ static void _2d_rgb888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t d
 {
 	uint8_t *dst = (uint8_t *)data->xrgb8888.plane0;
 	uint8_t *src = (uint8_t *)sdata->argb8888_pre.plane0;
-	size_t dstride = data->rgb888.plane0_stride;
+	size_t dstride = data->xrgb8888.plane0_stride;
 	size_t sstride = sdata->argb8888_pre.plane0_stride;
 
 	while (dh--)
@@ -26,6 +26,8 @@
 #include "enesim_buffer_private.h"
 #include "enesim_converter_private.h"
 
+#include <sys/mman.h>
+
 #if BUILD_OPENCL
 #include "Enesim_OpenCL.h"
 #endif
@@ -46,6 +48,22 @@
 /** @cond internal */
 #define ENESIM_LOG_DEFAULT enesim_log_buffer
 
+/* the alignment the vectorized code paths need to use aligned accesses */
+#ifdef ENS_HAVE_SSE2
+#define ENESIM_BUFFER_ALIGNMENT 16
+#else
+#define ENESIM_BUFFER_ALIGNMENT sizeof(uint32_t)
+#endif
+
+typedef struct _Enesim_Buffer_Fd_Mapping
+{
+	void *map;
+	size_t len;
+	void *pixels;
+	Enesim_Buffer_Free free_func;
+	void *free_func_data;
+} Enesim_Buffer_Fd_Mapping;
+
 #if BUILD_OPENGL
 static void _buffer_opengl_backend_free(void *data, void *user_data EINA_UNUSED)
 {
@@ -59,6 +77,16 @@ static void _buffer_data_free(void *data, void *user_data EINA_UNUSED)
 	free(data);
 }
 
+static void _buffer_fd_free(void *data EINA_UNUSED, void *user_data)
+{
+	Enesim_Buffer_Fd_Mapping *m = user_data;
+
+	munmap(m->map, m->len);
+	if (m->free_func)
+		m->free_func(m->pixels, m->free_func_data);
+	free(m);
+}
+
 static Eina_Bool _buffer_format_has_alpha(Enesim_Buffer_Format fmt)
 {
 	switch (fmt)
@@ -148,6 +176,7 @@ Eina_Bool enesim_buffer_sw_data_alloc(Enesim_Buffer_Sw_Data *data,
 		/* packed case */
 		case ENESIM_BUFFER_FORMAT_ARGB8888:
 		case ENESIM_BUFFER_FORMAT_ARGB8888_PRE:
+		case ENESIM_BUFFER_FORMAT_XRGB8888:
 		case ENESIM_BUFFER_FORMAT_CMYK:
 		case ENESIM_BUFFER_FORMAT_CMYK_ADOBE:
 		case ENESIM_BUFFER_FORMAT_BGR888:
@@ -200,6 +229,11 @@ Eina_Bool enesim_buffer_sw_data_set(Enesim_Buffer_Sw_Data *data,
 		data->argb8888_pre.plane0_stride = stride0;
 		break;
 
+		case ENESIM_BUFFER_FORMAT_XRGB8888:
+		data->xrgb8888.plane0 = content0;
+		data->xrgb8888.plane0_stride = stride0;
+		break;
+
 		case ENESIM_BUFFER_FORMAT_CMYK:
 		case ENESIM_BUFFER_FORMAT_CMYK_ADOBE:
 		data->cmyk.plane0 = content0;
@@ -255,6 +289,10 @@ Eina_Bool enesim_buffer_sw_data_free(Enesim_Buffer_Sw_Data *data,
 		free_func(data->argb8888_pre.plane0, free_func_data);
 		break;
 
+		case ENESIM_BUFFER_FORMAT_XRGB8888:
+		free_func(data->xrgb8888.plane0, free_func_data);
+		break;
+
 		case ENESIM_BUFFER_FORMAT_CMYK:
 		case ENESIM_BUFFER_FORMAT_CMYK_ADOBE:
 		free_func(data->cmyk.plane0, free_func_data);
@@ -298,40 +336,46 @@ Eina_Bool enesim_buffer_sw_data_at(Enesim_Buffer_Sw_Data *data,
 		/* 32 bpp */
 		case ENESIM_BUFFER_FORMAT_ARGB8888:
 		at->argb8888.plane0 = (uint32_t *)((uint8_t *)data->argb8888.plane0 +
-				(y * data->argb8888.plane0_stride) + x);
+				(y * data->argb8888.plane0_stride) + (x * 4));
 		at->argb8888.plane0_stride = data->argb8888.plane0_stride;
 		break;
 
+		case ENESIM_BUFFER_FORMAT_XRGB8888:
+		at->xrgb8888.plane0 = (uint32_t *)((uint8_t *)data->xrgb8888.plane0 +
+				(y * data->xrgb8888.plane0_stride) + (x * 4));
+		at->xrgb8888.plane0_stride = data->xrgb8888.plane0_stride;
+		break;
+
 		case ENESIM_BUFFER_FORMAT_ARGB8888_PRE:
 		at->argb8888_pre.plane0 = (uint32_t *)((uint8_t *)data->argb8888_pre.plane0 +
-				(y * data->argb8888_pre.plane0_stride) + x);
+				(y * data->argb8888_pre.plane0_stride) + (x * 4));
 		at->argb8888_pre.plane0_stride = data->argb8888_pre.plane0_stride;
 		break;
 
 		/* 24 bpp */
 		case ENESIM_BUFFER_FORMAT_BGR888:
 		at->bgr888.plane0 = data->bgr888.plane0 +
-				(y * data->bgr888.plane0_stride) + x;
+				(y * data->bgr888.plane0_stride) + (x * 3);
 		at->bgr888.plane0_stride = data->bgr888.plane0_stride;
 		break;
 
 		case ENESIM_BUFFER_FORMAT_RGB888:
 		at->rgb888.plane0 = data->rgb888.plane0 +
-				(y * data->rgb888.plane0_stride) + x;
+				(y * data->rgb888.plane0_stride) + (x * 3);
 		at->rgb888.plane0_stride = data->rgb888.plane0_stride;
 		break;
 
 		case ENESIM_BUFFER_FORMAT_CMYK:
 		case ENESIM_BUFFER_FORMAT_CMYK_ADOBE:
 		at->cmyk.plane0 = data->cmyk.plane0 +
-				(y * data->cmyk.plane0_stride) + x;
+				(y * data->cmyk.plane0_stride) + (x * 4);
 		at->cmyk.plane0_stride = data->cmyk.plane0_stride;
 		break;
 
 		/* 16 bpp */
 		case ENESIM_BUFFER_FORMAT_RGB565:
 		at->rgb565.plane0 = (uint16_t *)((uint8_t *)data->rgb565.plane0 +
-				(y * data->rgb565.plane0_stride) + x);
+				(y * data->rgb565.plane0_stride) + (x * 2));
 		at->rgb565.plane0_stride = data->rgb565.plane0_stride;
 		break;
 
@@ -355,6 +399,76 @@ Eina_Bool enesim_buffer_sw_data_at(Enesim_Buffer_Sw_Data *data,
 	return ret;
 }
 
+Eina_Bool enesim_buffer_sw_data_plane_get(const Enesim_Buffer_Sw_Data *data,
+		Enesim_Buffer_Format fmt, uint8_t **plane, int *stride)
+{
+	switch (fmt)
+	{
+		case ENESIM_BUFFER_FORMAT_ARGB8888:
+		case ENESIM_BUFFER_FORMAT_ARGB8888_PRE:
+		case ENESIM_BUFFER_FORMAT_XRGB8888:
+		*plane = (uint8_t *)data->argb8888.plane0;
+		*stride = data->argb8888.plane0_stride;
+		break;
+
+		case ENESIM_BUFFER_FORMAT_BGR888:
+		case ENESIM_BUFFER_FORMAT_RGB888:
+		*plane = data->rgb888.plane0;
+		*stride = data->rgb888.plane0_stride;
+		break;
+
+		case ENESIM_BUFFER_FORMAT_CMYK:
+		case ENESIM_BUFFER_FORMAT_CMYK_ADOBE:
+		*plane = data->cmyk.plane0;
+		*stride = data->cmyk.plane0_stride;
+		break;
+
+		case ENESIM_BUFFER_FORMAT_RGB565:
+		*plane = (uint8_t *)data->rgb565.plane0;
+		*stride = data->rgb565.plane0_stride;
+		break;
+
+		case ENESIM_BUFFER_FORMAT_A8:
+		case ENESIM_BUFFER_FORMAT_GRAY:
+		*plane = data->a8.plane0;
+		*stride = data->a8.plane0_stride;
+		break;
+
+		default:
+		ERR("Unsupported format %d", fmt);
+		return EINA_FALSE;
+	}
+	return EINA_TRUE;
+}
+
+Eina_Bool enesim_buffer_sw_data_copy(Enesim_Buffer_Sw_Data *dst,
+		const Enesim_Buffer_Sw_Data *src, Enesim_Buffer_Format fmt,
+		uint32_t w, uint32_t h)
+{
+	uint8_t *dplane, *splane;
+	int dstride, sstride;
+	size_t len;
+
+	if (!enesim_buffer_sw_data_plane_get(dst, fmt, &dplane, &dstride))
+		return EINA_FALSE;
+	if (!enesim_buffer_sw_data_plane_get(src, fmt, &splane, &sstride))
+		return EINA_FALSE;
+
+	len = enesim_buffer_format_size_get(fmt, w, 1);
+	if (dstride == sstride && (size_t)dstride == len)
+	{
+		memcpy(dplane, splane, len * h);
+		return EINA_TRUE;
+	}
+	while (h--)
+	{
+		memcpy(dplane, splane, len);
+		dplane += dstride;
+		splane += sstride;
+	}
+	return EINA_TRUE;
+}
+
 /** @endcond */
 /*============================================================================*
  *                                   API                                      *
@@ -427,6 +541,82 @@ EAPI Enesim_Buffer * enesim_buffer_new_data_from(Enesim_Buffer_Format f,
 	return buf;
 }
 
+/**
+ * @brief Create a new buffer that maps the pixels of a file descriptor
+ * @param[in] f The format of the buffer
+ * @param[in] w The width of the buffer
+ * @param[in] h The height of the buffer
+ * @param[in] fd The file descriptor to map, like a shared memory or a
+ * memory file of another process
+ * @param[in] offset The offset of the first pixel on the file
+ * @param[in] stride The stride of the pixels. 0 for the width of the
+ * buffer
+ * @param[in] free_func The function to be called with the pixels once the
+ * buffer is destroyed and the file unmapped. @ender_nullable
+ * @param[in] free_func_data The private data for the @a free_func callback
+ * @return The newly created buffer
+ *
+ * The pixels are not copied, every change on the buffer is visible to
+ * every other user of the file. The descriptor can be closed once the
+ * buffer is created. File descriptors that can only be read are mapped
+ * read only, so the buffer must not be written then.
+ * Use enesim_buffer_is_aligned() to know if the mapped pixels allow the
+ * fast code paths to be used.
+ */
+EAPI Enesim_Buffer * enesim_buffer_new_fd_from(Enesim_Buffer_Format f,
+		uint32_t w, uint32_t h, int fd, size_t offset, size_t stride,
+		Enesim_Buffer_Free free_func, void *free_func_data)
+{
+	Enesim_Buffer_Fd_Mapping *m;
+	Enesim_Buffer_Sw_Data sw_data;
+	Enesim_Buffer *buf;
+	size_t map_offset;
+	size_t page_size;
+
+	if (!w || !h || fd < 0) return NULL;
+	if (!stride)
+		stride = enesim_buffer_format_size_get(f, w, 1);
+
+	/* mmap needs the offset to be aligned to the page size */
+	page_size = sysconf(_SC_PAGESIZE);
+	map_offset = offset - (offset % page_size);
+
+	m = calloc(1, sizeof(Enesim_Buffer_Fd_Mapping));
+	m->len = (offset - map_offset) + (stride * (h - 1)) +
+			enesim_buffer_format_size_get(f, w, 1);
+	m->map = mmap(NULL, m->len, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+			map_offset);
+	if (m->map == MAP_FAILED)
+	{
+		m->map = mmap(NULL, m->len, PROT_READ, MAP_SHARED, fd,
+				map_offset);
+		if (m->map == MAP_FAILED)
+		{
+			WRN("Impossible to map the file descriptor %d", fd);
+			free(m);
+			return NULL;
+		}
+	}
+	m->pixels = (uint8_t *)m->map + (offset - map_offset);
+	m->free_func = free_func;
+	m->free_func_data = free_func_data;
+
+	if (!enesim_buffer_sw_data_set(&sw_data, f, m->pixels, stride))
+	{
+		munmap(m->map, m->len);
+		free(m);
+		return NULL;
+	}
+	buf = enesim_buffer_new_data_from(f, w, h, EINA_FALSE, &sw_data,
+			_buffer_fd_free, m);
+	if (!buf)
+	{
+		munmap(m->map, m->len);
+		free(m);
+	}
+	return buf;
+}
+
 /**
  * @brief Create a new buffer using a pool
  * @param[in] f The format of the buffer
@@ -565,6 +755,77 @@ EAPI Enesim_Pool * enesim_buffer_pool_get(Enesim_Buffer *b)
 	return enesim_pool_ref(b->pool);
 }
 
+/**
+ * @brief Gets the alignment the pixels need to use the fast code paths
+ * @return The alignment in bytes of the pixels and the stride
+ *
+ * Buffers of external memory should use this alignment for the pixels and
+ * the stride so the vectorized code paths can use aligned accesses.
+ * @see enesim_buffer_format_stride_get()
+ */
+EAPI size_t enesim_buffer_alignment_get(void)
+{
+	return ENESIM_BUFFER_ALIGNMENT;
+}
+
+/**
+ * @brief Gets the best stride for a buffer
+ * @param[in] fmt The format of the buffer
+ * @param[in] w The width of the buffer
+ * @return The size of a row rounded up to the alignment
+ * @see enesim_buffer_alignment_get()
+ */
+EAPI size_t enesim_buffer_format_stride_get(Enesim_Buffer_Format fmt,
+		uint32_t w)
+{
+	size_t stride;
+
+	stride = enesim_buffer_format_size_get(fmt, w, 1);
+	return (stride + ENESIM_BUFFER_ALIGNMENT - 1) &
+			~((size_t)ENESIM_BUFFER_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Check if the pixels of a buffer are aligned
+ * @param[in] b The buffer to check
+ * @return EINA_TRUE if both the pixels and the stride are aligned to
+ * enesim_buffer_alignment_get(), EINA_FALSE otherwise
+ */
+EAPI Eina_Bool enesim_buffer_is_aligned(const Enesim_Buffer *b)
+{
+	Enesim_Buffer_Sw_Data data;
+	uint8_t *plane;
+	int stride;
+
+	ENESIM_MAGIC_CHECK_BUFFER(b);
+	if (b->backend != ENESIM_BACKEND_SOFTWARE)
+		return EINA_FALSE;
+	if (!enesim_buffer_sw_data_get(b, &data))
+		return EINA_FALSE;
+	if (!enesim_buffer_sw_data_plane_get(&data, b->format, &plane, &stride))
+		return EINA_FALSE;
+	return !((uintptr_t)plane % ENESIM_BUFFER_ALIGNMENT) &&
+			!(stride % ENESIM_BUFFER_ALIGNMENT);
+}
+
+/**
+ * @brief Gets the file descriptor that backs the pixels of a buffer
+ * @param[in] b The buffer to get the file descriptor from
+ * @param[out] fd The file descriptor, owned by the buffer
+ * @param[out] size The size of the file
+ * @return EINA_TRUE if the pixels have been allocated by a file pool,
+ * EINA_FALSE otherwise, including the buffers that wrap external pixels
+ *
+ * The pixels start at the beginning of the file, with the stride of the
+ * buffer sw data.
+ * @see enesim_pool_file_new()
+ */
+EAPI Eina_Bool enesim_buffer_fd_get(Enesim_Buffer *b, int *fd, size_t *size)
+{
+	ENESIM_MAGIC_CHECK_BUFFER(b);
+	return enesim_pool_file_data_fd_get(b->pool, b->backend_data, fd, size);
+}
+
 /**
  * @brief Increase the reference counter of a buffer
  * @param[in] b The buffer
@@ -748,6 +1009,7 @@ EAPI size_t enesim_buffer_format_size_get(Enesim_Buffer_Format fmt, uint32_t w,
 	{
 		case ENESIM_BUFFER_FORMAT_ARGB8888:
 		case ENESIM_BUFFER_FORMAT_ARGB8888_PRE:
+		case ENESIM_BUFFER_FORMAT_XRGB8888:
 		case ENESIM_BUFFER_FORMAT_CMYK:
 		case ENESIM_BUFFER_FORMAT_CMYK_ADOBE:
 		return w * h * 4;
@@ -1044,7 +1306,7 @@ EAPI Eina_Bool enesim_buffer_convert(Enesim_Buffer *thiz, Enesim_Buffer *dst)
 
 	/* FIXME check the stride too */
 	/* TODO check the clip and x, y */
-	converter(&ddata, w, h, &sdata, w, h);
+	enesim_converter_convert(converter, &ddata, dfmt, &sdata, sfmt, w, h);
 	enesim_buffer_unmap(thiz, &sdata, EINA_FALSE);
 	enesim_buffer_unmap(dst, &ddata, EINA_TRUE);
 
@@ -1097,7 +1359,8 @@ EAPI Eina_Bool enesim_buffer_convert_list(Enesim_Buffer *thiz, Enesim_Buffer *ds
 
 		enesim_buffer_sw_data_at(&ddata, dfmt, area->x, area->y, &dat);
 		enesim_buffer_sw_data_at(&sdata, sfmt, area->x, area->y, &sat);
-		converter(&dat, area->w, area->h, &sat, area->w, area->h);
+		enesim_converter_convert(converter, &dat, dfmt, &sat, sfmt,
+				area->w, area->h);
 	}
 
 	return EINA_TRUE;
@@ -207,6 +207,9 @@ EAPI Enesim_Buffer * enesim_buffer_new_pool_and_data_from(Enesim_Buffer_Format f
 		uint32_t w, uint32_t h, Enesim_Pool *p, Eina_Bool copy,
 		Enesim_Buffer_Sw_Data *sw_data, Enesim_Buffer_Free free_func,
 		void *free_func_data);
+EAPI Enesim_Buffer * enesim_buffer_new_fd_from(Enesim_Buffer_Format f,
+		uint32_t w, uint32_t h, int fd, size_t offset, size_t stride,
+		Enesim_Buffer_Free free_func, void *free_func_data);
 EAPI Enesim_Buffer * enesim_buffer_ref(Enesim_Buffer *b);
 EAPI void enesim_buffer_unref(Enesim_Buffer *b);
 
@@ -214,6 +217,12 @@ EAPI void enesim_buffer_size_get(const Enesim_Buffer *b, int *w, int *h);
 EAPI Enesim_Buffer_Format enesim_buffer_format_get(const Enesim_Buffer *b);
 EAPI Enesim_Backend enesim_buffer_backend_get(const Enesim_Buffer *b);
 EAPI Enesim_Pool * enesim_buffer_pool_get(Enesim_Buffer *b);
+EAPI Eina_Bool enesim_buffer_fd_get(Enesim_Buffer *b, int *fd, size_t *size);
+
+EAPI size_t enesim_buffer_alignment_get(void);
+EAPI size_t enesim_buffer_format_stride_get(Enesim_Buffer_Format fmt,
+		uint32_t w);
+EAPI Eina_Bool enesim_buffer_is_aligned(const Enesim_Buffer *b);
 
 EAPI void enesim_buffer_private_set(Enesim_Buffer *b, void *data);
 EAPI void * enesim_buffer_private_get(Enesim_Buffer *b);
@@ -65,5 +65,10 @@ Eina_Bool enesim_buffer_sw_data_free(Enesim_Buffer_Sw_Data *data,
 Eina_Bool enesim_buffer_sw_data_at(Enesim_Buffer_Sw_Data *data,
 		Enesim_Buffer_Format fmt, int x, int y,
 		Enesim_Buffer_Sw_Data *at);
+Eina_Bool enesim_buffer_sw_data_plane_get(const Enesim_Buffer_Sw_Data *data,
+		Enesim_Buffer_Format fmt, uint8_t **plane, int *stride);
+Eina_Bool enesim_buffer_sw_data_copy(Enesim_Buffer_Sw_Data *dst,
+		const Enesim_Buffer_Sw_Data *src, Enesim_Buffer_Format fmt,
+		uint32_t w, uint32_t h);
 
 #endif
@@ -25,6 +25,8 @@
 
 #include "enesim_buffer_private.h"
 #include "enesim_converter_private.h"
+#include "enesim_thread_private.h"
+#include "enesim_barrier_private.h"
 
 /*
  * TODO
@@ -38,14 +40,149 @@
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
+/* conversions smaller than this are done on the calling thread */
+#define ENESIM_CONVERTER_THREADED_MIN (256 * 256)
+
 typedef Enesim_Converter_2D Enesim_Converter_2D_Lut[ENESIM_BUFFER_FORMAT_LAST][ENESIM_ANGLE_LAST][ENESIM_BUFFER_FORMAT_LAST];
 
 Enesim_Converter_2D_Lut _converters_2d;
+
+#ifdef BUILD_MULTI_CORE
+typedef struct _Enesim_Converter_Thread
+{
+	Enesim_Thread tid;
+	unsigned int band;
+} Enesim_Converter_Thread;
+
+typedef struct _Enesim_Converter_Operation
+{
+	Enesim_Converter_2D cnv;
+	Enesim_Buffer_Sw_Data ddata;
+	Enesim_Buffer_Format dfmt;
+	Enesim_Buffer_Sw_Data sdata;
+	Enesim_Buffer_Format sfmt;
+	uint32_t w;
+	uint32_t h;
+} Enesim_Converter_Operation;
+
+/* the calling thread converts the first band */
+static Enesim_Converter_Thread *_threads = NULL;
+static unsigned int _num_bands;
+static Enesim_Barrier _start;
+static Enesim_Barrier _end;
+static Eina_Bool _done;
+static Eina_Lock _lock;
+static Enesim_Converter_Operation _op;
+
+static void _converter_band(unsigned int band)
+{
+	Enesim_Buffer_Sw_Data dat;
+	Enesim_Buffer_Sw_Data sat;
+	uint32_t y0, y1;
+
+	y0 = (_op.h * band) / _num_bands;
+	y1 = (_op.h * (band + 1)) / _num_bands;
+	if (y0 == y1)
+		return;
+	enesim_buffer_sw_data_at(&_op.ddata, _op.dfmt, 0, y0, &dat);
+	enesim_buffer_sw_data_at(&_op.sdata, _op.sfmt, 0, y0, &sat);
+	_op.cnv(&dat, _op.w, y1 - y0, &sat, _op.w, y1 - y0);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI _converter_run(void *data)
+#else
+static void * _converter_run(void *data)
+#endif
+{
+	Enesim_Converter_Thread *thiz = data;
+
+	do
+	{
+		enesim_barrier_wait(&_start);
+		if (_done) break;
+		_converter_band(thiz->band);
+		enesim_barrier_wait(&_end);
+	} while (1);
+
+#ifdef _WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+static void _converter_threads_new(void)
+{
+	unsigned int i;
+
+	_threads = malloc(sizeof(Enesim_Converter_Thread) * (_num_bands - 1));
+	enesim_barrier_new(&_start, _num_bands);
+	enesim_barrier_new(&_end, _num_bands);
+	for (i = 0; i < _num_bands - 1; i++)
+	{
+		_threads[i].band = i + 1;
+		enesim_thread_new(&_threads[i].tid, _converter_run, &_threads[i]);
+	}
+}
+
+static void _converter_threads_free(void)
+{
+	unsigned int i;
+
+	if (!_threads) return;
+
+	_done = EINA_TRUE;
+	enesim_barrier_wait(&_start);
+	for (i = 0; i < _num_bands - 1; i++)
+		enesim_thread_free(_threads[i].tid);
+	free(_threads);
+	_threads = NULL;
+	enesim_barrier_free(&_start);
+	enesim_barrier_free(&_end);
+}
+
+static Eina_Bool _converter_convert_threaded(Enesim_Converter_2D cnv,
+		Enesim_Buffer_Sw_Data *ddata, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *sdata, Enesim_Buffer_Format sfmt,
+		uint32_t w, uint32_t h)
+{
+	if (_num_bands < 2)
+		return EINA_FALSE;
+	if (w * h < ENESIM_CONVERTER_THREADED_MIN || h < _num_bands)
+		return EINA_FALSE;
+	/* another conversion is already using the threads */
+	if (eina_lock_take_try(&_lock) != EINA_LOCK_SUCCEED)
+		return EINA_FALSE;
+
+	if (!_threads)
+		_converter_threads_new();
+	_op.cnv = cnv;
+	_op.ddata = *ddata;
+	_op.dfmt = dfmt;
+	_op.sdata = *sdata;
+	_op.sfmt = sfmt;
+	_op.w = w;
+	_op.h = h;
+
+	enesim_barrier_wait(&_start);
+	_converter_band(0);
+	enesim_barrier_wait(&_end);
+	eina_lock_release(&_lock);
+
+	return EINA_TRUE;
+}
+#endif
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
 void enesim_converter_init(void)
 {
+#ifdef BUILD_MULTI_CORE
+	_num_bands = eina_cpu_count();
+	_done = EINA_FALSE;
+	eina_lock_new(&_lock);
+#endif
 	enesim_converter_argb8888_init();
 	enesim_converter_xrgb8888_init();
 	enesim_converter_rgb888_init();
@@ -54,6 +191,23 @@ void enesim_converter_init(void)
 }
 void enesim_converter_shutdown(void)
 {
+#ifdef BUILD_MULTI_CORE
+	_converter_threads_free();
+	eina_lock_free(&_lock);
+#endif
+}
+
+/* Large conversions are split in bands of rows, one for every cpu */
+void enesim_converter_convert(Enesim_Converter_2D cnv,
+		Enesim_Buffer_Sw_Data *ddata, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *sdata, Enesim_Buffer_Format sfmt,
+		uint32_t w, uint32_t h)
+{
+#ifdef BUILD_MULTI_CORE
+	if (_converter_convert_threaded(cnv, ddata, dfmt, sdata, sfmt, w, h))
+		return;
+#endif
+	cnv(ddata, w, h, sdata, w, h);
 }
 
 void enesim_converter_surface_register(Enesim_Converter_2D cnv,
@@ -23,6 +23,27 @@ typedef void (*Enesim_Converter_2D)(Enesim_Buffer_Sw_Data *ddata, uint32_t dw, u
 
 #define ENESIM_CONVERTER_2D(f) ((Enesim_Converter_2D)(f))
 
+/* Store four 24 bits pixels, each one on the lower bytes of a word and
+ * with the first byte to store on the lowest one, as three words
+ */
+static inline void enesim_converter_store_24bpp(uint8_t *dst, uint32_t q0,
+		uint32_t q1, uint32_t q2, uint32_t q3)
+{
+#ifndef WORDS_BIGENDIAN
+	uint32_t w[3];
+
+	w[0] = q0 | (q1 << 24);
+	w[1] = (q1 >> 8) | (q2 << 16);
+	w[2] = (q2 >> 16) | (q3 << 8);
+	memcpy(dst, w, sizeof(w));
+#else
+	dst[0] = q0; dst[1] = q0 >> 8; dst[2] = q0 >> 16;
+	dst[3] = q1; dst[4] = q1 >> 8; dst[5] = q1 >> 16;
+	dst[6] = q2; dst[7] = q2 >> 8; dst[8] = q2 >> 16;
+	dst[9] = q3; dst[10] = q3 >> 8; dst[11] = q3 >> 16;
+#endif
+}
+
 void enesim_converter_init(void);
 void enesim_converter_shutdown(void);
 
@@ -33,6 +54,11 @@ void enesim_converter_bgr888_init(void);
 void enesim_converter_rgb565_init(void);
 void enesim_converter_a8_init(void);
 
+void enesim_converter_convert(Enesim_Converter_2D cnv,
+		Enesim_Buffer_Sw_Data *ddata, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *sdata, Enesim_Buffer_Format sfmt,
+		uint32_t w, uint32_t h);
+
 void enesim_converter_surface_register(Enesim_Converter_2D cnv,
 		Enesim_Buffer_Format dfmt, Enesim_Angle angle, Enesim_Buffer_Format sfmt);
 
@@ -57,6 +57,11 @@ struct _Enesim_Draw_Cache
 	/* given that the tiler is not lock free we need to lock it */
 	Eina_Lock tlock;
 	int tw, th;
+	/* nothing to redraw since the last refresh, the maps can return the
+	 * pixels without locking
+	 */
+	volatile Eina_Bool clean;
+	Enesim_Buffer_Sw_Data clean_data;
 };
 
 static Eina_Bool _damage_cb(Enesim_Renderer *r EINA_UNUSED,
@@ -129,6 +134,8 @@ void enesim_draw_cache_renderer_set(Enesim_Draw_Cache *thiz,
 	}
 	thiz->r = r;
 	thiz->changed = EINA_TRUE;
+	/* nothing of the new renderer is drawn yet */
+	thiz->clean = EINA_FALSE;
 }
 
 void enesim_draw_cache_renderer_get(Enesim_Draw_Cache *thiz,
@@ -166,6 +173,8 @@ Eina_Bool enesim_draw_cache_setup_sw(Enesim_Draw_Cache *thiz,
 	{
 		Eina_Bool full = EINA_FALSE;
 
+		thiz->clean = EINA_FALSE;
+
 		if (thiz->changed)
 		{
 			thiz->changed = EINA_FALSE;
@@ -236,6 +245,77 @@ Eina_Bool enesim_draw_cache_setup_sw(Enesim_Draw_Cache *thiz,
 	return EINA_TRUE;
 }
 
+/* Check if some area needs to be redrawn on the next map */
+Eina_Bool enesim_draw_cache_is_damaged(Enesim_Draw_Cache *thiz)
+{
+	Eina_Iterator *it;
+	Eina_Rectangle *rect;
+	Eina_Bool ret;
+
+	if (!thiz->tiler) return EINA_TRUE;
+	if (thiz->clean) return EINA_FALSE;
+
+	eina_lock_take(&thiz->tlock);
+	it = eina_tiler_iterator_new(thiz->tiler);
+	ret = eina_iterator_next(it, (void **)&rect);
+	eina_iterator_free(it);
+	eina_lock_release(&thiz->tlock);
+
+	return ret;
+}
+
+/* Draw every damaged area at once from the setup of the renderer using the
+ * cache, with the threads of the cached renderer. The cached renderer must be
+ * already setup
+ */
+Eina_Bool enesim_draw_cache_refresh_sw(Enesim_Draw_Cache *thiz)
+{
+	Enesim_Buffer *buffer;
+	Eina_Iterator *it;
+	Eina_Rectangle *rect;
+	Eina_List *clips = NULL;
+	Eina_Bool ret;
+
+	if (!thiz->r || !thiz->s || !thiz->tiler) return EINA_FALSE;
+
+	eina_lock_take(&thiz->tlock);
+	it = eina_tiler_iterator_new(thiz->tiler);
+	EINA_ITERATOR_FOREACH(it, rect)
+	{
+		Eina_Rectangle *clip;
+
+		clip = malloc(sizeof(Eina_Rectangle));
+		*clip = *rect;
+		clips = eina_list_append(clips, clip);
+	}
+	eina_iterator_free(it);
+
+	if (clips)
+	{
+		Eina_Rectangle *clip;
+
+		enesim_renderer_sw_draw_offscreen(thiz->r, thiz->s, clips,
+				-thiz->bounds.x, -thiz->bounds.y);
+		EINA_LIST_FREE(clips, clip)
+		{
+			eina_tiler_rect_del(thiz->tiler, clip);
+			free(clip);
+		}
+	}
+	else if (enesim_renderer_profile_enabled)
+	{
+		enesim_renderer_profile_hit_add(thiz->r);
+	}
+
+	buffer = enesim_surface_buffer_get(thiz->s);
+	ret = enesim_buffer_sw_data_get(buffer, &thiz->clean_data);
+	enesim_buffer_unref(buffer);
+	thiz->clean = ret;
+	eina_lock_release(&thiz->tlock);
+
+	return ret;
+}
+
 /* The area is in surface coordinates 0,0 -> renderer geometry width x renderer geometry height */
 Eina_Bool enesim_draw_cache_map_sw(Enesim_Draw_Cache *thiz,
 		Eina_Rectangle *area, Enesim_Buffer_Sw_Data *mapped)
@@ -244,9 +324,16 @@ Eina_Bool enesim_draw_cache_map_sw(Enesim_Draw_Cache *thiz,
 	Eina_Iterator *it;
 	Eina_Rectangle *rect;
 	Eina_Rectangle real_area;
+	Eina_Bool redrawn = EINA_FALSE;
 	Eina_Bool ret;
 
 	if (!thiz->r) return EINA_FALSE;
+	/* already refreshed, no need to lock */
+	if (thiz->clean)
+	{
+		*mapped = thiz->clean_data;
+		return EINA_TRUE;
+	}
 
 	/* TODO to minimize the impact of the lock, split this function into a setup/cleanup/map */
 	eina_lock_take(&thiz->tlock);
@@ -282,6 +369,7 @@ Eina_Bool enesim_draw_cache_map_sw(Enesim_Draw_Cache *thiz,
 
 		if (!eina_rectangle_intersection(&redraw, &real_area))
 			continue;
+		redrawn = EINA_TRUE;
 		dst = (uint8_t *)enesim_color_at(mapped->argb8888.plane0,
 				mapped->argb8888.plane0_stride,
 				redraw.x, redraw.y);
@@ -300,6 +388,9 @@ Eina_Bool enesim_draw_cache_map_sw(Enesim_Draw_Cache *thiz,
 	}
 	eina_iterator_free(it);
 	eina_lock_release(&thiz->tlock);
+	/* the whole area is served from the cache */
+	if (!redrawn && enesim_renderer_profile_enabled)
+		enesim_renderer_profile_hit_add(thiz->r);
 
 	return ret;
 }
@@ -32,6 +32,8 @@ Eina_Bool enesim_draw_cache_geometry_get(Enesim_Draw_Cache *thiz,
 		Eina_Rectangle *g);
 Eina_Bool enesim_draw_cache_setup_sw(Enesim_Draw_Cache *thiz,
 		Enesim_Format f, Enesim_Pool *p);
+Eina_Bool enesim_draw_cache_is_damaged(Enesim_Draw_Cache *thiz);
+Eina_Bool enesim_draw_cache_refresh_sw(Enesim_Draw_Cache *thiz);
 Eina_Bool enesim_draw_cache_map_sw(Enesim_Draw_Cache *thiz,
 		Eina_Rectangle *area, Enesim_Buffer_Sw_Data *mapped);
 
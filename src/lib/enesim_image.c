@@ -37,6 +37,35 @@ static Eina_Hash *_providers = NULL;
 static Eina_List *_finders = NULL;
 static Enesim_Image_Context *_main_context = NULL;
 
+static void _scale_options_cb(void *data, const char *key, const char *value)
+{
+	Enesim_Image_Scale_Options *thiz = data;
+
+	if (!strcmp(key, "scale"))
+	{
+		int num = 1, denom = 1;
+
+		/* either 1/N or N */
+		if (sscanf(value, "%d/%d", &num, &denom) < 2)
+		{
+			denom = num;
+			num = 1;
+		}
+		if (num == 1 && denom > 0)
+			thiz->scale = denom;
+		else
+			WRN("Unsupported scale '%s'", value);
+	}
+	else if (!strcmp(key, "max_size"))
+	{
+		if (sscanf(value, "%dx%d", &thiz->max_w, &thiz->max_h) != 2)
+		{
+			WRN("Wrong max size '%s'", value);
+			thiz->max_w = thiz->max_h = 0;
+		}
+	}
+}
+
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
@@ -142,6 +171,7 @@ int enesim_image_init(void)
 	ENESIM_IMAGE_ERROR_ALLOCATOR = eina_error_msg_static_register("Error allocating the surface data");
 	ENESIM_IMAGE_ERROR_LOADING = eina_error_msg_static_register("Error loading the image");
 	ENESIM_IMAGE_ERROR_SAVING = eina_error_msg_static_register("Error saving the image");
+	ENESIM_IMAGE_ERROR_CANCELLED = eina_error_msg_static_register("The job has been cancelled");
 	/* the providers */
 	_providers = eina_hash_string_superfast_new(NULL);
 	/* the modules */
@@ -158,6 +188,8 @@ int enesim_image_init(void)
 #endif
 	/* create our main context */
 	_main_context = enesim_image_context_new();
+	/* the decoded images */
+	enesim_image_cache_init();
 
 	return _enesim_image_init_count;
 }
@@ -173,6 +205,8 @@ int enesim_image_shutdown(void)
 	/* destroy our main context */
 	enesim_image_context_free(_main_context);
 	_main_context = NULL;
+	/* drop the decoded images before the providers go away */
+	enesim_image_cache_shutdown();
 
 #if BUILD_STATIC_MODULE_PNG
 	enesim_image_png_provider_shutdown();
@@ -204,6 +238,7 @@ Eina_Error ENESIM_IMAGE_ERROR_SIZE;
 Eina_Error ENESIM_IMAGE_ERROR_ALLOCATOR;
 Eina_Error ENESIM_IMAGE_ERROR_LOADING;
 Eina_Error ENESIM_IMAGE_ERROR_SAVING;
+Eina_Error ENESIM_IMAGE_ERROR_CANCELLED;
 
 /**
  * Gets information about an image
@@ -237,6 +272,11 @@ EAPI Eina_Bool enesim_image_info_get(Enesim_Stream *data, const char *mime,
  * @param[in] options Any option the provider might require
  * @param[out] err The error in case the info loading fails
  * @return EINA_TRUE in case the image was loaded correctly. EINA_FALSE if not
+ *
+ * A provided buffer must have the size of the image and either its format
+ * or one of the formats the provider can convert to while decoding. The
+ * png and jpg providers can write into an ENESIM_BUFFER_FORMAT_ARGB8888_PRE
+ * buffer, which can be used as a surface without any further conversion.
  */
 EAPI Eina_Bool enesim_image_load(Enesim_Stream *data, const char *mime,
 		Enesim_Buffer **b, Enesim_Pool *mpool, const char *options, Eina_Error *err)
@@ -246,6 +286,39 @@ EAPI Eina_Bool enesim_image_load(Enesim_Stream *data, const char *mime,
 	prov = enesim_image_load_provider_get(data, mime);
 	return enesim_image_provider_load(prov, data, b, mpool, options, err);
 }
+/**
+ * Load an image synchronously, notifying every band of rows decoded
+ *
+ * @param[in] s The image data to load from
+ * @param[in] mime The image mime. It can be NULL, if so, it will be autodetected
+ * from the data itself.
+ * @param[out] b The buffer to write the image pixels to
+ * @param[in] mpool The mempool that will create the buffer in case the buffer
+ * reference is NULL
+ * @param[in] area The area of the image to load. NULL for the whole image
+ * @param[in] cb The function called with every band of rows decoded
+ * @param[in] data User provided data
+ * @param[in] options Any option the provider might require
+ * @param[out] err The error in case the load fails
+ * @return EINA_TRUE in case the image was loaded correctly. EINA_FALSE if not
+ *
+ * The buffer has the size of @p area and is passed to @p cb before the load
+ * finishes, so the content can be shown while it arrives. The rows outside
+ * the area are not kept. Interlaced or progressive images notify the whole
+ * buffer once per pass, the last one being final.
+ * @p cb is called from the thread doing the load.
+ */
+EAPI Eina_Bool enesim_image_load_progressive(Enesim_Stream *s,
+		const char *mime, Enesim_Buffer **b, Enesim_Pool *mpool,
+		const Eina_Rectangle *area, Enesim_Image_Progress cb,
+		void *data, const char *options, Eina_Error *err)
+{
+	Enesim_Image_Provider *prov;
+
+	prov = enesim_image_load_provider_get(s, mime);
+	return enesim_image_provider_load_progressive(prov, s, b, mpool, area,
+			cb, data, options, err);
+}
 /**
  * Load an image asynchronously
  *
@@ -258,12 +331,13 @@ EAPI Eina_Bool enesim_image_load(Enesim_Stream *data, const char *mime,
  * @param[in] cb The function that will get called once the load is done
  * @param[in] data User provided data
  * @param[in] options Any option the provider might require
+ * @return The job handle, valid until @p cb is called
  */
-EAPI void enesim_image_load_async(Enesim_Stream *s, const char *mime,
+EAPI Enesim_Image_Job * enesim_image_load_async(Enesim_Stream *s, const char *mime,
 		Enesim_Buffer *b, Enesim_Pool *mpool, Enesim_Image_Callback cb,
 		void *data, const char *options)
 {
-	enesim_image_context_load_async(_main_context, s, mime, b, mpool, cb,
+	return enesim_image_context_load_async(_main_context, s, mime, b, mpool, cb,
 			data, options);
 }
 /**
@@ -294,12 +368,13 @@ EAPI Eina_Bool enesim_image_save(Enesim_Stream *s, const char *mime,
  * @param[in] cb The function that will get called once the save is done
  * @param[in] data User provided data
  * @param[in] options Any option the provider might require
+ * @return The job handle, valid until @p cb is called
  */
-EAPI void enesim_image_save_async(Enesim_Stream *s, const char *mime,
+EAPI Enesim_Image_Job * enesim_image_save_async(Enesim_Stream *s, const char *mime,
 		Enesim_Buffer *b, Enesim_Image_Callback cb,
 		void *data, const char *options)
 {
-	enesim_image_context_save_async(_main_context, s, mime, b, cb, data,
+	return enesim_image_context_save_async(_main_context, s, mime, b, cb, data,
 			options);
 }
 
@@ -523,3 +598,65 @@ EAPI void enesim_image_options_parse(const char *options, Enesim_Image_Option cb
 	/* and call the attr_cb */
 	free(orig);
 }
+
+/**
+ * @brief Parse the scale options of a provider
+ * @param[in] options The options string
+ * @return The parsed scale options
+ *
+ * The supported options are "scale=1/N" or "scale=N" to decode at 1/N of
+ * the image size and "max_size=WxH" to decode at the smallest size still
+ * bigger than the one the image will be shown at. Other options are ignored.
+ * @see enesim_image_scale_options_free()
+ */
+EAPI Enesim_Image_Scale_Options * enesim_image_scale_options_parse(const char *options)
+{
+	Enesim_Image_Scale_Options *thiz;
+
+	thiz = calloc(1, sizeof(Enesim_Image_Scale_Options));
+	if (options)
+		enesim_image_options_parse(options, _scale_options_cb, thiz);
+	return thiz;
+}
+
+/**
+ * @brief Free the scale options of a provider
+ * @param[in] thiz The options to free
+ */
+EAPI void enesim_image_scale_options_free(Enesim_Image_Scale_Options *thiz)
+{
+	free(thiz);
+}
+
+/**
+ * @brief Get the scale to decode an image at
+ * @param[in] thiz The scale options. Can be NULL
+ * @param[in] w The width of the image
+ * @param[in] h The height of the image
+ * @return The scale to decode the image at, 1, 2, 4 or 8
+ *
+ * The scales are the ones libjpeg can decode at, the other providers use
+ * the same ones to behave the same.
+ */
+EAPI int enesim_image_scale_options_scale_get(const Enesim_Image_Scale_Options *thiz,
+		int w, int h)
+{
+	int scale = 1;
+
+	if (!thiz)
+		return 1;
+	if (thiz->scale)
+	{
+		while (scale * 2 <= thiz->scale && scale < 8)
+			scale *= 2;
+	}
+	else if (thiz->max_w > 0 && thiz->max_h > 0)
+	{
+		/* the smallest size still bigger than the requested one */
+		while (scale < 8 &&
+				(w + scale * 2 - 1) / (scale * 2) >= thiz->max_w &&
+				(h + scale * 2 - 1) / (scale * 2) >= thiz->max_h)
+			scale *= 2;
+	}
+	return scale;
+}
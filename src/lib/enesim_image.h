@@ -45,6 +45,7 @@ EAPI extern Eina_Error ENESIM_IMAGE_ERROR_SIZE;
 EAPI extern Eina_Error ENESIM_IMAGE_ERROR_ALLOCATOR;
 EAPI extern Eina_Error ENESIM_IMAGE_ERROR_LOADING;
 EAPI extern Eina_Error ENESIM_IMAGE_ERROR_SAVING;
+EAPI extern Eina_Error ENESIM_IMAGE_ERROR_CANCELLED;
 
 /**
  * Function prototype called whenever an image is loaded or saved
@@ -55,6 +56,21 @@ EAPI extern Eina_Error ENESIM_IMAGE_ERROR_SAVING;
 typedef void (*Enesim_Image_Callback)(Enesim_Buffer *b, void *data,
 		Eina_Bool success, Eina_Error error);
 
+/** An asynchronous load or save */
+typedef struct _Enesim_Image_Job Enesim_Image_Job;
+
+/**
+ * Function prototype called whenever a band of rows of an image is decoded
+ * @param b The buffer the image is being loaded into
+ * @param y The first row of the band
+ * @param h The number of rows of the band
+ * @param final EINA_FALSE if the rows are an approximation that a later pass
+ * will refine, EINA_TRUE otherwise
+ * @param data The user provided data
+ */
+typedef void (*Enesim_Image_Progress)(Enesim_Buffer *b, int y, int h,
+		Eina_Bool final, void *data);
+
 /**
  * @}
  * @defgroup Enesim_Image Image
@@ -70,12 +86,16 @@ EAPI Eina_Bool enesim_image_info_get(Enesim_Stream *s, const char *mime,
 EAPI Eina_Bool enesim_image_load(Enesim_Stream *s, const char *mime,
 		Enesim_Buffer **b, Enesim_Pool *mpool, const char *options,
 		Eina_Error *err);
-EAPI void enesim_image_load_async(Enesim_Stream *s, const char *mime,
+EAPI Eina_Bool enesim_image_load_progressive(Enesim_Stream *s,
+		const char *mime, Enesim_Buffer **b, Enesim_Pool *mpool,
+		const Eina_Rectangle *area, Enesim_Image_Progress cb,
+		void *user_data, const char *options, Eina_Error *err);
+EAPI Enesim_Image_Job * enesim_image_load_async(Enesim_Stream *s, const char *mime,
 		Enesim_Buffer *b, Enesim_Pool *mpool,
 		Enesim_Image_Callback cb, void *user_data, const char *options);
 EAPI Eina_Bool enesim_image_save(Enesim_Stream *s, const char *mime,
 		Enesim_Buffer *b, const char *options, Eina_Error *err);
-EAPI void enesim_image_save_async(Enesim_Stream *s, const char *mime,
+EAPI Enesim_Image_Job * enesim_image_save_async(Enesim_Stream *s, const char *mime,
 		Enesim_Buffer *b, Enesim_Image_Callback cb, void *user_data,
 		const char *options);
 
@@ -89,14 +109,18 @@ EAPI void enesim_image_save_async(Enesim_Stream *s, const char *mime,
 typedef struct _Enesim_Image_Context Enesim_Image_Context;
 
 EAPI Enesim_Image_Context * enesim_image_context_new(void);
+EAPI Enesim_Image_Context * enesim_image_context_new_workers(unsigned int workers);
 EAPI void enesim_image_context_free(Enesim_Image_Context *thiz);
-EAPI void enesim_image_context_load_async(Enesim_Image_Context *thiz,
+EAPI Enesim_Image_Job * enesim_image_context_load_async(Enesim_Image_Context *thiz,
 		Enesim_Stream *data, const char *mime, Enesim_Buffer *b,
 		Enesim_Pool *mpool, Enesim_Image_Callback cb,
 		void *user_data, const char *options);
-EAPI void enesim_image_context_save_async(Enesim_Image_Context *thiz, Enesim_Stream *data,
+EAPI Enesim_Image_Job * enesim_image_context_save_async(Enesim_Image_Context *thiz, Enesim_Stream *data,
 		const char *mime, Enesim_Buffer *b, Enesim_Image_Callback cb,
 		void *user_data, const char *options);
+EAPI Eina_Bool enesim_image_job_cancel(Enesim_Image_Job *j);
+EAPI Eina_Bool enesim_image_job_priority_set(Enesim_Image_Job *j,
+		Enesim_Priority priority);
 EAPI void enesim_image_context_dispatch(Enesim_Image_Context *thiz);
 
 /**
@@ -111,15 +135,37 @@ EAPI Eina_Bool enesim_image_file_info_get(const char *file, int *w, int *h,
 		Eina_Error *err);
 EAPI Eina_Bool enesim_image_file_load(const char *file, Enesim_Buffer **b,
 		Enesim_Pool *mpool, const char *options, Eina_Error *err);
-EAPI void enesim_image_file_load_async(const char *file, Enesim_Buffer *b,
+EAPI Eina_Bool enesim_image_file_load_progressive(const char *file,
+		Enesim_Buffer **b, Enesim_Pool *mpool,
+		const Eina_Rectangle *area, Enesim_Image_Progress cb,
+		void *user_data, const char *options, Eina_Error *err);
+EAPI Enesim_Image_Job * enesim_image_file_load_async(const char *file, Enesim_Buffer *b,
 		Enesim_Pool *mpool, Enesim_Image_Callback cb,
 		void *user_data, const char *options);
 EAPI Eina_Bool enesim_image_file_save(const char *file, Enesim_Buffer *b,
 		const char *options, Eina_Error *err);
-EAPI void enesim_image_file_save_async(const char *file, Enesim_Buffer *b,
+EAPI Enesim_Image_Job * enesim_image_file_save_async(const char *file, Enesim_Buffer *b,
 		Enesim_Image_Callback cb, void *user_data,
 		const char *options);
 
+/**
+ * @}
+ * @defgroup Enesim_Image_Cache Decoded image cache
+ * @brief Process wide cache of decoded images
+ * @ingroup Enesim_Image
+ * @{
+ */
+EAPI Eina_Bool enesim_image_cache_load(Enesim_Stream *s, const char *mime,
+		Enesim_Buffer **b, Enesim_Buffer_Format fmt, const char *options,
+		Eina_Error *err);
+EAPI Eina_Bool enesim_image_cache_file_load(const char *file,
+		Enesim_Buffer **b, Enesim_Buffer_Format fmt, const char *options,
+		Eina_Error *err);
+EAPI void enesim_image_cache_size_set(size_t size);
+EAPI size_t enesim_image_cache_size_get(void);
+EAPI size_t enesim_image_cache_usage_get(void);
+EAPI void enesim_image_cache_flush(void);
+
 /**
  * @}
  * @defgroup Enesim_Image_Provider_Descriptor_Definitions Definitions
@@ -163,6 +209,10 @@ typedef Eina_Bool (*Enesim_Image_Provider_Saveable)(Enesim_Buffer *b);
 typedef Eina_Bool (*Enesim_Image_Provider_Info_Get)(Enesim_Stream *data, int *w, int *h, Enesim_Buffer_Format *sfmt, void *options, Eina_Error *err);
 
 /**
+ * Fill @p formats with the formats the image can also be loaded into,
+ * besides the one returned by the info_get function. At most
+ * ENESIM_BUFFER_FORMAT_LAST formats are filled. Returns the number of
+ * formats filled
  * @ender_name{enesim.image.provider.formats_get}
  */
 typedef int (*Enesim_Image_Provider_Formats_Get)(Enesim_Buffer_Format *formats, void *options, Eina_Error *err);
@@ -172,6 +222,11 @@ typedef int (*Enesim_Image_Provider_Formats_Get)(Enesim_Buffer_Format *formats,
  */
 typedef Eina_Bool (*Enesim_Image_Provider_Load)(Enesim_Stream *data, Enesim_Buffer *b, void *options, Eina_Error *err);
 
+/**
+ * @ender_name{enesim.image.provider.load_progressive}
+ */
+typedef Eina_Bool (*Enesim_Image_Provider_Load_Progressive)(Enesim_Stream *data, Enesim_Buffer *b, const Eina_Rectangle *area, Enesim_Image_Progress cb, void *cb_data, void *options, Eina_Error *err);
+
 /**
  * @ender_name{enesim.image.provider.save}
  */
@@ -185,7 +240,7 @@ typedef Eina_Bool (*Enesim_Image_Provider_Save)(Enesim_Stream *data, Enesim_Buff
  * @{
  */
 
-#define ENESIM_IMAGE_PROVIDER_DESCRIPTOR_VERSION 0
+#define ENESIM_IMAGE_PROVIDER_DESCRIPTOR_VERSION 1
 
 typedef struct _Enesim_Image_Provider_Descriptor
 {
@@ -199,6 +254,8 @@ typedef struct _Enesim_Image_Provider_Descriptor
 	Enesim_Image_Provider_Formats_Get formats_get;
 	Enesim_Image_Provider_Load load;
 	Enesim_Image_Provider_Save save;
+	/* since version 1 */
+	Enesim_Image_Provider_Load_Progressive load_progressive;
 } Enesim_Image_Provider_Descriptor;
 
 
@@ -274,6 +331,21 @@ EAPI void enesim_image_finder_unregister(Enesim_Image_Finder_Descriptor *f);
 typedef void (*Enesim_Image_Option)(void *data, const char *key, const char *value);
 EAPI void enesim_image_options_parse(const char *options, Enesim_Image_Option cb, void *data);
 
+/**
+ * The scale options supported by the providers that decode at a reduced size
+ */
+typedef struct _Enesim_Image_Scale_Options
+{
+	int scale; /**< Decode at 1/scale of the image size */
+	int max_w; /**< Or find the scale based on the size the image will be shown at */
+	int max_h; /**< Or find the scale based on the size the image will be shown at */
+} Enesim_Image_Scale_Options;
+
+EAPI Enesim_Image_Scale_Options * enesim_image_scale_options_parse(const char *options);
+EAPI void enesim_image_scale_options_free(Enesim_Image_Scale_Options *thiz);
+EAPI int enesim_image_scale_options_scale_get(const Enesim_Image_Scale_Options *thiz,
+		int w, int h);
+
 EAPI const char * enesim_image_mime_data_from(Enesim_Stream *data);
 EAPI const char * enesim_image_mime_extension_from(const char *ext);
 
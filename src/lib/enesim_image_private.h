@@ -45,6 +45,9 @@
 int enesim_image_init(void);
 int enesim_image_shutdown(void);
 
+void enesim_image_cache_init(void);
+void enesim_image_cache_shutdown(void);
+
 typedef struct _Enesim_Image_Provider Enesim_Image_Provider;
 
 struct _Enesim_Image_Provider
@@ -83,6 +86,10 @@ Eina_Bool enesim_image_provider_info_get(Enesim_Image_Provider *thiz,
 Eina_Bool enesim_image_provider_load(Enesim_Image_Provider *thiz,
 		Enesim_Stream *data, Enesim_Buffer **b,
 		Enesim_Pool *mpool, const char *options, Eina_Error *err);
+Eina_Bool enesim_image_provider_load_progressive(Enesim_Image_Provider *thiz,
+		Enesim_Stream *data, Enesim_Buffer **b, Enesim_Pool *mpool,
+		const Eina_Rectangle *area, Enesim_Image_Progress cb,
+		void *cb_data, const char *options, Eina_Error *err);
 Eina_Bool enesim_image_provider_save(Enesim_Image_Provider *thiz,
 		Enesim_Stream *data, Enesim_Buffer *b,
 		const char *options, Eina_Error *err);
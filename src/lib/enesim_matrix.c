@@ -60,6 +60,28 @@ static double _cos(double x)
 
 	return _sin(x);
 }
+
+/* How far a coefficient or a translation can be moved when snapping a matrix.
+ * The coefficients are multiplied by the coordinates, so their tolerance
+ * keeps the error of a 4096 pixels wide surface below the one of the
+ * translation, 1/256 of a pixel on good quality and 1/16 on fast quality.
+ * The best quality only discards the rounding errors
+ */
+static const struct {
+	double coeff;
+	double translate;
+} _snap_tolerance[ENESIM_QUALITY_LAST] = {
+	/* ENESIM_QUALITY_BEST */ { 1e-9, 1e-9 },
+	/* ENESIM_QUALITY_GOOD */ { 1 / (256.0 * 4096.0), 1 / 256.0 },
+	/* ENESIM_QUALITY_FAST */ { 1 / (16.0 * 4096.0), 1 / 16.0 },
+};
+
+static inline double _snap(double v, double to, double tolerance)
+{
+	if (fabs(v - to) <= tolerance)
+		return to;
+	return v;
+}
 /** @endcond */
 /*============================================================================*
  *                                   API                                      *
@@ -87,6 +109,81 @@ EAPI Enesim_Matrix_Type enesim_matrix_type_get(const Enesim_Matrix *m)
 	}
 }
 
+/**
+ * @brief Classify a floating point matrix snapping it to the nearest
+ * simpler matrix.
+ *
+ * @param m The floating point matrix.
+ * @param quality The quality the matrix is going to be used with.
+ * @param snapped The matrix with the snapped coefficients. Can be @p m.
+ * @param hints The shape of the snapped matrix. Can be NULL.
+ * @return The type of the snapped matrix.
+ *
+ * Every coefficient of @p m that is close enough to zero or one, and every
+ * translation close enough to a pixel boundary is snapped to it. How close
+ * depends on @p quality, the lower the quality the bigger the error allowed,
+ * and for the best quality only the rounding errors are discarded. This way
+ * a matrix with a tiny rotation is classified as a translation or an
+ * identity and can be drawn with the faster paths.
+ * Projective matrices are copied as they are.
+ */
+EAPI Enesim_Matrix_Type enesim_matrix_classify(const Enesim_Matrix *m,
+		Enesim_Quality quality, Enesim_Matrix *snapped,
+		Enesim_Matrix_Hint *hints)
+{
+	Enesim_Matrix_Hint h = ENESIM_MATRIX_HINT_NONE;
+	Enesim_Matrix_Type type;
+	Enesim_Matrix s;
+	double ct, tt;
+
+	if ((unsigned int)quality >= ENESIM_QUALITY_LAST)
+		quality = ENESIM_QUALITY_BEST;
+	ct = _snap_tolerance[quality].coeff;
+	tt = _snap_tolerance[quality].translate;
+
+	s = *m;
+	MATRIX_ZX(&s) = _snap(MATRIX_ZX(m), 0, ct);
+	MATRIX_ZY(&s) = _snap(MATRIX_ZY(m), 0, ct);
+	MATRIX_ZZ(&s) = _snap(MATRIX_ZZ(m), 1, ct);
+	if ((MATRIX_ZX(&s) != 0) || (MATRIX_ZY(&s) != 0) || (MATRIX_ZZ(&s) != 1))
+	{
+		*snapped = *m;
+		if (hints) *hints = h;
+		return ENESIM_MATRIX_TYPE_PROJECTIVE;
+	}
+
+	MATRIX_XX(&s) = _snap(MATRIX_XX(m), 1, ct);
+	MATRIX_XY(&s) = _snap(MATRIX_XY(m), 0, ct);
+	MATRIX_YX(&s) = _snap(MATRIX_YX(m), 0, ct);
+	MATRIX_YY(&s) = _snap(MATRIX_YY(m), 1, ct);
+	MATRIX_XZ(&s) = _snap(MATRIX_XZ(m), round(MATRIX_XZ(m)), tt);
+	MATRIX_YZ(&s) = _snap(MATRIX_YZ(m), round(MATRIX_YZ(m)), tt);
+
+	type = ENESIM_MATRIX_TYPE_AFFINE;
+	if ((MATRIX_XY(&s) == 0) && (MATRIX_YX(&s) == 0))
+	{
+		if ((MATRIX_XX(&s) != 1) || (MATRIX_YY(&s) != 1))
+		{
+			h |= ENESIM_MATRIX_HINT_SCALE;
+		}
+		else if ((MATRIX_XZ(&s) != 0) || (MATRIX_YZ(&s) != 0))
+		{
+			h |= ENESIM_MATRIX_HINT_TRANSLATE;
+			if ((MATRIX_XZ(&s) == floor(MATRIX_XZ(&s))) &&
+					(MATRIX_YZ(&s) == floor(MATRIX_YZ(&s))))
+				h |= ENESIM_MATRIX_HINT_INTEGER_TRANSLATE;
+		}
+		else
+		{
+			type = ENESIM_MATRIX_TYPE_IDENTITY;
+		}
+	}
+
+	*snapped = s;
+	if (hints) *hints = h;
+	return type;
+}
+
 /**
  * @brief Return the type of the given fixed point matrix.
  *
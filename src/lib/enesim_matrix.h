@@ -18,6 +18,7 @@
 #ifndef ENESIM_MATRIX_H_
 #define ENESIM_MATRIX_H_
 
+#include "enesim_main.h"
 #include "enesim_quad.h"
 
 /**
@@ -43,6 +44,17 @@ typedef enum _Enesim_Matrix_Type
 /**< The total number of matrix types */
 #define ENESIM_MATRIX_TYPE_LAST (ENESIM_MATRIX_TYPE_PROJECTIVE + 1)
 
+/**
+ * Hints about the shape of an affine matrix
+ */
+typedef enum _Enesim_Matrix_Hint
+{
+	ENESIM_MATRIX_HINT_NONE = 0, /**< No special shape */
+	ENESIM_MATRIX_HINT_TRANSLATE = (1 << 0), /**< The matrix only translates */
+	ENESIM_MATRIX_HINT_INTEGER_TRANSLATE = (1 << 1), /**< The translation is on pixel boundaries */
+	ENESIM_MATRIX_HINT_SCALE = (1 << 2), /**< The matrix scales along the axes, without rotating or skewing */
+} Enesim_Matrix_Hint;
+
 /**
  * @}
  * @defgroup Enesim_Matrix_F16p16 Matrices in fixed point
@@ -112,6 +124,9 @@ typedef struct _Enesim_Matrix
 } Enesim_Matrix;
 
 EAPI Enesim_Matrix_Type enesim_matrix_type_get(const Enesim_Matrix *m);
+EAPI Enesim_Matrix_Type enesim_matrix_classify(const Enesim_Matrix *m,
+		Enesim_Quality quality, Enesim_Matrix *snapped,
+		Enesim_Matrix_Hint *hints);
 EAPI void enesim_matrix_values_set(Enesim_Matrix *m, double a, double b, double c,
 		double d, double e, double f, double g, double h, double i);
 EAPI void enesim_matrix_values_get(const Enesim_Matrix *m, double *a, double *b,
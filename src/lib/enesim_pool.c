@@ -67,8 +67,24 @@ Eina_Bool enesim_pool_data_from(Enesim_Pool *p, Enesim_Backend *backend, void **
 	if (!p->descriptor) return EINA_FALSE;
 	if (!p->descriptor->data_from)
 	{
-		WRN("No data_from() implementation");
-		return EINA_FALSE;
+		Enesim_Buffer_Sw_Data dst;
+
+		/* a copy can always be done on a new software buffer */
+		if (!copy || !p->descriptor->data_alloc || !p->descriptor->data_get)
+		{
+			WRN("No data_from() implementation");
+			return EINA_FALSE;
+		}
+		if (!p->descriptor->data_alloc(p->data, backend, data, fmt, w, h))
+			return EINA_FALSE;
+		if (*backend != ENESIM_BACKEND_SOFTWARE ||
+				!p->descriptor->data_get(p->data, *data, fmt, w, h, &dst) ||
+				!enesim_buffer_sw_data_copy(&dst, from, fmt, w, h))
+		{
+			enesim_pool_data_free(p, *data, fmt, EINA_FALSE);
+			return EINA_FALSE;
+		}
+		return EINA_TRUE;
 	}
 
 	return p->descriptor->data_from(p->data, backend, data, fmt, w, h, copy, from);
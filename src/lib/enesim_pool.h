@@ -23,6 +23,8 @@
  * @ender_group{Enesim_Pool}
  * @ender_group{Enesim_Pool_Sw}
  * @ender_group{Enesim_Pool_Eina}
+ * @ender_group{Enesim_Pool_Huge}
+ * @ender_group{Enesim_Pool_File}
  */
 
 /**
@@ -49,7 +51,22 @@ EAPI void * enesim_pool_descriptor_data_get(Enesim_Pool *thiz);
  * @{
  */
 
+/**
+ * Statistics of the Sw pool
+ */
+typedef struct _Enesim_Pool_Sw_Stats
+{
+	size_t allocs; /**< The number of blocks requested */
+	size_t reuses; /**< The number of blocks taken from the free lists */
+	size_t used; /**< The bytes used by alive buffers */
+	size_t cached; /**< The bytes kept on the free lists */
+} Enesim_Pool_Sw_Stats;
+
 EAPI Enesim_Pool * enesim_pool_sw_new(void);
+EAPI void enesim_pool_sw_cache_size_set(size_t size);
+EAPI size_t enesim_pool_sw_cache_size_get(void);
+EAPI void enesim_pool_sw_trim(size_t size);
+EAPI void enesim_pool_sw_stats_get(Enesim_Pool_Sw_Stats *stats);
 
 /**
  * @}
@@ -61,6 +78,26 @@ EAPI Enesim_Pool * enesim_pool_sw_new(void);
 
 EAPI Enesim_Pool * enesim_pool_eina_new(Eina_Mempool *mp);
 
+/**
+ * @}
+ * @defgroup Enesim_Pool_Huge Huge pages Pool
+ * @ingroup Enesim_Pool
+ * @brief Enesim pool based on huge pages @ender_inherits{Enesim_Pool}
+ * @{
+ */
+
+EAPI Enesim_Pool * enesim_pool_huge_new(Eina_Bool hugetlb);
+
+/**
+ * @}
+ * @defgroup Enesim_Pool_File File Pool
+ * @ingroup Enesim_Pool
+ * @brief Enesim pool based on mapped files @ender_inherits{Enesim_Pool}
+ * @{
+ */
+
+EAPI Enesim_Pool * enesim_pool_file_new(const char *dir);
+
 /** @} */
 
 #endif
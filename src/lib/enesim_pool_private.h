@@ -77,6 +77,9 @@ void enesim_pool_shutdown(void);
 void enesim_pool_sw_init(void);
 void enesim_pool_sw_shutdown(void);
 
+Eina_Bool enesim_pool_file_data_fd_get(Enesim_Pool *p, void *backend_data,
+		int *fd, size_t *size);
+
 Enesim_Pool * enesim_pool_new(Enesim_Pool_Descriptor *descriptor, void *data);
 Eina_Bool enesim_pool_data_alloc(Enesim_Pool *p, Enesim_Backend *backend, void **data,
 		Enesim_Buffer_Format fmt, uint32_t w, uint32_t h);
@@ -163,8 +163,95 @@ static Eina_Bool _state_changed(Enesim_Renderer_State *thiz,
 	return EINA_FALSE;
 }
 
+/* The writers only wait for another writer or for a setup to copy the
+ * values, never for a draw
+ */
+static inline void _state_next_lock(Enesim_Renderer_State *thiz)
+{
+	while (__sync_lock_test_and_set(&thiz->next_lock, 1))
+	{
+		while (thiz->next_lock);
+	}
+}
+
+static inline void _state_next_unlock(Enesim_Renderer_State *thiz)
+{
+	__sync_lock_release(&thiz->next_lock);
+}
+
+/* Publish the values modified by a writer */
+static inline void _state_next_publish(Enesim_Renderer_State *thiz)
+{
+	thiz->next_changed = EINA_TRUE;
+	_state_next_unlock(thiz);
+}
+
+/* Snap the transformation to the simplest one the quality allows, so the
+ * renderers can pick their faster paths. A translation on pixel boundaries
+ * is the same as moving the origin, but only for the renderers that use
+ * both, otherwise the move would be lost or reported as another change
+ */
+static void _state_transformation_snap(Enesim_Renderer_State_Values *v,
+		int features)
+{
+	Enesim_Matrix_Hint hints;
+
+	v->transformation_type = enesim_matrix_classify(&v->transformation,
+			v->quality, &v->transformation, &hints);
+	if ((hints & ENESIM_MATRIX_HINT_INTEGER_TRANSLATE) &&
+			(features & ENESIM_RENDERER_FEATURE_TRANSLATE) &&
+			(features & ENESIM_RENDERER_FEATURE_TRANSFORMATION))
+	{
+		v->ox += v->transformation.xz;
+		v->oy += v->transformation.yz;
+		enesim_matrix_identity(&v->transformation);
+		v->transformation_type = ENESIM_MATRIX_TYPE_IDENTITY;
+		hints = ENESIM_MATRIX_HINT_NONE;
+	}
+	v->transformation_hints = hints;
+}
+
+/* Pick the latest published values. The renderer must be locked */
+static void _state_latch(Enesim_Renderer *r)
+{
+	Enesim_Renderer_State *thiz = &r->state;
+	Enesim_Renderer *old_mask;
+
+	if (!thiz->next_changed)
+		return;
+
+	_state_next_lock(thiz);
+	old_mask = thiz->current.mask;
+	thiz->current = thiz->next;
+	if (thiz->current.mask)
+		enesim_renderer_ref(thiz->current.mask);
+	thiz->next_changed = EINA_FALSE;
+	_state_next_unlock(thiz);
+	_state_transformation_snap(&thiz->current,
+			enesim_renderer_features_get(r));
+
+	if (old_mask)
+		enesim_renderer_unref(old_mask);
+	thiz->changed = EINA_TRUE;
+}
+
+/* While drawing, the values picked on the setup must be used */
+static inline const Enesim_Renderer_State_Values * _state_values_get(
+		Enesim_Renderer *r)
+{
+	if (r->drawing)
+		return &r->state.current;
+	return &r->state.next;
+}
+
 static void _state_clear(Enesim_Renderer_State *thiz)
 {
+	/* next */
+	if (thiz->next.mask)
+	{
+		enesim_renderer_unref(thiz->next.mask);
+		thiz->next.mask = NULL;
+	}
 	/* past */
 	if (thiz->past.mask)
 	{
@@ -192,6 +279,9 @@ static void _state_init(Enesim_Renderer_State *thiz)
 	enesim_matrix_identity(&thiz->past.transformation);
 	thiz->current.transformation_type = ENESIM_MATRIX_TYPE_IDENTITY;
 	thiz->past.transformation_type = ENESIM_MATRIX_TYPE_IDENTITY;
+	thiz->current.transformation_hints = ENESIM_MATRIX_HINT_NONE;
+	thiz->past.transformation_hints = ENESIM_MATRIX_HINT_NONE;
+	thiz->next = thiz->current;
 }
 
 static void _state_commit(Enesim_Renderer_State *thiz)
@@ -259,23 +349,17 @@ static void _draw_list_internal(Enesim_Renderer *r, Enesim_Surface *s,
 		int y)
 {
 	Enesim_Backend b;
+#if BUILD_OPENGL
 	Eina_Rectangle *clip;
 	Eina_List *l;
+#endif
 
 	enesim_surface_lock(s, EINA_TRUE);
 	b = enesim_surface_backend_get(s);
 	switch (b)
 	{
 		case ENESIM_BACKEND_SOFTWARE:
-		EINA_LIST_FOREACH(clips, l, clip)
-		{
-			Eina_Rectangle final;
-
-			final = *clip;
-			if (!eina_rectangle_intersection(&final, area))
-				continue;
-			enesim_renderer_sw_draw_area(r, s, rop, &final, x, y);
-		}
+		enesim_renderer_sw_draw_list(r, s, rop, area, clips, x, y);
 		break;
 
 		case ENESIM_BACKEND_OPENGL:
@@ -306,6 +390,99 @@ static inline void _surface_bounds(Enesim_Surface *s, Eina_Rectangle *bounds)
 	enesim_surface_size_get(s, &bounds->w, &bounds->h);
 }
 
+/*----------------------------------------------------------------------------*
+ *                     Prepared state related functions                       *
+ *----------------------------------------------------------------------------*/
+/* Do the cleanup that was not done after the last draw */
+static void _prepared_release(Enesim_Renderer *r)
+{
+	Enesim_Surface *s;
+
+	if (!r->prepared) return;
+
+	s = r->prepared_s;
+	r->prepared = EINA_FALSE;
+	r->prepared_s = NULL;
+	/* the cleanup expects the renderer to be locked */
+	enesim_renderer_lock(r);
+	enesim_renderer_cleanup(r, s);
+	enesim_surface_unref(s);
+}
+
+static Eina_Bool _prepared_is_valid(Enesim_Renderer *r, Enesim_Surface *s,
+		Enesim_Rop rop)
+{
+	Enesim_Backend b;
+
+	if (rop != r->current_rop)
+		return EINA_FALSE;
+	b = enesim_surface_backend_get(s);
+	if (b != enesim_surface_backend_get(r->prepared_s))
+		return EINA_FALSE;
+	if (enesim_surface_format_get(s) != r->prepared_format)
+		return EINA_FALSE;
+	/* the other backends might keep data associated with the surface */
+	if (b != ENESIM_BACKEND_SOFTWARE && s != r->prepared_s)
+		return EINA_FALSE;
+	if (enesim_renderer_has_changed(r))
+		return EINA_FALSE;
+	return EINA_TRUE;
+}
+
+/* Setup the renderer for a draw. In case the renderer is still prepared for
+ * the same format and rop and nothing has changed, the whole setup is
+ * skipped. Returns on @keep if the renderer can be kept prepared after the
+ * draw
+ */
+static Eina_Bool _draw_setup(Enesim_Renderer *r, Enesim_Surface *s,
+		Enesim_Rop rop, Eina_Bool *keep, Enesim_Log **log)
+{
+	*keep = EINA_FALSE;
+	if (r->prepared)
+	{
+		if (_prepared_is_valid(r, s, rop))
+		{
+			DBG("Renderer '%s' already prepared", r->name);
+			if (enesim_renderer_profile_enabled)
+				enesim_renderer_profile_hit_add(r);
+			if (s != r->prepared_s)
+			{
+				enesim_surface_unref(r->prepared_s);
+				r->prepared_s = enesim_surface_ref(s);
+			}
+			enesim_renderer_lock(r);
+			*keep = EINA_TRUE;
+			return EINA_TRUE;
+		}
+		_prepared_release(r);
+	}
+	/* only keep the renderer prepared when there is nothing to commit,
+	 * otherwise the changes will still be reported after the draw
+	 */
+	if (r->keep_prepared && !enesim_renderer_has_changed(r))
+		*keep = EINA_TRUE;
+	return enesim_renderer_setup(r, s, rop, log);
+}
+
+static void _draw_cleanup(Enesim_Renderer *r, Enesim_Surface *s,
+		Eina_Bool keep)
+{
+	if (!keep || !r->in_setup)
+	{
+		enesim_renderer_cleanup(r, s);
+		return;
+	}
+	if (!r->prepared)
+	{
+		r->prepared = EINA_TRUE;
+		r->prepared_s = enesim_surface_ref(s);
+		r->prepared_format = enesim_surface_format_get(s);
+	}
+	r->past_bounds = r->current_bounds;
+	r->past_destination_bounds = r->current_destination_bounds;
+	enesim_renderer_unlock(r);
+}
+
 static const char * _base_name_get(Enesim_Renderer *r)
 {
 	Enesim_Renderer_Class *k;
@@ -376,6 +553,8 @@ static void _enesim_renderer_instance_deinit(void *o)
 {
 	Enesim_Renderer *thiz = ENESIM_RENDERER(o);
 
+	_prepared_release(thiz);
+	enesim_renderer_profile_free(thiz);
 	eina_lock_free(&thiz->lock);
 	eina_hash_free(thiz->prv_data);
 	/* remove all the private data */
@@ -402,6 +581,7 @@ void enesim_renderer_init(void)
 {
 	_factories = eina_hash_string_superfast_new(
 			_enesim_renderer_factory_free);
+	enesim_renderer_profile_init();
 	enesim_renderer_sw_init();
 #if BUILD_OPENCL
 	enesim_renderer_opencl_init();
@@ -420,6 +600,7 @@ void enesim_renderer_shutdown(void)
 #if BUILD_OPENGL
 	enesim_renderer_opengl_shutdown();
 #endif
+	enesim_renderer_profile_shutdown();
 	eina_hash_free(_factories);
 	_factories = NULL;
 }
@@ -484,8 +665,19 @@ Eina_Bool enesim_renderer_state_has_changed(Enesim_Renderer *r)
 	Eina_Bool ret;
 	int features;
 
+	/* pick the latest values in case nobody is drawing the renderer */
+	if (!r->drawing && eina_lock_take_try(&r->lock) == EINA_LOCK_SUCCEED)
+	{
+		_state_latch(r);
+		eina_lock_release(&r->lock);
+	}
 	features = enesim_renderer_features_get(r);
 	ret = _state_changed(&r->state, features);
+	/* the values set while the setup is kept, like on the children of a
+	 * renderer kept prepared, are only picked by the next setup
+	 */
+	if (!ret && r->drawing && r->state.next_changed)
+		ret = EINA_TRUE;
 	return ret;
 }
 
@@ -499,15 +691,23 @@ Eina_Bool enesim_renderer_setup(Enesim_Renderer *r, Enesim_Surface *s,
 {
 	Enesim_Backend b;
 	Eina_Bool ret = EINA_TRUE;
+	uint64_t start = 0;
 
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 	DBG("Setting up the renderer '%s' with rop %d", r->name, rop);
+	/* a renderer kept prepared is now being used by another one */
+	if (r->prepared)
+		_prepared_release(r);
 	if (r->in_setup)
 	{
 		INF("Renderer '%s' already in the setup process", r->name);
 		return EINA_TRUE;
 	}
+	if (enesim_renderer_profile_enabled)
+		start = enesim_renderer_profile_time_get();
 	enesim_renderer_lock(r);
+	_state_latch(r);
+	r->drawing = EINA_TRUE;
 
 	b = enesim_surface_backend_get(s);
 	switch (b)
@@ -560,8 +760,12 @@ Eina_Bool enesim_renderer_setup(Enesim_Renderer *r, Enesim_Surface *s,
 	{
 		/* Make sure to commit the state to avoid a change notification */
 		_state_commit(&r->state);
+		r->drawing = EINA_FALSE;
 		enesim_renderer_unlock(r);
 	}
+	if (start)
+		enesim_renderer_profile_add(r, ENESIM_RENDERER_PROFILE_SETUP,
+				start, 0);
 
 	return ret;
 }
@@ -569,6 +773,7 @@ Eina_Bool enesim_renderer_setup(Enesim_Renderer *r, Enesim_Surface *s,
 void enesim_renderer_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
 {
 	Enesim_Backend b;
+	uint64_t start = 0;
 
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 	DBG("Cleaning up the renderer '%s'", r->name);
@@ -577,6 +782,8 @@ void enesim_renderer_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
 		WRN("Renderer '%s' has not done the setup first", r->name);
 		return;
 	}
+	if (enesim_renderer_profile_enabled)
+		start = enesim_renderer_profile_time_get();
 
 	b = enesim_surface_backend_get(s);
 	switch (b)
@@ -602,7 +809,11 @@ void enesim_renderer_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
 	r->past_bounds = r->current_bounds;
 	r->past_destination_bounds = r->current_destination_bounds;
 	r->in_setup = EINA_FALSE;
+	r->drawing = EINA_FALSE;
 	_state_commit(&r->state);
+	if (start)
+		enesim_renderer_profile_add(r, ENESIM_RENDERER_PROFILE_CLEANUP,
+				start, 0);
 
 	enesim_renderer_unlock(r);
 }
@@ -656,7 +867,9 @@ EAPI int enesim_renderer_ref_count(Enesim_Renderer *r)
  * @param[in] r The renderer to lock
  *
  * @note The renderer is automatically locked before a drawing
- * operation
+ * operation. The common properties, like the color, the origin or the
+ * transformation, do not need the lock, they can be set from another
+ * thread while drawing and are used on the next draw
  */
 EAPI void enesim_renderer_lock(Enesim_Renderer *r)
 {
@@ -708,22 +921,38 @@ EAPI int enesim_renderer_features_get(Enesim_Renderer *r)
  * @param[in] r The renderer to set the transformation matrix on
  * @param[in] m The transformation matrix to set
  *
+ * The rounding errors of the matrix are discarded. When drawing, the
+ * transformation is snapped to the simplest matrix the quality of the
+ * renderer allows, and for the renderers that support both the origin and
+ * the transformation, a translation on pixel boundaries is added to the
+ * origin instead. See enesim_matrix_classify().
+ *
  * @note The transformation will only take effect if the renderer supports
  * the @a ENESIM_RENDERER_FEATURE_PROJECTIVE or the @a
  * ENESIM_RENDERER_FEATURE_PROJECTIVE feature. Otherwise it will be ignored
  */
 EAPI void enesim_renderer_transformation_set(Enesim_Renderer *r, const Enesim_Matrix *m)
 {
+	Enesim_Matrix_Type type;
+	Enesim_Matrix_Hint hints;
+	Enesim_Matrix tx;
+
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 	if (!m)
 	{
-		enesim_matrix_identity(&r->state.current.transformation);
-		r->state.current.transformation_type = ENESIM_MATRIX_TYPE_IDENTITY;
-		return;
+		enesim_matrix_identity(&tx);
+		m = &tx;
 	}
-	r->state.current.transformation = *m;
-	r->state.current.transformation_type = enesim_matrix_type_get(m);
-	r->state.changed = EINA_TRUE;
+	/* only the rounding errors are discarded, so the hints describe the
+	 * stored matrix, the snapping for the quality is done on the setup
+	 */
+	type = enesim_matrix_classify(m, ENESIM_QUALITY_BEST, &tx, &hints);
+
+	_state_next_lock(&r->state);
+	r->state.next.transformation = tx;
+	r->state.next.transformation_type = type;
+	r->state.next.transformation_hints = hints;
+	_state_next_publish(&r->state);
 }
 
 /**
@@ -736,7 +965,14 @@ EAPI void enesim_renderer_transformation_get(Enesim_Renderer *r, Enesim_Matrix *
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 	if (!m) return;
-	*m = r->state.current.transformation;
+	if (r->drawing)
+	{
+		*m = r->state.current.transformation;
+		return;
+	}
+	_state_next_lock(&r->state);
+	*m = r->state.next.transformation;
+	_state_next_unlock(&r->state);
 }
 
 /**
@@ -811,8 +1047,9 @@ EAPI void enesim_renderer_origin_get(Enesim_Renderer *r, double *x, double *y)
 EAPI void enesim_renderer_x_origin_set(Enesim_Renderer *r, double x)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	r->state.current.ox = x;
-	r->state.changed = EINA_TRUE;
+	_state_next_lock(&r->state);
+	r->state.next.ox = x;
+	_state_next_publish(&r->state);
 }
 
 /**
@@ -824,7 +1061,7 @@ EAPI void enesim_renderer_x_origin_set(Enesim_Renderer *r, double x)
 EAPI double enesim_renderer_x_origin_get(Enesim_Renderer *r)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	return r->state.current.ox;
+	return _state_values_get(r)->ox;
 }
 
 /**
@@ -838,8 +1075,9 @@ EAPI double enesim_renderer_x_origin_get(Enesim_Renderer *r)
 EAPI void enesim_renderer_y_origin_set(Enesim_Renderer *r, double y)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	r->state.current.oy = y;
-	r->state.changed = EINA_TRUE;
+	_state_next_lock(&r->state);
+	r->state.next.oy = y;
+	_state_next_publish(&r->state);
 }
 
 /**
@@ -851,7 +1089,7 @@ EAPI void enesim_renderer_y_origin_set(Enesim_Renderer *r, double y)
 EAPI double enesim_renderer_y_origin_get(Enesim_Renderer *r)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	return r->state.current.oy;
+	return _state_values_get(r)->oy;
 }
 
 /**
@@ -867,8 +1105,9 @@ EAPI double enesim_renderer_y_origin_get(Enesim_Renderer *r)
 EAPI void enesim_renderer_color_set(Enesim_Renderer *r, Enesim_Color color)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	r->state.current.color = color;
-	r->state.changed = EINA_TRUE;
+	_state_next_lock(&r->state);
+	r->state.next.color = color;
+	_state_next_publish(&r->state);
 }
 
 /**
@@ -880,7 +1119,7 @@ EAPI void enesim_renderer_color_set(Enesim_Renderer *r, Enesim_Color color)
 EAPI Enesim_Color enesim_renderer_color_get(Enesim_Renderer *r)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	return r->state.current.color;
+	return _state_values_get(r)->color;
 }
 
 /**
@@ -893,8 +1132,9 @@ EAPI Enesim_Color enesim_renderer_color_get(Enesim_Renderer *r)
 EAPI void enesim_renderer_visibility_set(Enesim_Renderer *r, Eina_Bool visible)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	r->state.current.visibility = visible;
-	r->state.changed = EINA_TRUE;
+	_state_next_lock(&r->state);
+	r->state.next.visibility = visible;
+	_state_next_publish(&r->state);
 }
 
 /**
@@ -906,7 +1146,7 @@ EAPI void enesim_renderer_visibility_set(Enesim_Renderer *r, Eina_Bool visible)
 EAPI Eina_Bool enesim_renderer_visibility_get(Enesim_Renderer *r)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	return r->state.current.visibility;
+	return _state_values_get(r)->visibility;
 }
 
 /**
@@ -923,11 +1163,12 @@ EAPI void enesim_renderer_mask_set(Enesim_Renderer *r, Enesim_Renderer *mask)
 	Enesim_Renderer *old_mask;
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 
-	old_mask = r->state.current.mask;
-	r->state.current.mask = mask;
+	_state_next_lock(&r->state);
+	old_mask = r->state.next.mask;
+	r->state.next.mask = mask;
+	_state_next_publish(&r->state);
 	if (old_mask)
 		enesim_renderer_unref(old_mask);
-	r->state.changed = EINA_TRUE;
 }
 
 /**
@@ -938,8 +1179,15 @@ EAPI void enesim_renderer_mask_set(Enesim_Renderer *r, Enesim_Renderer *mask)
  */
 EAPI Enesim_Renderer * enesim_renderer_mask_get(Enesim_Renderer *r)
 {
+	Enesim_Renderer *mask;
+
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	return enesim_renderer_ref(r->state.current.mask);
+	if (r->drawing)
+		return enesim_renderer_ref(r->state.current.mask);
+	_state_next_lock(&r->state);
+	mask = enesim_renderer_ref(r->state.next.mask);
+	_state_next_unlock(&r->state);
+	return mask;
 }
 
 /**
@@ -955,8 +1203,9 @@ EAPI void enesim_renderer_mask_channel_set(Enesim_Renderer *r, Enesim_Channel ch
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 
-	r->state.current.mchannel = channel;
-	r->state.changed = EINA_TRUE;
+	_state_next_lock(&r->state);
+	r->state.next.mchannel = channel;
+	_state_next_publish(&r->state);
 }
 
 /**
@@ -968,7 +1217,7 @@ EAPI void enesim_renderer_mask_channel_set(Enesim_Renderer *r, Enesim_Channel ch
 EAPI Enesim_Channel enesim_renderer_mask_channel_get(Enesim_Renderer *r)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	return r->state.current.mchannel;
+	return _state_values_get(r)->mchannel;
 }
 
 /**
@@ -982,8 +1231,9 @@ EAPI Enesim_Channel enesim_renderer_mask_channel_get(Enesim_Renderer *r)
 EAPI void enesim_renderer_quality_set(Enesim_Renderer *r, Enesim_Quality quality)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	r->state.current.quality = quality;
-	r->state.changed = EINA_TRUE;
+	_state_next_lock(&r->state);
+	r->state.next.quality = quality;
+	_state_next_publish(&r->state);
 }
 
 /**
@@ -995,7 +1245,7 @@ EAPI void enesim_renderer_quality_set(Enesim_Renderer *r, Enesim_Quality quality
 EAPI Enesim_Quality enesim_renderer_quality_get(Enesim_Renderer *r)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	return r->state.current.quality;
+	return _state_values_get(r)->quality;
 }
 
 /**
@@ -1024,7 +1274,22 @@ EAPI Enesim_Alpha_Hint enesim_renderer_alpha_hints_get(Enesim_Renderer *thiz)
 EAPI Enesim_Matrix_Type enesim_renderer_transformation_type_get(Enesim_Renderer *r)
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
-	return r->state.current.transformation_type;
+	return _state_values_get(r)->transformation_type;
+}
+
+/**
+ * @brief Gets the shape of the transformation attribute of a renderer.
+ * @param[in] r The renderer to get the transformation hints from
+ * @return The transformation hints
+ *
+ * While drawing, the hints describe the transformation snapped for the
+ * quality of the renderer.
+ * @see enesim_matrix_classify()
+ */
+EAPI Enesim_Matrix_Hint enesim_renderer_transformation_hints_get(Enesim_Renderer *r)
+{
+	ENESIM_MAGIC_CHECK_RENDERER(r);
+	return _state_values_get(r)->transformation_hints;
 }
 
 /**
@@ -1096,7 +1361,7 @@ EAPI Eina_Bool enesim_renderer_bounds_get(Enesim_Renderer *r,
 {
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 	if (!rect) return EINA_FALSE;
-	if (r->in_setup)
+	if (r->in_setup && (!r->prepared || !enesim_renderer_has_changed(r)))
 	{
 		*rect = r->current_bounds;
 		return EINA_TRUE;
@@ -1150,7 +1415,7 @@ EAPI Eina_Bool enesim_renderer_destination_bounds_get(Enesim_Renderer *r, Eina_R
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 
 	if (!rect) return EINA_FALSE;
-	if (r->in_setup || !enesim_renderer_has_changed(r))
+	if ((r->in_setup && !r->prepared) || !enesim_renderer_has_changed(r))
 	{
 		*rect = r->current_destination_bounds;
 	}
@@ -1255,11 +1520,13 @@ EAPI Eina_Bool enesim_renderer_draw(Enesim_Renderer *r, Enesim_Surface *s,
 {
 	Eina_Rectangle final;
 	Eina_Bool ret = EINA_FALSE;
+	Eina_Bool keep;
+	uint64_t start = 0;
 
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 	ENESIM_MAGIC_CHECK_SURFACE(s);
 
-	if (!enesim_renderer_setup(r, s, rop, log))
+	if (!_draw_setup(r, s, rop, &keep, log))
 		goto end;
 
 	if (!clip)
@@ -1281,12 +1548,17 @@ EAPI Eina_Bool enesim_renderer_draw(Enesim_Renderer *r, Enesim_Surface *s,
 			goto end;
 		}
 	}
+	if (enesim_renderer_profile_enabled)
+		start = enesim_renderer_profile_time_get();
 	_draw_internal(r, s, rop, &final, x, y);
+	if (start)
+		enesim_renderer_profile_add(r, ENESIM_RENDERER_PROFILE_DRAW,
+				start, 0);
 	ret = EINA_TRUE;
 
 	/* TODO set the format again */
 end:
-	enesim_renderer_cleanup(r, s);
+	_draw_cleanup(r, s, keep);
 
 	return ret;
 }
@@ -1309,6 +1581,8 @@ EAPI Eina_Bool enesim_renderer_draw_list(Enesim_Renderer *r, Enesim_Surface *s,
 {
 	Eina_Rectangle surface_size;
 	Eina_Bool ret = EINA_FALSE;
+	Eina_Bool keep;
+	uint64_t start = 0;
 
 	if (!clips)
 	{
@@ -1320,19 +1594,76 @@ EAPI Eina_Bool enesim_renderer_draw_list(Enesim_Renderer *r, Enesim_Surface *s,
 	ENESIM_MAGIC_CHECK_SURFACE(s);
 
 	/* setup the common parameters */
-	if (!enesim_renderer_setup(r, s, rop, log))
+	if (!_draw_setup(r, s, rop, &keep, log))
 		goto end;
 
 	_surface_bounds(s, &surface_size);
+	if (enesim_renderer_profile_enabled)
+		start = enesim_renderer_profile_time_get();
 	_draw_list_internal(r, s, rop, &surface_size, clips, x, y);
+	if (start)
+		enesim_renderer_profile_add(r, ENESIM_RENDERER_PROFILE_DRAW,
+				start, 0);
 	ret = EINA_TRUE;
 	/* TODO set the format again */
 end:
-	enesim_renderer_cleanup(r, s);
+	_draw_cleanup(r, s, keep);
 
 	return ret;
 }
 
+/**
+ * @brief Keep a renderer prepared between draws
+ * @param[in] r The renderer to keep prepared
+ * @param[in] keep EINA_TRUE to keep the renderer prepared, EINA_FALSE
+ * otherwise
+ *
+ * Every draw does the setup of the renderer and of all its children, and
+ * cleans it up once the draw is done. When a renderer is kept prepared and
+ * it has not changed since the last draw, the cleanup is delayed until
+ * the renderer changes or is drawn with another surface format or raster
+ * operation, so the redraws of an unchanged renderer skip the whole setup.
+ * While prepared, the children of the renderer must not be drawn on their
+ * own and the last surface drawn into is referenced. The values set on the
+ * renderer or its children are picked by the next draw, until then their
+ * getters return the values of the setup.
+ * @see enesim_renderer_prepared_release()
+ */
+EAPI void enesim_renderer_keep_prepared_set(Enesim_Renderer *r, Eina_Bool keep)
+{
+	ENESIM_MAGIC_CHECK_RENDERER(r);
+	r->keep_prepared = keep;
+	if (!keep)
+		_prepared_release(r);
+}
+
+/**
+ * @brief Check if a renderer is kept prepared between draws
+ * @param[in] r The renderer to check
+ * @return EINA_TRUE if the renderer is kept prepared, EINA_FALSE otherwise
+ * @see enesim_renderer_keep_prepared_set()
+ */
+EAPI Eina_Bool enesim_renderer_keep_prepared_get(Enesim_Renderer *r)
+{
+	ENESIM_MAGIC_CHECK_RENDERER(r);
+	return r->keep_prepared;
+}
+
+/**
+ * @brief Release the setup of a renderer kept prepared
+ * @param[in] r The renderer to release
+ *
+ * The delayed cleanup of the renderer is done, releasing the resources and
+ * the surface used for the last draw. The next draw will do the setup
+ * again.
+ * @see enesim_renderer_keep_prepared_set()
+ */
+EAPI void enesim_renderer_prepared_release(Enesim_Renderer *r)
+{
+	ENESIM_MAGIC_CHECK_RENDERER(r);
+	_prepared_release(r);
+}
+
 #if 0
 /**
  * To  be documented
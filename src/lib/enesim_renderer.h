@@ -93,6 +93,7 @@ EAPI const char * enesim_renderer_name_get(Enesim_Renderer *r);
 EAPI void enesim_renderer_transformation_set(Enesim_Renderer *r, const Enesim_Matrix *m);
 EAPI void enesim_renderer_transformation_get(Enesim_Renderer *r, Enesim_Matrix *m);
 EAPI Enesim_Matrix_Type enesim_renderer_transformation_type_get(Enesim_Renderer *r);
+EAPI Enesim_Matrix_Hint enesim_renderer_transformation_hints_get(Enesim_Renderer *r);
 EAPI void enesim_renderer_origin_set(Enesim_Renderer *r, double x, double y);
 EAPI void enesim_renderer_origin_get(Enesim_Renderer *r, double *x, double *y);
 EAPI void enesim_renderer_x_origin_set(Enesim_Renderer *r, double x);
@@ -133,9 +134,19 @@ EAPI Eina_Bool enesim_renderer_draw(Enesim_Renderer *r, Enesim_Surface *s,
 EAPI Eina_Bool enesim_renderer_draw_list(Enesim_Renderer *r, Enesim_Surface *s,
 		Enesim_Rop rop, Eina_List *clips, int x, int y, Enesim_Log **log);
 
+EAPI void enesim_renderer_keep_prepared_set(Enesim_Renderer *r, Eina_Bool keep);
+EAPI Eina_Bool enesim_renderer_keep_prepared_get(Enesim_Renderer *r);
+EAPI void enesim_renderer_prepared_release(Enesim_Renderer *r);
+
 EAPI void enesim_renderer_default_quality_set(Enesim_Quality quality);
 EAPI Eina_Bool enesim_renderer_type_get(Enesim_Renderer *r, const char **lib, char **name);
 
+EAPI void enesim_renderer_profile_set(Eina_Bool enable);
+EAPI Eina_Bool enesim_renderer_profile_get(void);
+EAPI void enesim_renderer_profile_reset(void);
+EAPI Eina_Bool enesim_renderer_profile_trace_save(const char *file);
+EAPI void enesim_renderer_profile_dump(FILE *f);
+
 /**
  * @}
  */
@@ -31,6 +31,7 @@
 #include "enesim_renderer_sw_private.h"
 #include "enesim_renderer_opencl_private.h"
 #include "enesim_renderer_opengl_private.h"
+#include "enesim_renderer_profile_private.h"
 
 Enesim_Object_Descriptor * enesim_renderer_descriptor_get(void);
 #define ENESIM_RENDERER_DESCRIPTOR enesim_renderer_descriptor_get()
@@ -48,19 +49,30 @@ Enesim_Object_Descriptor * enesim_renderer_descriptor_get(void);
 /*----------------------------------------------------------------------------*
  *                          State related functions                           *
  *----------------------------------------------------------------------------*/
+typedef struct _Enesim_Renderer_State_Values
+{
+	Enesim_Color color;
+	Enesim_Renderer *mask;
+	Enesim_Channel mchannel;
+	Eina_Bool visibility;
+	Enesim_Matrix transformation;
+	Enesim_Matrix_Type transformation_type;
+	Enesim_Matrix_Hint transformation_hints;
+	Enesim_Quality quality;
+	double ox;
+	double oy;
+} Enesim_Renderer_State_Values;
+
 typedef struct _Enesim_Renderer_State
 {
-	struct {
-		Enesim_Color color;
-		Enesim_Renderer *mask;
-		Enesim_Channel mchannel;
-		Eina_Bool visibility;
-		Enesim_Matrix transformation;
-		Enesim_Matrix_Type transformation_type;
-		Enesim_Quality quality;
-		double ox;
-		double oy;
-	} current, past;
+	/* the values picked on the setup and the ones of the last draw */
+	Enesim_Renderer_State_Values current, past;
+	/* the values set by the user, they are written without locking the
+	 * renderer and picked by the next setup
+	 */
+	Enesim_Renderer_State_Values next;
+	volatile int next_lock;
+	volatile Eina_Bool next_changed;
 	Eina_Bool changed;
 } Enesim_Renderer_State;
 
@@ -93,6 +105,12 @@ typedef Eina_Bool (*Enesim_Renderer_Sw_Setup)(Enesim_Renderer *r,
 		Enesim_Renderer_Sw_Fill *fill,
 		Enesim_Log **error);
 typedef void (*Enesim_Renderer_Sw_Cleanup)(Enesim_Renderer *r, Enesim_Surface *s);
+/* Classify the coverage of a span within the renderer bounds without
+ * drawing it. The runs must be consecutive and cover the whole span.
+ * The renderer color must be taken into account
+ */
+typedef void (*Enesim_Renderer_Sw_Runs_Get)(Enesim_Renderer *r,
+		int x, int y, int len, Enesim_Renderer_Sw_Run cb, void *data);
 /* OpenCL backend descriptor functions */
 
 typedef Eina_Bool (*Enesim_Renderer_OpenCL_Setup)(Enesim_Renderer *r,
@@ -135,6 +153,7 @@ typedef struct _Enesim_Renderer_Class
 	Enesim_Renderer_Sw_Hints_Get_Cb sw_hints_get;
 	Enesim_Renderer_Sw_Setup sw_setup;
 	Enesim_Renderer_Sw_Cleanup sw_cleanup;
+	Enesim_Renderer_Sw_Runs_Get sw_runs_get;
 	/* opencl based functions */
 	Enesim_Renderer_OpenCL_Setup opencl_setup;
 	Enesim_Renderer_OpenCL_Cleanup opencl_cleanup;
@@ -174,7 +193,22 @@ struct _Enesim_Renderer
 	 * surface or opencl surface, we need an array to keep *ALL* the
 	 * possible data */
 	void *backend_data[ENESIM_BACKEND_LAST];
+	/* the surface used on the setup in case the renderer is kept
+	 * prepared between draws
+	 */
+	Enesim_Surface *prepared_s;
+	Enesim_Format prepared_format;
+	/* the profiled values, created on its first profiled use */
+	Enesim_Renderer_Profile *profile;
+	/* the current state values are being used, from the setup until the
+	 * cleanup, even between the draws of a renderer kept prepared. It is
+	 * read by the writers on other threads, so it can not share a word
+	 * with the other flags
+	 */
+	volatile int drawing;
 	Eina_Bool in_setup : 1;
+	Eina_Bool keep_prepared : 1;
+	Eina_Bool prepared : 1;
 #if BUILD_OPENCL
 	cl_mem cl_matrix;
 #endif
@@ -0,0 +1,514 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_private.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include "enesim_main.h"
+#include "enesim_log.h"
+#include "enesim_color.h"
+#include "enesim_rectangle.h"
+#include "enesim_matrix.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+#include "enesim_format.h"
+#include "enesim_surface.h"
+#include "enesim_renderer.h"
+#include "enesim_object_descriptor.h"
+#include "enesim_object_class.h"
+#include "enesim_object_instance.h"
+
+#include "enesim_renderer_private.h"
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_LOG_DEFAULT enesim_log_renderer
+
+/* the maximum number of traced events, around 40MB */
+#define ENESIM_RENDERER_PROFILE_TRACE_MAX (1 << 20)
+/* the maximum number of different threads on a trace */
+#define ENESIM_RENDERER_PROFILE_THREADS_MAX 64
+
+struct _Enesim_Renderer_Profile
+{
+	/* NULL once the renderer is destroyed */
+	Enesim_Renderer *r;
+	/* the name of the renderer on its last setup */
+	char *name;
+	/* the counters are updated from every rendering thread, the 64 bits
+	 * atomics are not available on every 32 bits target
+	 */
+	Eina_Lock lock;
+	uint64_t time[ENESIM_RENDERER_PROFILE_EVENTS];
+	uint64_t count[ENESIM_RENDERER_PROFILE_EVENTS];
+	uint64_t pixels;
+	uint64_t hits;
+};
+
+typedef struct _Enesim_Renderer_Profile_Trace
+{
+	Enesim_Renderer_Profile *p;
+	Enesim_Renderer_Profile_Event e;
+	uint64_t start;
+	uint64_t duration;
+	int tid;
+} Enesim_Renderer_Profile_Trace;
+
+/* the profiles aggregated by name */
+typedef struct _Enesim_Renderer_Profile_Row
+{
+	const char *name;
+	uint64_t time[ENESIM_RENDERER_PROFILE_EVENTS];
+	uint64_t count[ENESIM_RENDERER_PROFILE_EVENTS];
+	uint64_t pixels;
+	uint64_t hits;
+} Enesim_Renderer_Profile_Row;
+
+static const char *_event_names[ENESIM_RENDERER_PROFILE_EVENTS] = {
+	"setup",
+	"cleanup",
+	"draw",
+	"fill",
+};
+
+static Eina_Lock _lock;
+static Eina_List *_profiles = NULL;
+static uint64_t _origin = 0;
+
+static Enesim_Renderer_Profile_Trace *_traces = NULL;
+static int _traces_count = 0;
+static int _traces_size = 0;
+static int _traces_lost = 0;
+
+static Eina_Thread _threads[ENESIM_RENDERER_PROFILE_THREADS_MAX];
+static int _threads_count = 0;
+
+/* the trace viewers expect small thread ids */
+static int _thread_id_get(void)
+{
+	Eina_Thread self;
+	int i;
+
+	self = eina_thread_self();
+	for (i = 0; i < _threads_count; i++)
+	{
+		if (eina_thread_equal(_threads[i], self))
+			return i;
+	}
+	if (_threads_count == ENESIM_RENDERER_PROFILE_THREADS_MAX)
+		return ENESIM_RENDERER_PROFILE_THREADS_MAX;
+	_threads[_threads_count] = self;
+	return _threads_count++;
+}
+
+static void _trace_add(Enesim_Renderer_Profile *p,
+		Enesim_Renderer_Profile_Event e, uint64_t start,
+		uint64_t duration)
+{
+	Enesim_Renderer_Profile_Trace *t;
+
+	if (_traces_count == _traces_size)
+	{
+		int size;
+
+		if (_traces_size == ENESIM_RENDERER_PROFILE_TRACE_MAX)
+		{
+			_traces_lost++;
+			return;
+		}
+		size = _traces_size ? _traces_size * 2 : 1024;
+		t = realloc(_traces, size * sizeof(Enesim_Renderer_Profile_Trace));
+		if (!t)
+		{
+			_traces_lost++;
+			return;
+		}
+		_traces = t;
+		_traces_size = size;
+	}
+	t = &_traces[_traces_count++];
+	t->p = p;
+	t->e = e;
+	t->start = start;
+	t->duration = duration;
+	t->tid = _thread_id_get();
+}
+
+static Enesim_Renderer_Profile * _profile_get(Enesim_Renderer *r)
+{
+	Enesim_Renderer_Profile *p;
+
+	p = r->profile;
+	if (p) return p;
+
+	/* the fills of a renderer can happen on several threads at once */
+	eina_lock_take(&_lock);
+	p = r->profile;
+	if (!p)
+	{
+		p = calloc(1, sizeof(Enesim_Renderer_Profile));
+		p->r = r;
+		p->name = strdup(r->name ? r->name : "unknown");
+		eina_lock_new(&p->lock);
+		_profiles = eina_list_append(_profiles, p);
+		r->profile = p;
+	}
+	eina_lock_release(&_lock);
+
+	return p;
+}
+
+static void _profile_clear(Enesim_Renderer_Profile *p)
+{
+	eina_lock_take(&p->lock);
+	memset(p->time, 0, sizeof(p->time));
+	memset(p->count, 0, sizeof(p->count));
+	p->pixels = 0;
+	p->hits = 0;
+	eina_lock_release(&p->lock);
+}
+
+static void _profile_free(Enesim_Renderer_Profile *p)
+{
+	eina_lock_free(&p->lock);
+	free(p->name);
+	free(p);
+}
+
+static void _traces_clear(void)
+{
+	free(_traces);
+	_traces = NULL;
+	_traces_count = 0;
+	_traces_size = 0;
+	_traces_lost = 0;
+}
+
+static void _json_string_write(FILE *f, const char *s)
+{
+	fputc('"', f);
+	for (; *s; s++)
+	{
+		unsigned char c = *s;
+
+		if (c == '"' || c == '\\')
+			fprintf(f, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(f, "\\u%04x", c);
+		else
+			fputc(c, f);
+	}
+	fputc('"', f);
+}
+
+static void _row_free(void *data)
+{
+	free(data);
+}
+
+static int _row_cmp(const void *d1, const void *d2)
+{
+	const Enesim_Renderer_Profile_Row *r1 = d1;
+	const Enesim_Renderer_Profile_Row *r2 = d2;
+	uint64_t t1 = r1->time[ENESIM_RENDERER_PROFILE_FILL];
+	uint64_t t2 = r2->time[ENESIM_RENDERER_PROFILE_FILL];
+
+	if (t1 == t2)
+		return strcmp(r1->name, r2->name);
+	return t1 > t2 ? -1 : 1;
+}
+
+static inline double _ms(uint64_t ns)
+{
+	return ns / 1000000.0;
+}
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+Eina_Bool enesim_renderer_profile_enabled = EINA_FALSE;
+
+void enesim_renderer_profile_init(void)
+{
+	eina_lock_new(&_lock);
+}
+
+void enesim_renderer_profile_shutdown(void)
+{
+	Enesim_Renderer_Profile *p;
+
+	enesim_renderer_profile_enabled = EINA_FALSE;
+	EINA_LIST_FREE(_profiles, p)
+	{
+		if (p->r)
+			p->r->profile = NULL;
+		_profile_free(p);
+	}
+	_traces_clear();
+	_threads_count = 0;
+	eina_lock_free(&_lock);
+}
+
+/* The time in nanoseconds */
+uint64_t enesim_renderer_profile_time_get(void)
+{
+#ifdef WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER count;
+
+	if (!freq.QuadPart)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (uint64_t)((double)count.QuadPart * 1000000000.0 / freq.QuadPart);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+void enesim_renderer_profile_add(Enesim_Renderer *r,
+		Enesim_Renderer_Profile_Event e, uint64_t start, int pixels)
+{
+	Enesim_Renderer_Profile *p;
+	uint64_t duration;
+
+	duration = enesim_renderer_profile_time_get() - start;
+	p = _profile_get(r);
+	eina_lock_take(&p->lock);
+	p->time[e] += duration;
+	p->count[e]++;
+	p->pixels += pixels;
+	eina_lock_release(&p->lock);
+	if (e == ENESIM_RENDERER_PROFILE_FILL)
+		return;
+
+	eina_lock_take(&_lock);
+	/* keep the name the renderer had when it was used */
+	if (e == ENESIM_RENDERER_PROFILE_SETUP && r->name &&
+			strcmp(r->name, p->name))
+	{
+		free(p->name);
+		p->name = strdup(r->name);
+	}
+	_trace_add(p, e, start, duration);
+	eina_lock_release(&_lock);
+}
+
+void enesim_renderer_profile_hit_add(Enesim_Renderer *r)
+{
+	Enesim_Renderer_Profile *p;
+
+	p = _profile_get(r);
+	eina_lock_take(&p->lock);
+	p->hits++;
+	eina_lock_release(&p->lock);
+}
+
+/* The profile is kept until the next reset, the traces still reference it */
+void enesim_renderer_profile_free(Enesim_Renderer *r)
+{
+	if (!r->profile) return;
+
+	eina_lock_take(&_lock);
+	r->profile->r = NULL;
+	r->profile = NULL;
+	eina_lock_release(&_lock);
+}
+/** @endcond */
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Enable or disable the profiling of the renderers
+ * @param[in] enable EINA_TRUE to enable the profiling, EINA_FALSE to disable it
+ *
+ * While enabled, every renderer accumulates the time spent on its setup,
+ * cleanup, draws and fills, the number of spans and pixels filled and the
+ * number of times its previous work has been reused. The setups, cleanups
+ * and draws are also traced in time. The times of a renderer include the
+ * times of the renderers it draws.
+ * @see enesim_renderer_profile_dump()
+ * @see enesim_renderer_profile_trace_save()
+ */
+EAPI void enesim_renderer_profile_set(Eina_Bool enable)
+{
+	if (enable && !_origin)
+		_origin = enesim_renderer_profile_time_get();
+	enesim_renderer_profile_enabled = enable;
+}
+
+/**
+ * @brief Check if the renderers are being profiled
+ * @return EINA_TRUE if the profiling is enabled, EINA_FALSE otherwise
+ */
+EAPI Eina_Bool enesim_renderer_profile_get(void)
+{
+	return enesim_renderer_profile_enabled;
+}
+
+/**
+ * @brief Clear every profiled value and trace
+ *
+ * This function must not be called while drawing.
+ */
+EAPI void enesim_renderer_profile_reset(void)
+{
+	Enesim_Renderer_Profile *p;
+	Eina_List *l, *l_next;
+
+	eina_lock_take(&_lock);
+	EINA_LIST_FOREACH_SAFE(_profiles, l, l_next, p)
+	{
+		if (p->r)
+		{
+			_profile_clear(p);
+			continue;
+		}
+		_profile_free(p);
+		_profiles = eina_list_remove_list(_profiles, l);
+	}
+	_traces_clear();
+	_origin = enesim_renderer_profile_time_get();
+	eina_lock_release(&_lock);
+}
+
+/**
+ * @brief Save the profiling traces of the renderers
+ * @param[in] file The path of the file to save the traces into
+ * @return EINA_TRUE if the traces were saved, EINA_FALSE otherwise
+ *
+ * The traces are saved on the Chrome trace event format, which can be
+ * loaded on chrome://tracing or any compatible viewer. Every setup, cleanup
+ * and draw is an event named as the renderer, on the thread it happened.
+ */
+EAPI Eina_Bool enesim_renderer_profile_trace_save(const char *file)
+{
+	FILE *f;
+	int i;
+
+	if (!file) return EINA_FALSE;
+	f = fopen(file, "w");
+	if (!f)
+	{
+		WRN("Can not open the file '%s'", file);
+		return EINA_FALSE;
+	}
+
+	eina_lock_take(&_lock);
+	if (_traces_lost)
+		WRN("%d events were not traced", _traces_lost);
+	fprintf(f, "{\"traceEvents\":[");
+	for (i = 0; i < _traces_count; i++)
+	{
+		Enesim_Renderer_Profile_Trace *t = &_traces[i];
+		uint64_t start;
+
+		start = t->start > _origin ? t->start - _origin : 0;
+		fprintf(f, "%s\n{\"name\":", i ? "," : "");
+		_json_string_write(f, t->p->name);
+		fprintf(f, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+				"\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+				_event_names[t->e], start / 1000.0,
+				t->duration / 1000.0, t->tid);
+	}
+	fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	eina_lock_release(&_lock);
+	fclose(f);
+
+	return EINA_TRUE;
+}
+
+/**
+ * @brief Write the profiled values of the renderers
+ * @param[in] f The file to write the values on, like stdout
+ *
+ * The values are aggregated by the name of the renderers and written as a
+ * table, sorted by the time spent on the fills.
+ * The times are in milliseconds, the spans are the number of fills and the
+ * hits are the number of draws that reused the previous work of the
+ * renderer, either because it was kept prepared or because the cached
+ * pixels were still valid.
+ * @see enesim_renderer_name_set()
+ */
+EAPI void enesim_renderer_profile_dump(FILE *f)
+{
+	Enesim_Renderer_Profile_Row *row;
+	Enesim_Renderer_Profile *p;
+	Eina_Hash *rows;
+	Eina_Iterator *it;
+	Eina_List *sorted = NULL;
+	Eina_List *l;
+
+	if (!f) return;
+
+	rows = eina_hash_string_superfast_new(_row_free);
+	eina_lock_take(&_lock);
+	EINA_LIST_FOREACH(_profiles, l, p)
+	{
+		int i;
+
+		row = eina_hash_find(rows, p->name);
+		if (!row)
+		{
+			row = calloc(1, sizeof(Enesim_Renderer_Profile_Row));
+			row->name = p->name;
+			eina_hash_add(rows, p->name, row);
+		}
+		eina_lock_take(&p->lock);
+		for (i = 0; i < ENESIM_RENDERER_PROFILE_EVENTS; i++)
+		{
+			row->time[i] += p->time[i];
+			row->count[i] += p->count[i];
+		}
+		row->pixels += p->pixels;
+		row->hits += p->hits;
+		eina_lock_release(&p->lock);
+	}
+
+	it = eina_hash_iterator_data_new(rows);
+	EINA_ITERATOR_FOREACH(it, row)
+		sorted = eina_list_sorted_insert(sorted, _row_cmp, row);
+	eina_iterator_free(it);
+
+	fprintf(f, "%-32s %8s %10s %8s %10s %8s %10s %10s %10s %12s %8s\n",
+			"renderer", "setups", "setup ms", "cleanups",
+			"cleanup ms", "draws", "draw ms", "spans", "fill ms",
+			"pixels", "hits");
+	EINA_LIST_FREE(sorted, row)
+	{
+		fprintf(f, "%-32s %8" PRIu64 " %10.3f %8" PRIu64 " %10.3f %8" PRIu64
+				" %10.3f %10" PRIu64 " %10.3f %12" PRIu64 " %8" PRIu64 "\n",
+				row->name,
+				row->count[ENESIM_RENDERER_PROFILE_SETUP],
+				_ms(row->time[ENESIM_RENDERER_PROFILE_SETUP]),
+				row->count[ENESIM_RENDERER_PROFILE_CLEANUP],
+				_ms(row->time[ENESIM_RENDERER_PROFILE_CLEANUP]),
+				row->count[ENESIM_RENDERER_PROFILE_DRAW],
+				_ms(row->time[ENESIM_RENDERER_PROFILE_DRAW]),
+				row->count[ENESIM_RENDERER_PROFILE_FILL],
+				_ms(row->time[ENESIM_RENDERER_PROFILE_FILL]),
+				row->pixels, row->hits);
+	}
+	eina_lock_release(&_lock);
+	eina_hash_free(rows);
+}
@@ -0,0 +1,47 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ENESIM_RENDERER_PROFILE_PRIVATE_H_
+#define ENESIM_RENDERER_PROFILE_PRIVATE_H_
+
+#include <stdint.h>
+
+typedef enum _Enesim_Renderer_Profile_Event
+{
+	ENESIM_RENDERER_PROFILE_SETUP,
+	ENESIM_RENDERER_PROFILE_CLEANUP,
+	ENESIM_RENDERER_PROFILE_DRAW,
+	/* the fills are only aggregated, never traced */
+	ENESIM_RENDERER_PROFILE_FILL,
+	ENESIM_RENDERER_PROFILE_EVENTS,
+} Enesim_Renderer_Profile_Event;
+
+typedef struct _Enesim_Renderer_Profile Enesim_Renderer_Profile;
+
+/* checked on the hot paths before taking any time */
+extern Eina_Bool enesim_renderer_profile_enabled;
+
+void enesim_renderer_profile_init(void);
+void enesim_renderer_profile_shutdown(void);
+
+uint64_t enesim_renderer_profile_time_get(void);
+void enesim_renderer_profile_add(Enesim_Renderer *r,
+		Enesim_Renderer_Profile_Event e, uint64_t start, int pixels);
+void enesim_renderer_profile_hit_add(Enesim_Renderer *r);
+void enesim_renderer_profile_free(Enesim_Renderer *r);
+
+#endif
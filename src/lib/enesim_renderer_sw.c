@@ -36,6 +36,7 @@
 #include "enesim_object_class.h"
 #include "enesim_object_instance.h"
 
+#include "enesim_color_private.h"
 #include "enesim_renderer_private.h"
 #include "enesim_surface_private.h"
 
@@ -73,6 +74,22 @@ static inline Eina_Bool _is_sw_draw_composed(Enesim_Color *color,
 	return EINA_TRUE;
 }
 
+/* Fill a span, accumulating the time and pixels filled when profiling */
+static inline void _sw_fill(Enesim_Renderer *r, Enesim_Renderer_Sw_Fill fill,
+		int x, int y, int len, void *dst)
+{
+	uint64_t start;
+
+	if (!enesim_renderer_profile_enabled)
+	{
+		fill(r, x, y, len, dst);
+		return;
+	}
+	start = enesim_renderer_profile_time_get();
+	fill(r, x, y, len, dst);
+	enesim_renderer_profile_add(r, ENESIM_RENDERER_PROFILE_FILL, start, len);
+}
+
 static inline void _sw_surface_setup(Enesim_Surface *s, Enesim_Format *dfmt, void **data, size_t *stride, size_t *bpp)
 {
 	Enesim_Buffer_Sw_Data *bdata;
@@ -101,36 +118,260 @@ static inline void _sw_surface_setup(Enesim_Surface *s, Enesim_Format *dfmt, voi
 /* color */
 /* rop */
 
+typedef struct _Enesim_Renderer_Sw_Mask_Run
+{
+	Enesim_Renderer *r;
+	Enesim_Renderer *mask;
+	Enesim_Renderer_Sw_Data *sw_data;
+	Enesim_Channel mchan;
+	Enesim_Color color;
+	uint32_t *ddata;
+	uint32_t *tmp;
+	uint32_t *tmp_mask;
+	int x;
+	int y;
+	/* classify again the partial runs once the mask is evaluated */
+	Eina_Bool refine;
+} Enesim_Renderer_Sw_Mask_Run;
+
+static inline Enesim_Renderer_Sw_Coverage _sw_mask_coverage(uint32_t m,
+		Enesim_Channel mchan)
+{
+	/* same as the mask compositors */
+	if (mchan == ENESIM_CHANNEL_ALPHA)
+		m |= 0x00ffffff;
+	if (m == 0xffffffff)
+		return ENESIM_RENDERER_SW_COVERAGE_FULL;
+	if (mchan == ENESIM_CHANNEL_ALPHA)
+		m &= 0xff000000;
+	if (!m)
+		return ENESIM_RENDERER_SW_COVERAGE_NONE;
+	return ENESIM_RENDERER_SW_COVERAGE_PARTIAL;
+}
+
+/* split an evaluated mask span in runs of the same coverage */
+static void _sw_mask_refine(uint32_t *m, int x, int len, Enesim_Channel mchan,
+		Enesim_Renderer_Sw_Run cb, void *data)
+{
+	int start = 0;
+	int i = 0;
+
+	while (i < len)
+	{
+		Enesim_Renderer_Sw_Coverage coverage;
+		int j;
+
+		coverage = _sw_mask_coverage(m[i], mchan);
+		if (coverage == ENESIM_RENDERER_SW_COVERAGE_PARTIAL)
+		{
+			i++;
+			continue;
+		}
+		for (j = i + 1; j < len; j++)
+		{
+			if (_sw_mask_coverage(m[j], mchan) != coverage)
+				break;
+		}
+		if (j - i >= ENESIM_RENDERER_SW_RUN_MIN)
+		{
+			if (i > start)
+				cb(x + start, i - start,
+						ENESIM_RENDERER_SW_COVERAGE_PARTIAL,
+						data);
+			cb(x + i, j - i, coverage, data);
+			start = j;
+		}
+		i = j;
+	}
+	if (len > start)
+		cb(x + start, len - start, ENESIM_RENDERER_SW_COVERAGE_PARTIAL,
+				data);
+}
+
+static void _sw_mask_run_cb(int x, int len,
+		Enesim_Renderer_Sw_Coverage coverage, void *data)
+{
+	Enesim_Renderer_Sw_Mask_Run *thiz = data;
+	Enesim_Renderer_Sw_Data *sw_data = thiz->sw_data;
+	int offset = x - thiz->x;
+
+	switch (coverage)
+	{
+		/* a mask of zero removes the pixels when filling */
+		case ENESIM_RENDERER_SW_COVERAGE_NONE:
+		if (sw_data->rop == ENESIM_ROP_FILL)
+			memset(thiz->ddata + offset, 0, len * sizeof(uint32_t));
+		break;
+
+		case ENESIM_RENDERER_SW_COVERAGE_FULL:
+		/* a classified mask is opaque but not necessarily white */
+		if (thiz->refine && thiz->mchan != ENESIM_CHANNEL_ALPHA)
+		{
+			_sw_mask_run_cb(x, len, ENESIM_RENDERER_SW_COVERAGE_PARTIAL, data);
+			break;
+		}
+		if (sw_data->span_opaque)
+		{
+			/* FIXME we should not memset this */
+			memset(thiz->tmp + offset, 0, len * sizeof(uint32_t));
+			_sw_fill(thiz->r, sw_data->fill,
+					x, thiz->y, len, thiz->tmp + offset);
+			sw_data->span_opaque(thiz->ddata + offset, len,
+					thiz->tmp + offset, thiz->color, NULL);
+			break;
+		}
+		/* the mask must be evaluated then */
+		if (!thiz->refine)
+		{
+			_sw_mask_run_cb(x, len, ENESIM_RENDERER_SW_COVERAGE_PARTIAL, data);
+			break;
+		}
+		/* fall through */
+
+		case ENESIM_RENDERER_SW_COVERAGE_PARTIAL:
+		if (thiz->refine)
+		{
+			/* FIXME we should not memset this */
+			memset(thiz->tmp_mask + offset, 0, len * sizeof(uint32_t));
+			enesim_renderer_sw_draw(thiz->mask, x, thiz->y, len,
+					thiz->tmp_mask + offset);
+			thiz->refine = EINA_FALSE;
+			_sw_mask_refine(thiz->tmp_mask + offset, x, len,
+					thiz->mchan, _sw_mask_run_cb, thiz);
+			thiz->refine = EINA_TRUE;
+			break;
+		}
+		/* FIXME we should not memset this */
+		memset(thiz->tmp + offset, 0, len * sizeof(uint32_t));
+		_sw_fill(thiz->r, sw_data->fill,
+				x, thiz->y, len, thiz->tmp + offset);
+		sw_data->span(thiz->ddata + offset, len, thiz->tmp + offset,
+				thiz->color, thiz->tmp_mask + offset);
+		break;
+	}
+}
+
+/* The mask is drawn in runs, only the parts of the span with some coverage
+ * are filled and composed
+ */
 static inline void _sw_surface_draw_rop_mask(Enesim_Renderer *r,
-		Enesim_Renderer_Sw_Fill fill,
-		Enesim_Compositor_Span span,
+		Enesim_Renderer_Sw_Data *sw_data,
 		uint8_t *ddata, size_t stride,
 		uint8_t *tmp,
 		uint8_t *tmp_mask,
-		size_t len,
 		Eina_Rectangle *area)
 {
-	Enesim_Renderer *mask;
-	Enesim_Color color;
+	Enesim_Renderer_Sw_Mask_Run run;
 
 	/* FIXME do not use this properties, use the generated properties after the _is_sw_draw_composed() */
-	mask = enesim_renderer_mask_get(r);
-	color = enesim_renderer_color_get(r);
+	run.r = r;
+	run.mask = enesim_renderer_mask_get(r);
+	run.mchan = enesim_renderer_mask_channel_get(r);
+	run.color = enesim_renderer_color_get(r);
+	run.sw_data = sw_data;
+	run.tmp = (uint32_t *)tmp;
+	run.tmp_mask = (uint32_t *)tmp_mask;
+	run.x = area->x;
+	run.refine = EINA_TRUE;
 
 	while (area->h--)
 	{
+		run.ddata = (uint32_t *)ddata;
+		run.y = area->y;
+		enesim_renderer_sw_runs_get(run.mask, area->x, area->y, area->w,
+				_sw_mask_run_cb, &run);
+		area->y++;
+		ddata += stride;
+	}
+	enesim_renderer_unref(run.mask);
+}
+
+typedef struct _Enesim_Renderer_Sw_Span_Run
+{
+	Enesim_Renderer *r;
+	Enesim_Renderer_Sw_Data *sw_data;
+	Enesim_Color color;
+	/* the rop requested, the pixels with no coverage are only touched
+	 * when filling
+	 */
+	Enesim_Rop rop;
+	uint32_t *ddata;
+	uint32_t *tmp;
+	int x;
+	int y;
+} Enesim_Renderer_Sw_Span_Run;
+
+static void _sw_span_run_cb(int x, int len,
+		Enesim_Renderer_Sw_Coverage coverage, void *data)
+{
+	Enesim_Renderer_Sw_Span_Run *thiz = data;
+	Enesim_Renderer_Sw_Data *sw_data = thiz->sw_data;
+	int offset = x - thiz->x;
+
+	switch (coverage)
+	{
+		case ENESIM_RENDERER_SW_COVERAGE_NONE:
+		if (thiz->rop == ENESIM_ROP_FILL)
+			memset(thiz->ddata + offset, 0, len * sizeof(uint32_t));
+		break;
+
+		/* blending opaque pixels is the same as filling */
+		case ENESIM_RENDERER_SW_COVERAGE_FULL:
+		if (sw_data->copy_covered)
+		{
+			_sw_fill(thiz->r, sw_data->fill,
+					x, thiz->y, len, thiz->ddata + offset);
+			break;
+		}
+		if (sw_data->span_covered)
+		{
+			_sw_fill(thiz->r, sw_data->fill,
+					x, thiz->y, len, thiz->tmp + offset);
+			sw_data->span_covered(thiz->ddata + offset, len,
+					thiz->tmp + offset, thiz->color, NULL);
+			break;
+		}
+		/* fall through */
+
+		case ENESIM_RENDERER_SW_COVERAGE_PARTIAL:
 		/* FIXME we should not memset this */
-		memset(tmp_mask, 0, len);
-		memset(tmp, 0, len);
+		memset(thiz->tmp + offset, 0, len * sizeof(uint32_t));
+		_sw_fill(thiz->r, sw_data->fill,
+				x, thiz->y, len, thiz->tmp + offset);
+		sw_data->span(thiz->ddata + offset, len, thiz->tmp + offset,
+				thiz->color, NULL);
+		break;
+	}
+}
+
+/* The renderer classifies the coverage of its spans, only the parts with
+ * some coverage are filled, and the opaque ones are not blended
+ */
+static inline void _sw_surface_draw_rop_runs(Enesim_Renderer *r,
+		Enesim_Renderer_Sw_Data *sw_data,
+		uint8_t *ddata, size_t stride,
+		uint8_t *tmp,
+		Eina_Rectangle *area)
+{
+	Enesim_Renderer_Sw_Span_Run run;
+
+	/* FIXME do not use the renderer color, use the generated color after the _is_sw_draw_composed() */
+	run.r = r;
+	run.sw_data = sw_data;
+	run.color = enesim_renderer_color_get(r);
+	run.rop = r->current_rop;
+	run.tmp = (uint32_t *)tmp;
+	run.x = area->x;
 
-		fill(r, area->x, area->y, area->w, tmp);
-		enesim_renderer_sw_draw(mask, area->x, area->y, area->w, (uint32_t *)tmp_mask);
+	while (area->h--)
+	{
+		run.ddata = (uint32_t *)ddata;
+		run.y = area->y;
+		enesim_renderer_sw_runs_get(r, area->x, area->y, area->w,
+				_sw_span_run_cb, &run);
 		area->y++;
-		/* compose the filled and the destination spans */
-		span((uint32_t *)ddata, area->w, (uint32_t *)tmp, color, (uint32_t *)tmp_mask);
 		ddata += stride;
 	}
-	enesim_renderer_unref(mask);
 }
 
 /* rop = any (~FLAG_ROP)
@@ -151,7 +392,7 @@ static inline void _sw_surface_draw_rop(Enesim_Renderer *r,
 	{
 		/* FIXME we should not memset this */
 		memset(tmp, 0, len);
-		fill(r, area->x, area->y, area->w, tmp);
+		_sw_fill(r, fill, area->x, area->y, area->w, tmp);
 		area->y++;
 		/* compose the filled and the destination spans */
 		span((uint32_t *)ddata, area->w, (uint32_t *)tmp, color, NULL);
@@ -169,7 +410,7 @@ static inline void _sw_surface_draw_simple(Enesim_Renderer *r,
 {
 	while (area->h--)
 	{
-		fill(r, area->x, area->y, area->w, ddata);
+		_sw_fill(r, fill, area->x, area->y, area->w, ddata);
 		area->y++;
 		ddata += stride;
 	}
@@ -185,92 +426,149 @@ static inline void _sw_clear(uint8_t *ddata, size_t stride, int bpp,
 		ddata += stride;
 	}
 }
-/*----------------------------------------------------------------------------*
- *                            Threaded rendering                              *
- *----------------------------------------------------------------------------*/
-#ifdef BUILD_MULTI_CORE
-static inline void _sw_surface_draw_rop_mask_threaded(Enesim_Renderer *r,
-		unsigned int thread,
-		Enesim_Renderer_Sw_Fill fill, Enesim_Compositor_Span span,
+
+/* draw a band of rows of a job, the temporary spans must be at least as
+ * wide as the area
+ */
+static inline void _sw_draw_band(Enesim_Renderer *r,
+		Enesim_Renderer_Sw_Data *sw_data,
 		uint8_t *ddata, size_t stride,
-		uint8_t *tmp, uint8_t *mtmp, size_t len, Eina_Rectangle *area)
+		uint8_t *tmp, uint8_t *mtmp,
+		Eina_Rectangle *area)
 {
-	Enesim_Color color;
-	Enesim_Renderer *mask;
-	int h = area->h;
-	int y = area->y;
-
-	/* FIXME do not use this properties, use the generated properties after the _is_sw_draw_composed() */
-	color = enesim_renderer_color_get(r);
-	mask = enesim_renderer_mask_get(r);
+	Enesim_Renderer_Class *klass;
+	size_t len;
 
-	while (h)
+	klass = ENESIM_RENDERER_CLASS_GET(r);
+	len = area->w * sizeof(uint32_t);
+	if (sw_data->span)
+	{
+		if (sw_data->use_mask)
+		{
+			_sw_surface_draw_rop_mask(r, sw_data, ddata, stride,
+					tmp, mtmp, area);
+		}
+		else if (klass->sw_runs_get)
+		{
+			_sw_surface_draw_rop_runs(r, sw_data, ddata, stride,
+					tmp, area);
+		}
+		else
+		{
+			_sw_surface_draw_rop(r, sw_data->fill, sw_data->span,
+					ddata, stride, tmp, len, area);
+		}
+	}
+	else
 	{
-		if (h % _num_cpus != thread) goto end;
+		_sw_surface_draw_simple(r, sw_data->fill, ddata, stride, area);
+	}
+}
 
-		/* FIXME we should not memset this */
-		memset(tmp, 0, len);
-		memset(mtmp, 0, len);
-		fill(r, area->x, y, area->w, tmp);
-		enesim_renderer_sw_draw(mask, area->x, y, area->w, (uint32_t *)mtmp);
-		/* compose the filled and the destination spans */
-		span((uint32_t *)ddata, area->w, (uint32_t *)tmp, color, (uint32_t *)mtmp);
-end:
-		ddata += stride;
-		h--;
-		y++;
+static inline int _sw_jobs_max_width(Enesim_Renderer_Sw_Job *jobs,
+		unsigned int njobs)
+{
+	unsigned int i;
+	int w = 0;
+
+	for (i = 0; i < njobs; i++)
+	{
+		if (jobs[i].area.w > w)
+			w = jobs[i].area.w;
 	}
-	enesim_renderer_unref(mask);
+	return w;
 }
 
-static inline void _sw_surface_draw_rop_threaded(Enesim_Renderer *r,
-		unsigned int thread,
-		Enesim_Renderer_Sw_Fill fill, Enesim_Compositor_Span span,
-		uint8_t *ddata, size_t stride,
-		uint8_t *tmp, size_t len, Eina_Rectangle *area)
+/* Get the job to draw an area of the surface. The parts of the area the
+ * renderer does not draw are cleared in case of a fill. Returns EINA_FALSE
+ * in case there is nothing to draw
+ */
+static Eina_Bool _sw_job_get(Enesim_Renderer *r, Enesim_Rop rop,
+		uint8_t *ddata, size_t stride, size_t bpp,
+		Eina_Rectangle *area, int x, int y,
+		Enesim_Renderer_Sw_Job *job)
 {
+	Enesim_Renderer *mask;
 	Enesim_Color color;
-	int h = area->h;
-	int y = area->y;
+	Eina_Rectangle final;
+	Eina_Bool visible;
+	Eina_Bool intersect;
 
-	/* FIXME do not use the renderer color, use the generated color after the _is_sw_draw_composed() */
+	/* TODO in case of a mask, first intersect the mask bounds with the
+	 * renderer bounds, if they do not intersect return
+	 */
 	color = enesim_renderer_color_get(r);
-	while (h)
+	if (!color)
 	{
-		if (h % _num_cpus != thread) goto end;
-
-		/* FIXME we should not memset this */
-		memset(tmp, 0, len);
-		fill(r, area->x, y, area->w, tmp);
-		/* compose the filled and the destination spans */
-		span((uint32_t *)ddata, area->w, (uint32_t *)tmp, color, NULL);
-end:
-		ddata += stride;
-		h--;
-		y++;
+		if (r->current_rop == ENESIM_ROP_FILL)
+		{
+			_sw_clear(ddata, stride, bpp, area);
+		}
+		return EINA_FALSE;
 	}
-}
 
-static inline void _sw_surface_draw_simple_threaded(Enesim_Renderer *r,
-		unsigned int thread,
-		Enesim_Renderer_Sw_Fill fill, uint8_t *ddata,
-		size_t stride, Eina_Rectangle *area)
-{
-	int h = area->h;
-	int y = area->y;
+	/* be sure to clip the area to the renderer bounds */
+	final = r->current_destination_bounds;
+	/* in case of a mask, clip it against the mask bounds */
+	mask = enesim_renderer_mask_get(r);
+	if (mask)
+	{
+		if (!eina_rectangle_intersection(&final, &mask->current_destination_bounds))
+			eina_rectangle_coords_from(&final, 0, 0, 0, 0);
+		enesim_renderer_unref(mask);
+	}
+	/* final translation */
+	final.x += x;
+	final.y += y;
 
-	while (h)
+	intersect = eina_rectangle_intersection(&final, area);
+	/* when filling be sure to clear the area that we dont draw */
+	if (rop == ENESIM_ROP_FILL)
 	{
-		if (h % _num_cpus != thread) goto end;
+		/* just memset the whole area */
+		if (!intersect)
+		{
+			_sw_clear(ddata, stride, bpp, area);
+			return EINA_FALSE;
+		}
+		/* clear the difference rectangle */
+		else
+		{
+			Eina_Rectangle subs[4];
+			int i;
 
-		fill(r, area->x, y, area->w, ddata);
-end:
-		ddata += stride;
-		h--;
-		y++;
+			eina_rectangle_subtract(area, &final, subs);
+			for (i = 0; i < 4; i++)
+			{
+				if (!eina_rectangle_is_valid(&subs[i]))
+					continue;
+				_sw_clear(ddata, stride, bpp, &subs[i]);
+			}
+		}
 	}
-}
 
+	visible = enesim_renderer_visibility_get(r);
+	if (!visible)
+		return EINA_FALSE;
+	if (!intersect || !eina_rectangle_is_valid(&final))
+		return EINA_FALSE;
+
+	job->clip = *area;
+	job->dst = ddata + (final.y * stride) + (final.x * bpp);
+	/* we know have the final area on surface coordinates
+	 * add again the offset because the draw functions use
+	 * the area on the renderer coordinate space
+	 */
+	final.x -= x;
+	final.y -= y;
+	job->area = final;
+
+	return EINA_TRUE;
+}
+/*----------------------------------------------------------------------------*
+ *                            Threaded rendering                              *
+ *----------------------------------------------------------------------------*/
+#ifdef BUILD_MULTI_CORE
 #ifdef _WIN32
 static DWORD WINAPI _thread_run(void *data)
 #else
@@ -283,65 +581,61 @@ static void * _thread_run(void *data)
 
 	do
 	{
+		uint8_t *tmp = NULL;
+		uint8_t *mtmp = NULL;
+		unsigned int i;
+
 		enesim_barrier_wait(&sw_data->start);
 		if (thiz->done) goto end;
 
 		if (sw_data->span)
 		{
-			uint8_t *tmp;
 			size_t len;
 
-			len = op->area.w * sizeof(uint32_t);
-			/* FIXME remove this malloc. or we either
-			 * make the tmp buffer part of the renderer
-			 * and make it grow until we reach the span len
-			 * or alloca everytime
-			 */
+			/* one temporary span for every job of the operation */
+			len = op->max_w * sizeof(uint32_t);
 			tmp = malloc(len);
 			if (sw_data->use_mask)
-			{
-				uint8_t *mtmp;
-				/* FIXME remove this malloc. or we either
-				 * make the tmp buffer part of the renderer
-				 * and make it grow until we reach the span len
-				 * or alloca everytime
-				 */
 				mtmp = malloc(len);
-				_sw_surface_draw_rop_mask_threaded(op->renderer,
-						thiz->cpuidx,
-						sw_data->fill,
-						sw_data->span,
-						op->dst,
-						op->stride,
-						tmp,
-						mtmp,
-						len,
-						&op->area);
-				free(mtmp);
-			}
-			else
-			{
-				_sw_surface_draw_rop_threaded(op->renderer,
-						thiz->cpuidx,
-						sw_data->fill,
-						sw_data->span,
-						op->dst,
-						op->stride,
-						tmp,
-						len,
-						&op->area);
-			}
-			free(tmp);
 		}
-		else
+		/* every job is split in bands of rows, the bands of all the jobs
+		 * are distributed between the threads. A row always goes to
+		 * the same thread, no matter the job it comes from, so the
+		 * renderers can keep per thread data indexed by the band
+		 */
+		for (i = 0; i < op->njobs; i++)
 		{
-			_sw_surface_draw_simple_threaded(op->renderer,
-					thiz->cpuidx,
-					sw_data->fill,
-					op->dst,
-					op->stride,
-					&op->area);
+			Enesim_Renderer_Sw_Job *job = &op->jobs[i];
+			int y = job->area.y;
+			int end = job->area.y + job->area.h;
+
+			while (y < end)
+			{
+				Eina_Rectangle area;
+				int band;
+				int next;
+
+				band = enesim_renderer_sw_band_get(y);
+				next = (band + 1) * ENESIM_RENDERER_SW_BAND_ROWS;
+				if (next > end)
+					next = end;
+				band %= (int)_num_cpus;
+				if (band < 0)
+					band += _num_cpus;
+				if (band == thiz->cpuidx)
+				{
+					area = job->area;
+					area.y = y;
+					area.h = next - y;
+					_sw_draw_band(op->renderer, sw_data,
+							job->dst + ((y - job->area.y) * op->stride),
+							op->stride, tmp, mtmp, &area);
+				}
+				y = next;
+			}
 		}
+		free(mtmp);
+		free(tmp);
 		enesim_barrier_wait(&sw_data->end);
 	} while (1);
 
@@ -353,20 +647,44 @@ end:
 #endif
 }
 
-static void _sw_draw_threaded(Enesim_Renderer *r, Eina_Rectangle *area,
-		uint8_t *ddata, size_t stride,
-		Enesim_Format dfmt EINA_UNUSED)
+static void _sw_threads_new(Enesim_Renderer_Sw_Data *sw_data)
+{
+	unsigned int i;
+
+	sw_data->threads = malloc(sizeof(Enesim_Renderer_Thread) * _num_cpus);
+
+	enesim_barrier_new(&sw_data->start, _num_cpus + 1);
+	enesim_barrier_new(&sw_data->end, _num_cpus + 1);
+	for (i = 0; i < _num_cpus; i++)
+	{
+		sw_data->threads[i].cpuidx = i;
+		sw_data->threads[i].done = EINA_FALSE;
+		sw_data->threads[i].sw_data = sw_data;
+		enesim_thread_new(&sw_data->threads[i].tid, _thread_run, (void *)&sw_data->threads[i]);
+		enesim_thread_affinity_set(sw_data->threads[i].tid, i);
+	}
+}
+
+/* dispatch all the jobs to the threads in a single pass */
+static void _sw_draw_jobs(Enesim_Renderer *r, Enesim_Renderer_Sw_Job *jobs,
+		unsigned int njobs, size_t stride)
 {
 	Enesim_Renderer_Sw_Data *sw_data;
 	Enesim_Renderer_Thread_Operation *op;
 
+	if (!njobs) return;
+
 	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
+	/* create the threads in case those are not created yet */
+	if (!sw_data->threads)
+		_sw_threads_new(sw_data);
 	op = &sw_data->op;
 	/* fill the data needed for every threaded renderer */
 	op->renderer = r;
-	op->dst = ddata;
+	op->jobs = jobs;
+	op->njobs = njobs;
 	op->stride = stride;
-	op->area = *area;
+	op->max_w = _sw_jobs_max_width(jobs, njobs);
 
 	enesim_barrier_wait(&sw_data->start);
 	enesim_barrier_wait(&sw_data->end);
@@ -375,38 +693,32 @@ static void _sw_draw_threaded(Enesim_Renderer *r, Eina_Rectangle *area,
 /*----------------------------------------------------------------------------*
  *                          No threaded rendering                             *
  *----------------------------------------------------------------------------*/
-static void _sw_draw_no_threaded(Enesim_Renderer *r,
-		Eina_Rectangle *area,
-		uint8_t *ddata, size_t stride,
-		Enesim_Format dfmt EINA_UNUSED)
+static void _sw_draw_jobs(Enesim_Renderer *r, Enesim_Renderer_Sw_Job *jobs,
+		unsigned int njobs, size_t stride)
 {
 	Enesim_Renderer_Sw_Data *sw_data;
+	uint8_t *fdata = NULL;
+	uint8_t *mdata = NULL;
+	unsigned int i;
+
+	if (!njobs) return;
 
 	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
 	if (sw_data->span)
 	{
-		uint8_t *fdata;
 		size_t len;
 
-		len = area->w * sizeof(uint32_t);
+		len = _sw_jobs_max_width(jobs, njobs) * sizeof(uint32_t);
 		fdata = alloca(len);
 		if (sw_data->use_mask)
-		{
-			uint8_t *mdata;
 			mdata = alloca(len);
-
-			_sw_surface_draw_rop_mask(r, sw_data->fill, sw_data->span,
-					ddata, stride, fdata, mdata, len, area);
-		}
-		else
-		{
-			_sw_surface_draw_rop(r, sw_data->fill, sw_data->span,
-					ddata, stride, fdata, len, area);
-		}
 	}
-	else
+	for (i = 0; i < njobs; i++)
 	{
-		_sw_surface_draw_simple(r, sw_data->fill, ddata, stride, area);
+		Eina_Rectangle area = jobs[i].area;
+
+		_sw_draw_band(r, sw_data, jobs[i].dst, stride, fdata, mdata,
+				&area);
 	}
 }
 #endif
@@ -441,113 +753,75 @@ void enesim_renderer_sw_hints_get(Enesim_Renderer *r, Enesim_Rop rop, Enesim_Ren
 void enesim_renderer_sw_draw_area(Enesim_Renderer *r, Enesim_Surface *s,
 		Enesim_Rop rop, Eina_Rectangle *area, int x, int y)
 {
-	Enesim_Renderer *mask;
-	Enesim_Color color;
+	Enesim_Renderer_Sw_Job job;
 	Enesim_Format dfmt;
-	Eina_Rectangle final;
-	Eina_Bool visible;
-	Eina_Bool intersect;
 	uint8_t *ddata;
 	size_t stride;
 	size_t bpp;
-#ifdef BUILD_MULTI_CORE
-	Enesim_Renderer_Sw_Data *sw_data;
-#endif
-
-	/* TODO in case of a mask, first intersect the mask bounds with the
-	 * renderer bounds, if they do not intersect return
-	 */
 
 	/* get the destination pointer */
 	_sw_surface_setup(s, &dfmt, (void **)&ddata, &stride, &bpp);
-
-	color = enesim_renderer_color_get(r);
-	if (!color)
-	{
-		if (r->current_rop == ENESIM_ROP_FILL)
-		{
-			_sw_clear(ddata, stride, bpp, area);
-		}
+	if (!_sw_job_get(r, rop, ddata, stride, bpp, area, x, y, &job))
 		return;
-	}
+	_sw_draw_jobs(r, &job, 1, stride);
+}
 
-	/* be sure to clip the area to the renderer bounds */
-	final = r->current_destination_bounds;
-	/* in case of a mask, clip it against the mask bounds */
-	mask = enesim_renderer_mask_get(r);
-	if (mask)
-	{
-		if (!eina_rectangle_intersection(&final, &mask->current_destination_bounds))
-			eina_rectangle_coords_from(&final, 0, 0, 0, 0);
-		enesim_renderer_unref(mask);
-	}
-	/* final translation */
-	final.x += x;
-	final.y += y;
+/* Draw every clip of the list intersected with the area. The jobs are
+ * dispatched together, only the clips that overlap a pending one need
+ * another pass to keep the drawing order
+ */
+void enesim_renderer_sw_draw_list(Enesim_Renderer *r, Enesim_Surface *s,
+		Enesim_Rop rop, Eina_Rectangle *area, Eina_List *clips,
+		int x, int y)
+{
+	Enesim_Renderer_Sw_Job *jobs;
+	Enesim_Format dfmt;
+	Eina_Rectangle *clip;
+	Eina_List *l;
+	unsigned int njobs = 0;
+	uint8_t *ddata;
+	size_t stride;
+	size_t bpp;
 
-	intersect = eina_rectangle_intersection(&final, area);
-	/* when filling be sure to clear the area that we dont draw */
-	if (rop == ENESIM_ROP_FILL)
+	jobs = malloc(sizeof(Enesim_Renderer_Sw_Job) * eina_list_count(clips));
+	if (!jobs)
 	{
-		/* just memset the whole area */
-		if (!intersect)
+		EINA_LIST_FOREACH(clips, l, clip)
 		{
-			_sw_clear(ddata, stride, bpp, area);
-			return;
-		}
-		/* clear the difference rectangle */
-		else
-		{
-			Eina_Rectangle subs[4];
-			int i;
+			Eina_Rectangle final;
 
-			eina_rectangle_subtract(area, &final, subs);
-			for (i = 0; i < 4; i++)
-			{
-				if (!eina_rectangle_is_valid(&subs[i]))
-					continue;
-				_sw_clear(ddata, stride, bpp, &subs[i]);
-			}
+			final = *clip;
+			if (!eina_rectangle_intersection(&final, area))
+				continue;
+			enesim_renderer_sw_draw_area(r, s, rop, &final, x, y);
 		}
-	}
-
-	visible = enesim_renderer_visibility_get(r);
-	if (!visible)
-		return;
-	if (!intersect || !eina_rectangle_is_valid(&final))
 		return;
+	}
 
-	ddata = ddata + (final.y * stride) + (final.x * bpp);
-	/* we know have the final area on surface coordinates
-	 * add again the offset because the draw functions use
-	 * the area on the renderer coordinate space
-	 */
-	final.x -= x;
-	final.y -= y;
-#ifdef BUILD_MULTI_CORE
-	/* create the threads in case those are not created yet */
-	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
-	if (!sw_data->threads)
+	_sw_surface_setup(s, &dfmt, (void **)&ddata, &stride, &bpp);
+	EINA_LIST_FOREACH(clips, l, clip)
 	{
+		Eina_Rectangle final;
 		unsigned int i;
 
-		sw_data->threads = malloc(sizeof(Enesim_Renderer_Thread) * _num_cpus);
-
-		enesim_barrier_new(&sw_data->start, _num_cpus + 1);
-		enesim_barrier_new(&sw_data->end, _num_cpus + 1);
-		for (i = 0; i < _num_cpus; i++)
+		final = *clip;
+		if (!eina_rectangle_intersection(&final, area))
+			continue;
+		for (i = 0; i < njobs; i++)
 		{
-			sw_data->threads[i].cpuidx = i;
-			sw_data->threads[i].done = EINA_FALSE;
-			sw_data->threads[i].sw_data = sw_data;
-			enesim_thread_new(&sw_data->threads[i].tid, _thread_run, (void *)&sw_data->threads[i]);
-			enesim_thread_affinity_set(sw_data->threads[i].tid, i);
+			if (eina_rectangles_intersect(&jobs[i].clip, &final))
+				break;
 		}
+		if (i < njobs)
+		{
+			_sw_draw_jobs(r, jobs, njobs, stride);
+			njobs = 0;
+		}
+		if (_sw_job_get(r, rop, ddata, stride, bpp, &final, x, y, &jobs[njobs]))
+			njobs++;
 	}
-	_sw_draw_threaded(r, &final, ddata, stride, dfmt);
-#else
-	_sw_draw_no_threaded(r, &final, ddata, stride, dfmt);
-#endif
+	_sw_draw_jobs(r, jobs, njobs, stride);
+	free(jobs);
 }
 
 Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r,
@@ -556,11 +830,14 @@ Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r,
 	Enesim_Renderer_Class *klass;
 	Enesim_Renderer_Sw_Fill fill = NULL;
 	Enesim_Compositor_Span span = NULL;
+	Enesim_Compositor_Span span_opaque = NULL;
+	Enesim_Compositor_Span span_covered = NULL;
 	Enesim_Renderer_Sw_Data *sw_data;
 	Enesim_Renderer_Sw_Hint hints;
 	Enesim_Renderer *mask;
 	Enesim_Color color;
 	Eina_Bool use_mask = EINA_FALSE;
+	Eina_Bool copy_covered = EINA_FALSE;
 
 	/* First the setup on the renderer itself */
 	klass = ENESIM_RENDERER_CLASS_GET(r);
@@ -628,10 +905,45 @@ Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r,
 			enesim_renderer_unref(mask);
 			return EINA_FALSE;
 		}
+		/* where the mask is fully opaque compose as the mask span
+		 * does, without the color
+		 */
+		if (mask)
+		{
+			dfmt = enesim_surface_format_get(s);
+			span_opaque = enesim_compositor_span_get(rop, &dfmt,
+					ENESIM_FORMAT_ARGB8888,
+					ENESIM_COLOR_FULL,
+					ENESIM_FORMAT_NONE, mchan);
+		}
+		/* where the fill is fully opaque blending is the same as
+		 * filling, even directly on the destination without color
+		 */
+		else if (rop == ENESIM_ROP_BLEND &&
+				enesim_color_alpha_get(color) == 0xff)
+		{
+			dfmt = enesim_surface_format_get(s);
+			if (color == ENESIM_COLOR_FULL &&
+					dfmt == ENESIM_FORMAT_ARGB8888)
+			{
+				copy_covered = EINA_TRUE;
+			}
+			else
+			{
+				span_covered = enesim_compositor_span_get(
+						ENESIM_ROP_FILL, &dfmt,
+						ENESIM_FORMAT_ARGB8888, color,
+						ENESIM_FORMAT_NONE, mchan);
+			}
+		}
 	}
 
 	/* TODO add a real_draw function that will compose the two ... or not :) */
 	sw_data->span = span;
+	sw_data->span_opaque = span_opaque;
+	sw_data->span_covered = span_covered;
+	sw_data->copy_covered = copy_covered;
+	sw_data->rop = rop;
 	sw_data->fill = fill;
 	sw_data->use_mask = use_mask;
 	enesim_renderer_unref(mask);
@@ -658,6 +970,30 @@ void enesim_renderer_sw_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
 	}
 }
 
+/* Draw a renderer already setup by another one into an offscreen surface,
+ * like the surface of a draw cache. The jobs are dispatched to the threads
+ * of the renderer from the setup of the other one, instead of drawing them
+ * span by span from its fill functions. Must not be called from a fill
+ * function, the threads of the renderer can only run one operation
+ */
+void enesim_renderer_sw_draw_offscreen(Enesim_Renderer *r, Enesim_Surface *s,
+		Eina_List *clips, int x, int y)
+{
+	Eina_Rectangle area;
+
+	area.x = 0;
+	area.y = 0;
+	enesim_surface_size_get(s, &area.w, &area.h);
+
+	enesim_surface_lock(s, EINA_TRUE);
+	if (clips)
+		enesim_renderer_sw_draw_list(r, s, r->current_rop, &area, clips,
+				x, y);
+	else
+		enesim_renderer_sw_draw_area(r, s, r->current_rop, &area, x, y);
+	enesim_surface_unlock(s);
+}
+
 void enesim_renderer_sw_free(Enesim_Renderer *r)
 {
 
@@ -760,16 +1096,37 @@ mask_done:
 
 	if (sw_data->span)
 	{
+		Enesim_Renderer_Class *klass;
 		uint32_t *tmp;
 		size_t bytes;
 
 		bytes = rbounds.w * sizeof(uint32_t);
 		tmp = alloca(bytes);
 
+		/* only fill and compose the parts with some coverage */
+		klass = ENESIM_RENDERER_CLASS_GET(r);
+		if (!sw_data->use_mask && klass->sw_runs_get)
+		{
+			Enesim_Renderer_Sw_Span_Run run;
+
+			run.r = r;
+			run.sw_data = sw_data;
+			run.color = color;
+			run.rop = r->current_rop;
+			run.ddata = data + left;
+			run.tmp = tmp;
+			run.x = rbounds.x;
+			run.y = rbounds.y;
+			klass->sw_runs_get(r, rbounds.x, rbounds.y, rbounds.w,
+					_sw_span_run_cb, &run);
+			goto span_done;
+		}
+
 		/* We dont need to zero the buffer given that a fill will
 		 * draw every pixel in case the span is inside the bounds
 		 */
-		sw_data->fill(r, rbounds.x, rbounds.y, rbounds.w, tmp);
+		_sw_fill(r, sw_data->fill,
+				rbounds.x, rbounds.y, rbounds.w, tmp);
 		/* compose the filled and the destination spans */
 		if (sw_data->use_mask)
 		{
@@ -787,9 +1144,10 @@ mask_done:
 	}
 	else
 	{
-		sw_data->fill(r, rbounds.x, rbounds.y, rbounds.w, data + left);
+		_sw_fill(r, sw_data->fill,
+				rbounds.x, rbounds.y, rbounds.w, data + left);
 	}
-
+span_done:
 	if (r->current_rop == ENESIM_ROP_FILL)
 	{
 		unsigned int right;
@@ -803,6 +1161,46 @@ mask_done:
 	}
 }
 
+/* Classify the coverage of a span of a renderer already setup. The parts
+ * outside the renderer bounds have no coverage, the rest is classified by
+ * the renderer itself or evaluated when drawn
+ */
+void enesim_renderer_sw_runs_get(Enesim_Renderer *r, int x, int y, int len,
+		Enesim_Renderer_Sw_Run cb, void *data)
+{
+	Enesim_Renderer_Class *klass;
+	Eina_Rectangle span;
+	Eina_Rectangle rbounds;
+	int right;
+
+	if (len <= 0) return;
+	if (!enesim_renderer_visibility_get(r) || !enesim_renderer_color_get(r))
+	{
+		cb(x, len, ENESIM_RENDERER_SW_COVERAGE_NONE, data);
+		return;
+	}
+
+	eina_rectangle_coords_from(&span, x, y, len, 1);
+	rbounds = r->current_destination_bounds;
+	if (!eina_rectangle_intersection(&rbounds, &span))
+	{
+		cb(x, len, ENESIM_RENDERER_SW_COVERAGE_NONE, data);
+		return;
+	}
+
+	if (rbounds.x > x)
+		cb(x, rbounds.x - x, ENESIM_RENDERER_SW_COVERAGE_NONE, data);
+	klass = ENESIM_RENDERER_CLASS_GET(r);
+	if (klass->sw_runs_get)
+		klass->sw_runs_get(r, rbounds.x, y, rbounds.w, cb, data);
+	else
+		cb(rbounds.x, rbounds.w, ENESIM_RENDERER_SW_COVERAGE_PARTIAL, data);
+	right = (x + len) - (rbounds.x + rbounds.w);
+	if (right > 0)
+		cb(rbounds.x + rbounds.w, right, ENESIM_RENDERER_SW_COVERAGE_NONE,
+				data);
+}
+
 unsigned int enesim_renderer_sw_cpu_count(void)
 {
 #ifdef BUILD_MULTI_CORE
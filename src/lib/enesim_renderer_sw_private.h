@@ -35,14 +35,63 @@ typedef void (*Enesim_Renderer_Sw_Fill)(Enesim_Renderer *r,
 		int x, int y, int len, void *dst);
 typedef struct _Enesim_Renderer_Sw_Data Enesim_Renderer_Sw_Data;
 
+/* The coverage of a run of pixels */
+typedef enum _Enesim_Renderer_Sw_Coverage
+{
+	ENESIM_RENDERER_SW_COVERAGE_NONE, /* Nothing is drawn */
+	ENESIM_RENDERER_SW_COVERAGE_FULL, /* Every pixel is opaque */
+	ENESIM_RENDERER_SW_COVERAGE_PARTIAL, /* The pixels must be evaluated */
+} Enesim_Renderer_Sw_Coverage;
+
+/**
+ * The function called for every run of a span with the same coverage
+ * @param x The x coordinate of the run
+ * @param len The length of the run
+ * @param coverage The coverage of the run
+ * @param data The user provided data
+ */
+typedef void (*Enesim_Renderer_Sw_Run)(int x, int len,
+		Enesim_Renderer_Sw_Coverage coverage, void *data);
+
+/* the minimum length of a run with no coverage or full coverage found on
+ * an evaluated or classified span, shorter runs are merged into a partial
+ * one
+ */
+#define ENESIM_RENDERER_SW_RUN_MIN 16
+
+/* the number of rows every thread draws at once */
+#define ENESIM_RENDERER_SW_BAND_ROWS 8
+
+/* The band a row belongs to. The bands are aligned on the renderer
+ * coordinate space, so every row is always drawn by the same thread
+ */
+static inline int enesim_renderer_sw_band_get(int y)
+{
+	if (y < 0)
+		return ((y + 1) / ENESIM_RENDERER_SW_BAND_ROWS) - 1;
+	return y / ENESIM_RENDERER_SW_BAND_ROWS;
+}
+
+typedef struct _Enesim_Renderer_Sw_Job
+{
+	/* the clip on the surface this job comes from */
+	Eina_Rectangle clip;
+	/* the area to draw, on the renderer coordinate space */
+	Eina_Rectangle area;
+	/* the destination pointer at the area origin */
+	uint8_t *dst;
+} Enesim_Renderer_Sw_Job;
+
 #if BUILD_THREAD
 typedef struct _Enesim_Renderer_Thread_Operation
 {
 	/* common attributes */
 	Enesim_Renderer *renderer;
-	uint8_t * dst;
 	size_t stride;
-	Eina_Rectangle area;
+	/* the jobs to draw on a single pass */
+	Enesim_Renderer_Sw_Job *jobs;
+	unsigned int njobs;
+	int max_w;
 } Enesim_Renderer_Thread_Operation;
 
 typedef struct _Enesim_Renderer_Thread
@@ -75,15 +124,30 @@ struct _Enesim_Renderer_Sw_Data
 	 */
 	Enesim_Renderer_Sw_Fill fill;
 	Enesim_Compositor_Span span;
+	/* the span to use where the mask is fully opaque */
+	Enesim_Compositor_Span span_opaque;
+	/* the span to use where the fill is fully opaque */
+	Enesim_Compositor_Span span_covered;
+	/* the fully opaque fill can be drawn directly on the destination */
+	Eina_Bool copy_covered;
+	/* the rop the span composes with */
+	Enesim_Rop rop;
 	Eina_Bool use_mask;
 };
 
 void enesim_renderer_sw_hints_get(Enesim_Renderer *r, Enesim_Rop rop, Enesim_Renderer_Sw_Hint *hints);
 void enesim_renderer_sw_draw(Enesim_Renderer *r, int x, int y, int len, uint32_t *data);
+void enesim_renderer_sw_runs_get(Enesim_Renderer *r, int x, int y, int len,
+		Enesim_Renderer_Sw_Run cb, void *data);
 void enesim_renderer_sw_init(void);
 void enesim_renderer_sw_shutdown(void);
 void enesim_renderer_sw_draw_area(Enesim_Renderer *r, Enesim_Surface *s,
 		Enesim_Rop rop, Eina_Rectangle *area, int x, int y);
+void enesim_renderer_sw_draw_list(Enesim_Renderer *r, Enesim_Surface *s,
+		Enesim_Rop rop, Eina_Rectangle *area, Eina_List *clips,
+		int x, int y);
+void enesim_renderer_sw_draw_offscreen(Enesim_Renderer *r, Enesim_Surface *s,
+		Eina_List *clips, int x, int y);
 void enesim_renderer_sw_free(Enesim_Renderer *r);
 
 Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r, Enesim_Surface *s, Enesim_Rop rop, Enesim_Log **error);
@@ -39,21 +39,11 @@
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
-#if 0
-void enesim_text_cache_glyph_add(Enesim_Text_Glyph)
-{
-
-}
-
-void enesim_text_cache_clear()
-{
-
-}
-
-#endif
-
 void enesim_text_init(void)
 {
+	enesim_text_font_init();
+	enesim_text_glyph_init();
+	enesim_text_glyph_cache_init();
 	enesim_text_engine_freetype_init();
 #ifdef HAVE_FONTCONFIG
 	FcInit();
@@ -66,6 +56,9 @@ void enesim_text_shutdown(void)
 	FcFini();
 #endif
 	enesim_text_engine_freetype_shutdown();
+	enesim_text_glyph_cache_shutdown();
+	enesim_text_glyph_shutdown();
+	enesim_text_font_shutdown();
 }
 /** @endcond */
 /*============================================================================*
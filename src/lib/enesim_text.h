@@ -25,6 +25,7 @@
  * @ender_group{Enesim_Text_Engine}
  * @ender_group{Enesim_Text_Engine_Freetype}
  * @ender_group{Enesim_Text_Font}
+ * @ender_group{Enesim_Text_Glyph_Cache}
  * @ender_group{Enesim_Text_Buffer}
  * @ender_group{Enesim_Text_Buffer_Ansi}
  * @ender_group{Enesim_Text_Buffer_Utf8}
@@ -92,6 +93,47 @@ EAPI void enesim_text_font_unref(Enesim_Text_Font *thiz);
 EAPI int enesim_text_font_max_ascent_get(Enesim_Text_Font *thiz);
 EAPI int enesim_text_font_max_descent_get(Enesim_Text_Font *thiz);
 
+/**
+ * A range of codepoints
+ */
+typedef struct _Enesim_Text_Font_Range
+{
+	Eina_Unicode first; /**< The first codepoint of the range */
+	Eina_Unicode last; /**< The last codepoint of the range, inclusive */
+} Enesim_Text_Font_Range;
+
+typedef struct _Enesim_Text_Font_Preload Enesim_Text_Font_Preload;
+
+EAPI Enesim_Text_Font_Preload * enesim_text_font_preload(Enesim_Text_Font *thiz,
+		const Enesim_Text_Font_Range *ranges, unsigned int count);
+EAPI Eina_Bool enesim_text_font_preload_is_done(Enesim_Text_Font_Preload *thiz);
+EAPI void enesim_text_font_preload_wait(Enesim_Text_Font_Preload *thiz);
+EAPI void enesim_text_font_preload_free(Enesim_Text_Font_Preload *thiz);
+
+/**
+ * @}
+ * @defgroup Enesim_Text_Glyph_Cache Glyph Cache
+ * @brief Shared cache of the rasterized glyphs of every font
+ * @ingroup Enesim_Text
+ * @{
+ */
+
+typedef struct _Enesim_Text_Glyph_Cache_Stats
+{
+	size_t budget; /**< The maximum number of bytes to use */
+	size_t bytes; /**< The number of bytes used by the cached glyphs */
+	unsigned int glyphs; /**< The number of cached glyphs */
+	unsigned int slabs; /**< The number of slabs for small glyphs */
+	unsigned int hits; /**< The number of lookups found on the cache */
+	unsigned int misses; /**< The number of lookups not found on the cache */
+	unsigned int evictions; /**< The number of glyphs evicted */
+} Enesim_Text_Glyph_Cache_Stats;
+
+EAPI void enesim_text_glyph_cache_budget_set(size_t bytes);
+EAPI size_t enesim_text_glyph_cache_budget_get(void);
+EAPI void enesim_text_glyph_cache_stats_get(Enesim_Text_Glyph_Cache_Stats *stats);
+EAPI void enesim_text_glyph_cache_flush(void);
+
 /**
  * @}
  * @defgroup Enesim_Text_Buffer Buffer
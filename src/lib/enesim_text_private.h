@@ -64,6 +64,10 @@ typedef struct _Enesim_Text_Buffer_Descriptor
 Enesim_Text_Buffer * enesim_text_buffer_new_from_descriptor(Enesim_Text_Buffer_Descriptor *descriptor, void *data);
 void * enesim_text_buffer_data_get(Enesim_Text_Buffer *thiz);
 
+/* smart buffer */
+Eina_Bool enesim_text_buffer_smart_dirty_range_get(Enesim_Text_Buffer *b,
+		int *start, int *tail);
+
 void enesim_text_init(void);
 void enesim_text_shutdown(void);
 
@@ -1,5 +1,6 @@
 
 src_lib_libenesim_la_SOURCES += \
+src/lib/image/enesim_image_cache.c \
 src/lib/image/enesim_image_context.c \
 src/lib/image/enesim_image_file.c \
 src/lib/image/enesim_image_provider.c
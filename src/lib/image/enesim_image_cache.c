@@ -0,0 +1,462 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_private.h"
+
+#include "enesim_main.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+#include "enesim_format.h"
+#include "enesim_surface.h"
+#include "enesim_stream.h"
+#include "enesim_image.h"
+#include "enesim_image_private.h"
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_LOG_DEFAULT enesim_log_image
+
+/* default budget of decoded pixels */
+#define ENESIM_IMAGE_CACHE_SIZE (32 * 1024 * 1024)
+#define ENESIM_IMAGE_CACHE_FILE_URI "file://"
+
+typedef struct _Enesim_Image_Cache_Entry
+{
+	EINA_INLIST;
+	char *key;
+	Enesim_Buffer *buffer;
+	size_t size;
+	/* the file state at the time of the decode, only for files */
+	time_t mtime;
+	off_t fsize;
+} Enesim_Image_Cache_Entry;
+
+typedef struct _Enesim_Image_Cache
+{
+	Eina_Lock lock;
+	Eina_Hash *entries;
+	/* most recently used first */
+	Eina_Inlist *lru;
+	size_t size;
+	size_t usage;
+} Enesim_Image_Cache;
+
+static Enesim_Image_Cache _cache;
+
+static void _entry_free(void *data)
+{
+	Enesim_Image_Cache_Entry *e = data;
+
+	enesim_buffer_unref(e->buffer);
+	free(e->key);
+	free(e);
+}
+
+/* must be called with the lock taken */
+static void _entry_remove(Enesim_Image_Cache_Entry *e)
+{
+	_cache.lru = eina_inlist_remove(_cache.lru, EINA_INLIST_GET(e));
+	_cache.usage -= e->size;
+	/* the hash frees the entry */
+	eina_hash_del(_cache.entries, e->key, e);
+}
+
+/* must be called with the lock taken */
+static void _cache_trim(size_t size)
+{
+	while (_cache.lru && _cache.usage > size)
+	{
+		Enesim_Image_Cache_Entry *e;
+
+		e = EINA_INLIST_CONTAINER_GET(_cache.lru->last,
+				Enesim_Image_Cache_Entry);
+		_entry_remove(e);
+	}
+}
+
+static char * _cache_key_get(const char *id, Enesim_Buffer_Format fmt,
+		const char *options)
+{
+	char *key;
+
+	if (asprintf(&key, "%s|%d|%s", id, fmt, options ? options : "") < 0)
+		return NULL;
+	return key;
+}
+
+static Eina_Bool _cache_file_stat(const char *file, time_t *mtime,
+		off_t *fsize)
+{
+	struct stat st;
+
+	if (stat(file, &st) < 0)
+		return EINA_FALSE;
+	*mtime = st.st_mtime;
+	*fsize = st.st_size;
+	return EINA_TRUE;
+}
+
+/* Files are identified by their path, the stat is done on every lookup
+ * to invalidate the entry whenever the file changes. Any other stream is
+ * identified by a hash of its contents
+ */
+static char * _cache_stream_key_get(Enesim_Stream *s, Enesim_Buffer_Format fmt,
+		const char *options, Eina_Bool *is_file, time_t *mtime,
+		off_t *fsize)
+{
+	const char *name = NULL;
+	const char *uri;
+	char *key;
+	char id[64];
+	void *data;
+	size_t len;
+
+	enesim_stream_type_get(s, NULL, &name);
+	uri = enesim_stream_uri_get(s);
+	if (name && uri && !strcmp(name, "enesim.stream.file") &&
+			!strncmp(uri, ENESIM_IMAGE_CACHE_FILE_URI,
+			strlen(ENESIM_IMAGE_CACHE_FILE_URI)))
+	{
+		if (!_cache_file_stat(uri + strlen(ENESIM_IMAGE_CACHE_FILE_URI),
+				mtime, fsize))
+			return NULL;
+		*is_file = EINA_TRUE;
+		return _cache_key_get(uri, fmt, options);
+	}
+
+	data = enesim_stream_mmap(s, &len);
+	if (!data)
+		return NULL;
+	snprintf(id, sizeof(id), "%s#%zu#%08x", name ? name : "", len,
+			(unsigned int)eina_hash_superfast(data, len));
+	enesim_stream_munmap(s, data);
+	enesim_stream_reset(s);
+
+	*is_file = EINA_FALSE;
+	key = _cache_key_get(id, fmt, options);
+	return key;
+}
+
+static Enesim_Buffer * _cache_find(const char *key, Eina_Bool is_file,
+		time_t mtime, off_t fsize)
+{
+	Enesim_Image_Cache_Entry *e;
+	Enesim_Buffer *ret = NULL;
+
+	eina_lock_take(&_cache.lock);
+	e = eina_hash_find(_cache.entries, key);
+	if (e)
+	{
+		if (is_file && (e->mtime != mtime || e->fsize != fsize))
+		{
+			DBG("Image '%s' has changed, invalidating", key);
+			_entry_remove(e);
+		}
+		else
+		{
+			_cache.lru = eina_inlist_promote(_cache.lru,
+					EINA_INLIST_GET(e));
+			ret = enesim_buffer_ref(e->buffer);
+		}
+	}
+	eina_lock_release(&_cache.lock);
+
+	return ret;
+}
+
+/* Returns the buffer to use, in case another thread decoded the same image
+ * in the meantime its buffer is used instead
+ */
+static Enesim_Buffer * _cache_add(char *key, Enesim_Buffer *b,
+		time_t mtime, off_t fsize)
+{
+	Enesim_Image_Cache_Entry *e;
+	Enesim_Buffer_Format fmt;
+	int w, h;
+
+	eina_lock_take(&_cache.lock);
+	e = eina_hash_find(_cache.entries, key);
+	if (e)
+	{
+		if (e->mtime == mtime && e->fsize == fsize)
+		{
+			_cache.lru = eina_inlist_promote(_cache.lru,
+					EINA_INLIST_GET(e));
+			enesim_buffer_unref(b);
+			b = enesim_buffer_ref(e->buffer);
+			eina_lock_release(&_cache.lock);
+			free(key);
+			return b;
+		}
+		_entry_remove(e);
+	}
+
+	enesim_buffer_size_get(b, &w, &h);
+	fmt = enesim_buffer_format_get(b);
+
+	e = calloc(1, sizeof(Enesim_Image_Cache_Entry));
+	e->key = key;
+	e->buffer = enesim_buffer_ref(b);
+	e->size = enesim_buffer_format_size_get(fmt, w, h);
+	e->mtime = mtime;
+	e->fsize = fsize;
+
+	/* an image bigger than the whole cache is never kept */
+	if (e->size > _cache.size)
+	{
+		eina_lock_release(&_cache.lock);
+		_entry_free(e);
+		return b;
+	}
+
+	_cache_trim(_cache.size - e->size);
+	eina_hash_add(_cache.entries, e->key, e);
+	_cache.lru = eina_inlist_prepend(_cache.lru, EINA_INLIST_GET(e));
+	_cache.usage += e->size;
+	eina_lock_release(&_cache.lock);
+
+	return b;
+}
+
+static Eina_Bool _cache_decode(Enesim_Stream *s, const char *mime,
+		Enesim_Buffer **b, Enesim_Buffer_Format fmt, const char *options,
+		Eina_Error *err)
+{
+	Enesim_Buffer *buffer = NULL;
+
+	if (fmt != ENESIM_BUFFER_FORMAT_LAST)
+	{
+		int w, h;
+
+		if (!enesim_image_info_get(s, mime, &w, &h, NULL, options, err))
+			return EINA_FALSE;
+		enesim_stream_reset(s);
+		buffer = enesim_buffer_new(fmt, w, h);
+		if (!buffer)
+		{
+			if (err) *err = ENESIM_IMAGE_ERROR_ALLOCATOR;
+			return EINA_FALSE;
+		}
+	}
+	if (!enesim_image_load(s, mime, &buffer, NULL, options, err))
+	{
+		if (buffer)
+			enesim_buffer_unref(buffer);
+		return EINA_FALSE;
+	}
+	*b = buffer;
+	return EINA_TRUE;
+}
+
+static Eina_Bool _cache_load(Enesim_Stream *s, const char *mime,
+		char *key, time_t mtime, off_t fsize, Enesim_Buffer **b,
+		Enesim_Buffer_Format fmt, const char *options, Eina_Error *err)
+{
+	Enesim_Buffer *buffer;
+
+	if (!_cache_decode(s, mime, &buffer, fmt, options, err))
+	{
+		free(key);
+		return EINA_FALSE;
+	}
+	*b = _cache_add(key, buffer, mtime, fsize);
+	return EINA_TRUE;
+}
+/** @endcond */
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+void enesim_image_cache_init(void)
+{
+	eina_lock_new(&_cache.lock);
+	_cache.entries = eina_hash_string_superfast_new(_entry_free);
+	_cache.lru = NULL;
+	_cache.size = ENESIM_IMAGE_CACHE_SIZE;
+	_cache.usage = 0;
+}
+
+void enesim_image_cache_shutdown(void)
+{
+	enesim_image_cache_flush();
+	eina_hash_free(_cache.entries);
+	_cache.entries = NULL;
+	eina_lock_free(&_cache.lock);
+}
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Load an image through the decoded image cache
+ * @param[in] s The image data to load from
+ * @param[in] mime The image mime. It can be NULL, if so, it will be autodetected
+ * from the data itself.
+ * @param[out] b The shared buffer with the image pixels
+ * @param[in] fmt The format of the buffer to decode into.
+ * ENESIM_BUFFER_FORMAT_LAST to use the one the provider chooses
+ * @param[in] options Any option the provider might require
+ * @param[out] err The error in case the load fails
+ * @return EINA_TRUE in case the image was loaded correctly. EINA_FALSE if not
+ *
+ * The images are identified by the file path in case of file streams or by
+ * the contents of the stream otherwise, the options and the format. Loading
+ * the same image again returns a new reference of the same buffer, the
+ * caller must unref it but must not modify its pixels. A file whose
+ * modification time or size has changed is decoded again.
+ * Streams that can not be mapped are decoded without being cached.
+ */
+EAPI Eina_Bool enesim_image_cache_load(Enesim_Stream *s, const char *mime,
+		Enesim_Buffer **b, Enesim_Buffer_Format fmt, const char *options,
+		Eina_Error *err)
+{
+	Enesim_Buffer *buffer;
+	Eina_Bool is_file = EINA_FALSE;
+	time_t mtime = 0;
+	off_t fsize = 0;
+	char *key;
+
+	if (!s || !b) return EINA_FALSE;
+
+	key = _cache_stream_key_get(s, fmt, options, &is_file, &mtime, &fsize);
+	if (!key)
+		return _cache_decode(s, mime, b, fmt, options, err);
+
+	buffer = _cache_find(key, is_file, mtime, fsize);
+	if (buffer)
+	{
+		free(key);
+		*b = buffer;
+		return EINA_TRUE;
+	}
+	return _cache_load(s, mime, key, mtime, fsize, b, fmt, options, err);
+}
+
+/**
+ * @brief Load an image file through the decoded image cache
+ * @param[in] file The image file to load
+ * @param[out] b The shared buffer with the image pixels
+ * @param[in] fmt The format of the buffer to decode into.
+ * ENESIM_BUFFER_FORMAT_LAST to use the one the provider chooses
+ * @param[in] options Any option the provider might require
+ * @param[out] err The error in case the load fails
+ * @return EINA_TRUE in case the image was loaded correctly. EINA_FALSE if not
+ *
+ * The file is only opened when it is not on the cache already.
+ * @see enesim_image_cache_load()
+ */
+EAPI Eina_Bool enesim_image_cache_file_load(const char *file,
+		Enesim_Buffer **b, Enesim_Buffer_Format fmt, const char *options,
+		Eina_Error *err)
+{
+	Enesim_Buffer *buffer;
+	Enesim_Stream *s;
+	Eina_Bool ret;
+	time_t mtime;
+	off_t fsize;
+	char *uri;
+	char *key;
+
+	if (!file || !b) return EINA_FALSE;
+	if (!_cache_file_stat(file, &mtime, &fsize))
+	{
+		if (err) *err = ENESIM_IMAGE_ERROR_EXIST;
+		return EINA_FALSE;
+	}
+
+	/* same key as the one of a file stream */
+	if (asprintf(&uri, ENESIM_IMAGE_CACHE_FILE_URI "%s", file) < 0)
+		return EINA_FALSE;
+	key = _cache_key_get(uri, fmt, options);
+	free(uri);
+	if (!key)
+		return EINA_FALSE;
+
+	buffer = _cache_find(key, EINA_TRUE, mtime, fsize);
+	if (buffer)
+	{
+		free(key);
+		*b = buffer;
+		return EINA_TRUE;
+	}
+
+	s = enesim_stream_file_new(file, "rb");
+	if (!s)
+	{
+		free(key);
+		if (err) *err = ENESIM_IMAGE_ERROR_EXIST;
+		return EINA_FALSE;
+	}
+	ret = _cache_load(s, NULL, key, mtime, fsize, b, fmt, options, err);
+	enesim_stream_unref(s);
+
+	return ret;
+}
+
+/**
+ * @brief Set the maximum number of bytes of decoded pixels the cache keeps
+ * @param[in] size The size in bytes
+ *
+ * The least recently used images are evicted until the cache fits on the
+ * new size. Buffers still referenced by the application remain valid.
+ */
+EAPI void enesim_image_cache_size_set(size_t size)
+{
+	eina_lock_take(&_cache.lock);
+	_cache.size = size;
+	_cache_trim(size);
+	eina_lock_release(&_cache.lock);
+}
+
+/**
+ * @brief Get the maximum number of bytes of decoded pixels the cache keeps
+ * @return The size in bytes
+ */
+EAPI size_t enesim_image_cache_size_get(void)
+{
+	size_t ret;
+
+	eina_lock_take(&_cache.lock);
+	ret = _cache.size;
+	eina_lock_release(&_cache.lock);
+
+	return ret;
+}
+
+/**
+ * @brief Get the number of bytes of decoded pixels the cache currently keeps
+ * @return The usage in bytes
+ */
+EAPI size_t enesim_image_cache_usage_get(void)
+{
+	size_t ret;
+
+	eina_lock_take(&_cache.lock);
+	ret = _cache.usage;
+	eina_lock_release(&_cache.lock);
+
+	return ret;
+}
+
+/**
+ * @brief Remove every image from the cache
+ */
+EAPI void enesim_image_cache_flush(void)
+{
+	eina_lock_take(&_cache.lock);
+	_cache_trim(0);
+	eina_lock_release(&_cache.lock);
+}
@@ -25,6 +25,7 @@
 #include "enesim_stream.h"
 #include "enesim_image.h"
 #include "enesim_image_private.h"
+#include "enesim_thread_private.h"
 
 /*============================================================================*
  *                                  Local                                     *
@@ -35,12 +36,10 @@
 # define pipe_write(fd, buffer, size) send((fd), (char *)(buffer), size, 0)
 # define pipe_read(fd, buffer, size)  recv((fd), (char *)(buffer), size, 0)
 # define pipe_close(fd)               closesocket(fd)
-# define ENESIM_IMAGE_THREAD_CREATE(x, f, d) x = CreateThread(NULL, 0, f, d, 0, NULL);
 #else
 # define pipe_write(fd, buffer, size) write((fd), buffer, size)
 # define pipe_read(fd, buffer, size)  read((fd), buffer, size)
 # define pipe_close(fd)               close(fd)
-# define ENESIM_IMAGE_THREAD_CREATE(x, f, d) pthread_create(&(x), NULL, (void *)f, d)
 #endif /* ! _WIN32 */
 
 #define ENESIM_LOG_DEFAULT enesim_log_image
@@ -49,10 +48,17 @@ struct _Enesim_Image_Context
 {
 	/* the communication between the main thread and the async ones */
 	int fifo[2];
-#ifdef _WIN32
-	HANDLE tid;
-#else
-	pthread_t tid;
+	/* the jobs waiting for a worker, sorted by priority */
+	Eina_Inlist *queue;
+	Eina_Lock lock;
+	Eina_Condition cond;
+	Eina_Bool shutdown;
+	/* the workers */
+	unsigned int max_workers;
+	unsigned int nworkers;
+	unsigned int idle;
+#ifdef BUILD_THREAD
+	Enesim_Thread *workers;
 #endif
 };
 
@@ -63,8 +69,16 @@ typedef enum _Enesim_Image_Job_Type
 	ENESIM_IMAGE_JOB_TYPES,
 } Enesim_Image_Job_Type;
 
-typedef struct _Enesim_Image_Job
+typedef enum _Enesim_Image_Job_State
+{
+	ENESIM_IMAGE_JOB_QUEUED,
+	ENESIM_IMAGE_JOB_RUNNING,
+	ENESIM_IMAGE_JOB_FINISHED,
+} Enesim_Image_Job_State;
+
+struct _Enesim_Image_Job
 {
+	EINA_INLIST;
 	Enesim_Image_Context *thiz;
 	Enesim_Image_Provider *prov;
 	Enesim_Stream *data;
@@ -73,6 +87,8 @@ typedef struct _Enesim_Image_Job
 	Eina_Error err;
 	Eina_Bool success;
 	Enesim_Image_Job_Type type;
+	Enesim_Image_Job_State state;
+	Enesim_Priority priority;
 	char *options;
 
 	union {
@@ -84,29 +100,95 @@ typedef struct _Enesim_Image_Job
 			Enesim_Buffer *b;
 		} save;
 	} op;
-} Enesim_Image_Job;
+};
 
-/*----------------------------------------------------------------------------*
- *                        Thread related functions                            *
- *----------------------------------------------------------------------------*/
-static int _thread_finish(Enesim_Image_Job *j)
+static void _job_free(Enesim_Image_Job *j)
+{
+	if (j->options)
+		free(j->options);
+	free(j);
+}
+
+/* must be called with the lock taken */
+static void _job_enqueue(Enesim_Image_Context *thiz, Enesim_Image_Job *j)
+{
+	Enesim_Image_Job *other;
+
+	/* keep the submission order between jobs of the same priority */
+	EINA_INLIST_FOREACH(thiz->queue, other)
+	{
+		if (other->priority < j->priority)
+		{
+			thiz->queue = eina_inlist_prepend_relative(thiz->queue,
+					EINA_INLIST_GET(j), EINA_INLIST_GET(other));
+			return;
+		}
+	}
+	thiz->queue = eina_inlist_append(thiz->queue, EINA_INLIST_GET(j));
+}
+
+static void _job_run(Enesim_Image_Job *j)
+{
+	if (j->type == ENESIM_IMAGE_LOAD)
+	{
+		j->success = enesim_image_provider_load(j->prov, j->data,
+				&j->op.load.b, j->op.load.pool, j->options,
+				&j->err);
+	}
+	else
+	{
+		j->success = enesim_image_provider_save(j->prov, j->data,
+				j->op.save.b, j->options, &j->err);
+	}
+}
+
+/* once written, the job belongs to the dispatcher */
+static int _job_finish(Enesim_Image_Job *j)
 {
 	int ret;
 	ret = pipe_write(j->thiz->fifo[1], &j, sizeof(j));
 	return ret;
 }
 
+/*----------------------------------------------------------------------------*
+ *                        Thread related functions                            *
+ *----------------------------------------------------------------------------*/
+#ifdef BUILD_THREAD
 #ifdef _WIN32
-static DWORD WINAPI _thread_load(LPVOID data)
+static DWORD WINAPI _worker_run(void *data)
 #else
-static void * _thread_load(void *data)
+static void * _worker_run(void *data)
 #endif
 {
-	Enesim_Image_Job *j = data;
+	Enesim_Image_Context *thiz = data;
+
+	eina_lock_take(&thiz->lock);
+	for (;;)
+	{
+		Enesim_Image_Job *j;
+
+		thiz->idle++;
+		while (!thiz->queue && !thiz->shutdown)
+			eina_condition_wait(&thiz->cond);
+		thiz->idle--;
+		if (thiz->shutdown)
+			break;
 
-	enesim_image_provider_load(j->prov, j->data, &j->op.load.b,
-		j->op.load.pool, j->options, &j->err);
-	_thread_finish(j);
+		j = EINA_INLIST_CONTAINER_GET(thiz->queue, Enesim_Image_Job);
+		thiz->queue = eina_inlist_remove(thiz->queue, thiz->queue);
+		j->state = ENESIM_IMAGE_JOB_RUNNING;
+		eina_lock_release(&thiz->lock);
+
+		_job_run(j);
+
+		eina_lock_take(&thiz->lock);
+		j->state = ENESIM_IMAGE_JOB_FINISHED;
+		eina_lock_release(&thiz->lock);
+		/* do not block the other threads in case the fifo is full */
+		_job_finish(j);
+		eina_lock_take(&thiz->lock);
+	}
+	eina_lock_release(&thiz->lock);
 
 #ifdef _WIN32
 	return 0;
@@ -114,24 +196,45 @@ static void * _thread_load(void *data)
 	return NULL;
 #endif
 }
-
-#ifdef _WIN32
-static DWORD WINAPI _thread_save(LPVOID data)
-#else
-static void * _thread_save(void *data)
 #endif
-{
-	Enesim_Image_Job *j = data;
-
-	enesim_image_provider_save(j->prov, j->data, j->op.save.b, j->options,
-		&j->err);
-	_thread_finish(j);
 
-#ifdef _WIN32
-	return 1;
+static Enesim_Image_Job * _job_submit(Enesim_Image_Context *thiz,
+		Enesim_Image_Job *j)
+{
+	j->thiz = thiz;
+	j->priority = ENESIM_PRIORITY_SECONDARY;
+#ifdef BUILD_THREAD
+	eina_lock_take(&thiz->lock);
+	j->state = ENESIM_IMAGE_JOB_QUEUED;
+	_job_enqueue(thiz, j);
+	/* only start a new worker when every other one is busy */
+	if (!thiz->idle && thiz->nworkers < thiz->max_workers)
+	{
+		if (enesim_thread_new(&thiz->workers[thiz->nworkers],
+				_worker_run, thiz))
+			thiz->nworkers++;
+		else
+			WRN("Can not create a new worker");
+	}
+	/* no worker at all, do it ourselves */
+	if (!thiz->nworkers)
+	{
+		thiz->queue = eina_inlist_remove(thiz->queue,
+				EINA_INLIST_GET(j));
+		eina_lock_release(&thiz->lock);
+		_job_run(j);
+		j->state = ENESIM_IMAGE_JOB_FINISHED;
+		_job_finish(j);
+		return j;
+	}
+	eina_condition_signal(&thiz->cond);
+	eina_lock_release(&thiz->lock);
 #else
-	return NULL;
+	_job_run(j);
+	j->state = ENESIM_IMAGE_JOB_FINISHED;
+	_job_finish(j);
 #endif
+	return j;
 }
 /** @endcond */
 /*============================================================================*
@@ -141,9 +244,23 @@ static void * _thread_save(void *data)
  * @brief Create a new context
  *
  * Create a new context. A context is the holder of every asynchronous
- * operation done. 
+ * operation done. The jobs are processed by as many workers as CPUs
+ * are available.
  */
 EAPI Enesim_Image_Context * enesim_image_context_new(void)
+{
+	return enesim_image_context_new_workers(eina_cpu_count());
+}
+
+/**
+ * @brief Create a new context with a fixed number of workers
+ * @param[in] workers The maximum number of threads processing the jobs
+ *
+ * The workers are started on demand, a context never runs more than
+ * @p workers jobs at the same time. The rest of the jobs wait on a queue
+ * sorted by priority.
+ */
+EAPI Enesim_Image_Context * enesim_image_context_new_workers(unsigned int workers)
 {
 	Enesim_Image_Context *thiz;
 
@@ -157,17 +274,57 @@ EAPI Enesim_Image_Context * enesim_image_context_new(void)
 	}
 
 	fcntl(thiz->fifo[0], F_SETFL, O_NONBLOCK);
-	/* TODO the pool of threads */
+	/* the pool of threads */
+	if (!workers)
+		workers = 1;
+	thiz->max_workers = workers;
+#ifdef BUILD_THREAD
+	thiz->workers = calloc(workers, sizeof(Enesim_Thread));
+#endif
+	eina_lock_new(&thiz->lock);
+	eina_condition_new(&thiz->cond, &thiz->lock);
 	return thiz;
 }
-	
+
 /**
  * @brief Free a context
  *
+ * The jobs still waiting on the queue are cancelled, the ones being
+ * processed are waited for. Every pending callback is called before
+ * freeing the context.
  */
 EAPI void enesim_image_context_free(Enesim_Image_Context *thiz)
 {
-	/* TODO what if we shutdown while some thread is active? */
+	Enesim_Image_Job *j;
+
+	/* stop the workers */
+	eina_lock_take(&thiz->lock);
+	thiz->shutdown = EINA_TRUE;
+	eina_condition_broadcast(&thiz->cond);
+	eina_lock_release(&thiz->lock);
+#ifdef BUILD_THREAD
+	{
+		unsigned int i;
+
+		for (i = 0; i < thiz->nworkers; i++)
+			enesim_thread_free(thiz->workers[i]);
+		free(thiz->workers);
+	}
+#endif
+	/* cancel the queued jobs */
+	while (thiz->queue)
+	{
+		j = EINA_INLIST_CONTAINER_GET(thiz->queue, Enesim_Image_Job);
+		thiz->queue = eina_inlist_remove(thiz->queue, thiz->queue);
+		j->state = ENESIM_IMAGE_JOB_FINISHED;
+		j->success = EINA_FALSE;
+		j->err = ENESIM_IMAGE_ERROR_CANCELLED;
+		_job_finish(j);
+	}
+	enesim_image_context_dispatch(thiz);
+
+	eina_condition_free(&thiz->cond);
+	eina_lock_free(&thiz->lock);
 	/* the fifo */
 	pipe_close(thiz->fifo[0]);
 	pipe_close(thiz->fifo[1]);
@@ -186,8 +343,10 @@ EAPI void enesim_image_context_free(Enesim_Image_Context *thiz)
  * @param cb The function that will get called once the load is done
  * @param data User provided data
  * @param options Any option the provider might require
+ * @return The job handle, valid until @p cb is called. NULL in case the
+ * load can not be done, @p cb is called before returning
  */
-EAPI void enesim_image_context_load_async(Enesim_Image_Context *thiz, Enesim_Stream *s,
+EAPI Enesim_Image_Job * enesim_image_context_load_async(Enesim_Image_Context *thiz, Enesim_Stream *s,
 		const char *mime, Enesim_Buffer *b, Enesim_Pool *mpool,
 		Enesim_Image_Callback cb, void *data,
 		const char *options)
@@ -199,11 +358,10 @@ EAPI void enesim_image_context_load_async(Enesim_Image_Context *thiz, Enesim_Str
 	if (!prov)
 	{
 		cb(NULL, data, EINA_FALSE, ENESIM_IMAGE_ERROR_PROVIDER);
-		return;
+		return NULL;
 	}
 
 	j = calloc(1, sizeof(Enesim_Image_Job));
-	j->thiz = thiz;
 	j->prov = prov;
 	j->data = s;
 	j->cb = cb;
@@ -215,10 +373,9 @@ EAPI void enesim_image_context_load_async(Enesim_Image_Context *thiz, Enesim_Str
 	j->type = ENESIM_IMAGE_LOAD;
 	j->op.load.b = b;
 	j->op.load.pool = mpool;
-	/* FIXME we need to block the thread */
-	/* create a thread that loads the image on background and sends
+	/* queue the job, a worker loads the image on background and sends
 	 * a command into the fifo fd */
-	ENESIM_IMAGE_THREAD_CREATE(thiz->tid, _thread_load, j);
+	return _job_submit(thiz, j);
 }
 
 /**
@@ -231,9 +388,10 @@ EAPI void enesim_image_context_load_async(Enesim_Image_Context *thiz, Enesim_Str
  * @param cb The function that will get called once the save is done
  * @param data User provided data
  * @param options Any option the provider might require
- *
+ * @return The job handle, valid until @p cb is called. NULL in case the
+ * save can not be done, @p cb is called before returning
  */
-EAPI void enesim_image_context_save_async(Enesim_Image_Context *thiz, Enesim_Stream *s,
+EAPI Enesim_Image_Job * enesim_image_context_save_async(Enesim_Image_Context *thiz, Enesim_Stream *s,
 		const char *mime, Enesim_Buffer *b, Enesim_Image_Callback cb,
 		void *data, const char *options)
 {
@@ -244,11 +402,10 @@ EAPI void enesim_image_context_save_async(Enesim_Image_Context *thiz, Enesim_Str
 	if (!prov)
 	{
 		cb(NULL, data, EINA_FALSE, ENESIM_IMAGE_ERROR_PROVIDER);
-		return;
+		return NULL;
 	}
 
-	j = malloc(sizeof(Enesim_Image_Job));
-	j->thiz = thiz;
+	j = calloc(1, sizeof(Enesim_Image_Job));
 	j->prov = prov;
 	j->data = s;
 	j->cb = cb;
@@ -259,10 +416,76 @@ EAPI void enesim_image_context_save_async(Enesim_Image_Context *thiz, Enesim_Str
 	j->success = EINA_TRUE;
 	j->type = ENESIM_IMAGE_SAVE;
 	j->op.save.b = b;
-	/* FIXME we need to block the thread */
-	/* create a thread that saves the image on background and sends
+	/* queue the job, a worker saves the image on background and sends
 	 * a command into the fifo fd */
-	ENESIM_IMAGE_THREAD_CREATE(thiz->tid, _thread_save, j);
+	return _job_submit(thiz, j);
+}
+
+/**
+ * @brief Cancel an asynchronous job
+ * @param[in] j The job to cancel
+ * @return EINA_TRUE if the job was cancelled, EINA_FALSE if it is already
+ * being processed
+ *
+ * Only the jobs still waiting for a worker can be cancelled. The callback
+ * of a cancelled job is called on the next dispatch with the
+ * ENESIM_IMAGE_ERROR_CANCELLED error, so the user can release the
+ * associated data.
+ */
+EAPI Eina_Bool enesim_image_job_cancel(Enesim_Image_Job *j)
+{
+	Enesim_Image_Context *thiz;
+
+	if (!j) return EINA_FALSE;
+
+	thiz = j->thiz;
+	eina_lock_take(&thiz->lock);
+	if (j->state != ENESIM_IMAGE_JOB_QUEUED)
+	{
+		eina_lock_release(&thiz->lock);
+		return EINA_FALSE;
+	}
+	thiz->queue = eina_inlist_remove(thiz->queue, EINA_INLIST_GET(j));
+	j->state = ENESIM_IMAGE_JOB_FINISHED;
+	j->success = EINA_FALSE;
+	j->err = ENESIM_IMAGE_ERROR_CANCELLED;
+	eina_lock_release(&thiz->lock);
+	_job_finish(j);
+
+	return EINA_TRUE;
+}
+
+/**
+ * @brief Change the priority of an asynchronous job
+ * @param[in] j The job to change the priority of
+ * @param[in] priority The new priority
+ * @return EINA_TRUE if the priority was changed, EINA_FALSE if the job is
+ * already being processed
+ *
+ * The jobs with higher priority are processed first. Jobs with the same
+ * priority are processed in the order they were requested. Every job is
+ * created with the ENESIM_PRIORITY_SECONDARY priority.
+ */
+EAPI Eina_Bool enesim_image_job_priority_set(Enesim_Image_Job *j,
+		Enesim_Priority priority)
+{
+	Enesim_Image_Context *thiz;
+
+	if (!j) return EINA_FALSE;
+
+	thiz = j->thiz;
+	eina_lock_take(&thiz->lock);
+	if (j->state != ENESIM_IMAGE_JOB_QUEUED)
+	{
+		eina_lock_release(&thiz->lock);
+		return EINA_FALSE;
+	}
+	thiz->queue = eina_inlist_remove(thiz->queue, EINA_INLIST_GET(j));
+	j->priority = priority;
+	_job_enqueue(thiz, j);
+	eina_lock_release(&thiz->lock);
+
+	return EINA_TRUE;
 }
 
 /**
@@ -294,8 +517,6 @@ EAPI void enesim_image_context_dispatch(Enesim_Image_Context *thiz)
 			j->cb(j->op.load.b, j->user_data, j->success, j->err);
 		else
 			j->cb(j->op.save.b, j->user_data, j->success, j->err);
-		if (j->options)
-			free(j->options);
-		free(j);
+		_job_free(j);
 	}
 }
@@ -162,6 +162,37 @@ EAPI Eina_Bool enesim_image_file_load(const char *file, Enesim_Buffer **b,
 	enesim_stream_unref(data);
 	return ret;
 }
+/**
+ * Load an image file synchronously, notifying every band of rows decoded
+ *
+ * @param[in] file The image file to load
+ * @param[out] b The buffer to write the image pixels to
+ * @param[in] mpool The mempool that will create the surface in case the surface
+ * reference is NULL
+ * @param[in] area The area of the image to load. NULL for the whole image
+ * @param[in] cb The function called with every band of rows decoded
+ * @param[in] data User provided data
+ * @param[in] options Any option the emage provider might require
+ * @param[out] err The error in case the file load fails
+ * @return EINA_TRUE in case the image was loaded correctly. EINA_FALSE if not
+ * @see enesim_image_load_progressive()
+ */
+EAPI Eina_Bool enesim_image_file_load_progressive(const char *file,
+		Enesim_Buffer **b, Enesim_Pool *mpool,
+		const Eina_Rectangle *area, Enesim_Image_Progress cb,
+		void *data, const char *options, Eina_Error *err)
+{
+	Enesim_Stream *s;
+	Eina_Bool ret;
+	const char *mime;
+
+	if (!_file_load_data_get(file, &s, &mime))
+		return EINA_FALSE;
+	ret = enesim_image_load_progressive(s, mime, b, mpool, area, cb,
+			data, options, err);
+	enesim_stream_unref(s);
+	return ret;
+}
 /**
  * Load an image file asynchronously
  *
@@ -172,8 +203,9 @@ EAPI Eina_Bool enesim_image_file_load(const char *file, Enesim_Buffer **b,
  * @param[in] cb The function that will get called once the load is done
  * @param[in] data User provided data
  * @param[in] options Any option the emage provider might require
+ * @return The job handle, valid until @p cb is called
  */
-EAPI void enesim_image_file_load_async(const char *file, Enesim_Buffer *b,
+EAPI Enesim_Image_Job * enesim_image_file_load_async(const char *file, Enesim_Buffer *b,
 		Enesim_Pool *mpool, Enesim_Image_Callback cb,
 		void *data, const char *options)
 {
@@ -184,7 +216,7 @@ EAPI void enesim_image_file_load_async(const char *file, Enesim_Buffer *b,
 	if (!_file_load_data_get(file, &s, &mime))
 	{
 		cb(NULL, data, EINA_FALSE, ENESIM_IMAGE_ERROR_PROVIDER);
-		return;
+		return NULL;
 	}
 
 	fdata = malloc(sizeof(Enesim_Image_File_Data));
@@ -192,7 +224,7 @@ EAPI void enesim_image_file_load_async(const char *file, Enesim_Buffer *b,
 	fdata->user_data = data;
 	fdata->data = s;
 
-	enesim_image_load_async(data, mime, b, mpool, _enesim_image_file_cb, fdata, options);
+	return enesim_image_load_async(s, mime, b, mpool, _enesim_image_file_cb, fdata, options);
 }
 /**
  * Save an image file synchronously
@@ -226,8 +258,9 @@ EAPI Eina_Bool enesim_image_file_save(const char *file, Enesim_Buffer *b, const
  * @param[in] cb The function that will get called once the save is done
  * @param[in] data User provided data
  * @param[in] options Any option the emage provider might require
+ * @return The job handle, valid until @p cb is called
  */
-EAPI void enesim_image_file_save_async(const char *file, Enesim_Buffer *b,
+EAPI Enesim_Image_Job * enesim_image_file_save_async(const char *file, Enesim_Buffer *b,
 		Enesim_Image_Callback cb, void *data, const char *options)
 {
 	Enesim_Stream *s;
@@ -237,7 +270,7 @@ EAPI void enesim_image_file_save_async(const char *file, Enesim_Buffer *b,
 	if (!_file_save_data_get(file, &s, &mime))
 	{
 		cb(NULL, data, EINA_FALSE, ENESIM_IMAGE_ERROR_PROVIDER);
-		return;
+		return NULL;
 	}
 
 	fdata = malloc(sizeof(Enesim_Image_File_Data));
@@ -245,5 +278,5 @@ EAPI void enesim_image_file_save_async(const char *file, Enesim_Buffer *b,
 	fdata->user_data = data;
 	fdata->data = s;
 
-	enesim_image_save_async(data, mime, b, _enesim_image_file_cb, fdata, options);
+	return enesim_image_save_async(s, mime, b, _enesim_image_file_cb, fdata, options);
 }
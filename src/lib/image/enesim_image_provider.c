@@ -67,6 +67,35 @@ static Eina_Bool _provider_info_get(Enesim_Image_Provider *p, Enesim_Stream *dat
 	return ret;
 }
 
+/* check if the provider can load the image into a buffer of another format */
+static Eina_Bool _provider_format_supported(Enesim_Image_Provider *p,
+		Enesim_Buffer_Format fmt, void *options)
+{
+	Enesim_Buffer_Format formats[ENESIM_BUFFER_FORMAT_LAST];
+	Eina_Error err;
+	int count;
+	int i;
+
+	if (!p->d->formats_get)
+		return EINA_FALSE;
+	count = p->d->formats_get(formats, options, &err);
+	for (i = 0; i < count; i++)
+	{
+		if (formats[i] == fmt)
+			return EINA_TRUE;
+	}
+	return EINA_FALSE;
+}
+
+/* the descriptors built before version 1 do not have the progressive load */
+static Enesim_Image_Provider_Load_Progressive _provider_load_progressive_get(
+		Enesim_Image_Provider *p)
+{
+	if (!p->d->version_get || p->d->version_get() < 1)
+		return NULL;
+	return p->d->load_progressive;
+}
+
 static Eina_Bool _provider_options_parse(Enesim_Image_Provider *p, const char *options,
 		void **options_data)
 {
@@ -88,11 +117,15 @@ static void _provider_options_free(Enesim_Image_Provider *p, void *options)
 
 static Eina_Bool _provider_data_load(Enesim_Image_Provider *p,
 		Enesim_Stream *data, Enesim_Buffer **b, Enesim_Pool *mpool,
-		void *options, Eina_Error *err)
+		const Eina_Rectangle *area, Enesim_Image_Progress cb,
+		void *cb_data, void *options, Eina_Error *err)
 {
+	Enesim_Image_Provider_Load_Progressive load_progressive;
 	Enesim_Buffer_Format cfmt;
 	Enesim_Buffer *bb = *b;
+	Eina_Rectangle clip;
 	Eina_Bool owned = EINA_FALSE;
+	Eina_Bool ret;
 	Eina_Error error;
 	int w, h;
 
@@ -100,6 +133,24 @@ static Eina_Bool _provider_data_load(Enesim_Image_Provider *p,
 	{
 		goto info_err;
 	}
+	load_progressive = _provider_load_progressive_get(p);
+	/* only the area inside the image is loaded */
+	if (area)
+	{
+		if (!load_progressive)
+		{
+			error = ENESIM_IMAGE_ERROR_PROVIDER;
+			goto info_err;
+		}
+		eina_rectangle_coords_from(&clip, 0, 0, w, h);
+		if (!eina_rectangle_intersection(&clip, area))
+		{
+			error = ENESIM_IMAGE_ERROR_SIZE;
+			goto info_err;
+		}
+		w = clip.w;
+		h = clip.h;
+	}
 	if (!bb)
 	{
 		/* create a new buffer in case the user does not provided
@@ -119,7 +170,7 @@ static Eina_Bool _provider_data_load(Enesim_Image_Provider *p,
 		int bw, bh;
 		/* otherwise check that the provided buffer is ok */
 		fmt = enesim_buffer_format_get(bb);
-		if (cfmt != fmt)
+		if (cfmt != fmt && !_provider_format_supported(p, fmt, options))
 		{
 			error = ENESIM_IMAGE_ERROR_FORMAT;
 			goto surface_err;
@@ -134,7 +185,19 @@ static Eina_Bool _provider_data_load(Enesim_Image_Provider *p,
 
 	/* load the data */
 	enesim_stream_reset(data);
-	if (!p->d->load(data, bb, options, &error))
+	if (load_progressive && (area || cb))
+	{
+		ret = load_progressive(data, bb, area ? &clip : NULL,
+				cb, cb_data, options, &error);
+	}
+	else
+	{
+		ret = p->d->load(data, bb, options, &error);
+		/* the whole image at once */
+		if (ret && cb)
+			cb(bb, 0, h, EINA_TRUE, cb_data);
+	}
+	if (!ret)
 	{
 		goto load_err;
 	}
@@ -209,7 +272,31 @@ Eina_Bool enesim_image_provider_load(Enesim_Image_Provider *thiz,
 		return EINA_FALSE;
 	}
 	_provider_options_parse(thiz, options, &op);
-	if (!_provider_data_load(thiz, data, b, mpool, op, &e))
+	if (!_provider_data_load(thiz, data, b, mpool, NULL, NULL, NULL, op, &e))
+	{
+		if (err) *err = e;
+		ret = EINA_FALSE;
+	}
+	_provider_options_free(thiz, op);
+	return ret;
+}
+
+Eina_Bool enesim_image_provider_load_progressive(Enesim_Image_Provider *thiz,
+		Enesim_Stream *data, Enesim_Buffer **b, Enesim_Pool *mpool,
+		const Eina_Rectangle *area, Enesim_Image_Progress cb,
+		void *cb_data, const char *options, Eina_Error *err)
+{
+	Eina_Error e = 0;
+	Eina_Bool ret = EINA_TRUE;
+	void *op = NULL;
+
+	if (!thiz)
+	{
+		if (err) *err = ENESIM_IMAGE_ERROR_PROVIDER;
+		return EINA_FALSE;
+	}
+	_provider_options_parse(thiz, options, &op);
+	if (!_provider_data_load(thiz, data, b, mpool, area, cb, cb_data, op, &e))
 	{
 		if (err) *err = e;
 		ret = EINA_FALSE;
@@ -0,0 +1,275 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "enesim_private.h"
+
+#include "enesim_main.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+
+#include "enesim_pool_private.h"
+#include "enesim_buffer_private.h"
+
+#include <sys/mman.h>
+#ifdef __linux__
+# include <sys/syscall.h>
+#endif
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_LOG_DEFAULT enesim_log_pool
+
+#ifndef MFD_CLOEXEC
+# define MFD_CLOEXEC 0x0001U
+#endif
+
+typedef struct _Enesim_Pool_File
+{
+	/* the directory to create the files on, NULL for memory files */
+	char *dir;
+} Enesim_Pool_File;
+
+typedef struct _Enesim_Pool_File_Data
+{
+	/* must be the first, the backend data is used as the sw data */
+	Enesim_Buffer_Sw_Data data;
+	/* the mapping and the file, NULL and -1 for external pixels */
+	void *map;
+	size_t len;
+	int fd;
+} Enesim_Pool_File_Data;
+
+static int _fd_new(Enesim_Pool_File *thiz)
+{
+	const char *dir = thiz->dir;
+	char *path;
+	int fd;
+
+	if (!dir)
+	{
+#if defined(__linux__) && defined(SYS_memfd_create)
+		fd = syscall(SYS_memfd_create, "enesim", MFD_CLOEXEC);
+		if (fd >= 0)
+			return fd;
+		DBG("No memory files, using a temporary file");
+#endif
+		dir = getenv("TMPDIR");
+		if (!dir) dir = "/tmp";
+	}
+
+	if (asprintf(&path, "%s/enesim-XXXXXX", dir) < 0)
+		return -1;
+	fd = mkstemp(path);
+	/* the file only lives while it is mapped */
+	if (fd >= 0)
+		unlink(path);
+	else
+		WRN("Can not create a file on '%s'", dir);
+	free(path);
+
+	return fd;
+}
+/*----------------------------------------------------------------------------*
+ *                        The Enesim's pool interface                         *
+ *----------------------------------------------------------------------------*/
+static const char * _type_get(void)
+{
+	return "enesim.pool.file";
+}
+
+static Eina_Bool _data_alloc(void *prv,
+		Enesim_Backend *backend,
+		void **backend_data,
+		Enesim_Buffer_Format fmt, uint32_t w, uint32_t h)
+{
+	Enesim_Pool_File *thiz = prv;
+	Enesim_Pool_File_Data *data;
+	size_t bytes;
+	int stride;
+
+	bytes = enesim_buffer_format_size_get(fmt, w, h);
+	stride = enesim_buffer_format_size_get(fmt, w, 1);
+	/* mmap does not allow empty mappings */
+	if (!bytes) bytes = 1;
+
+	data = calloc(1, sizeof(Enesim_Pool_File_Data));
+	data->fd = _fd_new(thiz);
+	if (data->fd < 0)
+		goto fd_failed;
+	/* the extended file is filled with zeros */
+	if (ftruncate(data->fd, bytes) < 0)
+	{
+		WRN("Can not allocate %zu bytes for the buffer", bytes);
+		goto map_failed;
+	}
+	data->map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+			data->fd, 0);
+	if (data->map == MAP_FAILED)
+		goto map_failed;
+	data->len = bytes;
+	if (!enesim_buffer_sw_data_set(&data->data, fmt, data->map, stride))
+		goto set_failed;
+
+	*backend = ENESIM_BACKEND_SOFTWARE;
+	*backend_data = data;
+	return EINA_TRUE;
+
+set_failed:
+	munmap(data->map, bytes);
+map_failed:
+	close(data->fd);
+fd_failed:
+	free(data);
+	return EINA_FALSE;
+}
+
+static void _data_free(void *prv EINA_UNUSED,
+		void *backend_data,
+		Enesim_Buffer_Format fmt EINA_UNUSED,
+		Eina_Bool external_allocated EINA_UNUSED)
+{
+	Enesim_Pool_File_Data *data = backend_data;
+
+	if (data->map)
+		munmap(data->map, data->len);
+	if (data->fd >= 0)
+		close(data->fd);
+	free(data);
+}
+
+/* The external pixels are not backed by any file, only the copies are
+ * mapped from one
+ */
+static Eina_Bool _data_from(void *prv,
+		Enesim_Backend *backend,
+		void **backend_data,
+		Enesim_Buffer_Format fmt,
+		uint32_t w, uint32_t h,
+		Eina_Bool copy,
+		Enesim_Buffer_Sw_Data *src)
+{
+	Enesim_Pool_File_Data *data;
+
+	if (copy)
+	{
+		if (!_data_alloc(prv, backend, backend_data, fmt, w, h))
+			return EINA_FALSE;
+		data = *backend_data;
+		if (!enesim_buffer_sw_data_copy(&data->data, src, fmt, w, h))
+		{
+			_data_free(prv, data, fmt, EINA_FALSE);
+			return EINA_FALSE;
+		}
+		return EINA_TRUE;
+	}
+
+	data = calloc(1, sizeof(Enesim_Pool_File_Data));
+	data->data = *src;
+	data->fd = -1;
+	*backend = ENESIM_BACKEND_SOFTWARE;
+	*backend_data = data;
+
+	return EINA_TRUE;
+}
+
+static Eina_Bool _data_get(void *prv EINA_UNUSED,
+		void *backend_data,
+		Enesim_Buffer_Format fmt EINA_UNUSED,
+		uint32_t w EINA_UNUSED, uint32_t h EINA_UNUSED,
+		Enesim_Buffer_Sw_Data *dst)
+{
+	Enesim_Pool_File_Data *data = backend_data;
+
+	*dst = data->data;
+
+	return EINA_TRUE;
+}
+
+static void _free(void *prv)
+{
+	Enesim_Pool_File *thiz = prv;
+
+	free(thiz->dir);
+	free(thiz);
+}
+
+static Enesim_Pool_Descriptor _descriptor = {
+	/* .type_get =   */ _type_get,
+	/* .data_alloc = */ _data_alloc,
+	/* .data_free =  */ _data_free,
+	/* .data_from =  */ _data_from,
+	/* .data_get =   */ _data_get,
+	/* .data_put =   */ NULL,
+	/* .free =       */ _free,
+};
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+Eina_Bool enesim_pool_file_data_fd_get(Enesim_Pool *p, void *backend_data,
+		int *fd, size_t *size)
+{
+	Enesim_Pool_File_Data *data = backend_data;
+
+	if (!p || p->descriptor != &_descriptor)
+		return EINA_FALSE;
+	/* the external pixels do not have any file */
+	if (data->fd < 0)
+		return EINA_FALSE;
+	if (fd) *fd = data->fd;
+	if (size) *size = data->len;
+
+	return EINA_TRUE;
+}
+/** @endcond */
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Create a pool that maps the pixels of every buffer from a file
+ * @param[in] dir The directory to create the files on. NULL to use memory
+ * files when the system supports them
+ * @return The newly allocated pool
+ *
+ * Every buffer gets its own file, shared mapped and unlinked right after
+ * its creation, so it is removed once the buffer is destroyed. Buffers
+ * created on a directory of a disk can be bigger than the available
+ * memory, as the pages are written back to the file instead of failing the
+ * allocation. The file descriptor can be passed to another process to
+ * share the pixels without any copy.
+ * @see enesim_buffer_fd_get()
+ */
+EAPI Enesim_Pool * enesim_pool_file_new(const char *dir)
+{
+	Enesim_Pool_File *thiz;
+	Enesim_Pool *p;
+
+	thiz = calloc(1, sizeof(Enesim_Pool_File));
+	if (dir)
+		thiz->dir = strdup(dir);
+
+	p = enesim_pool_new(&_descriptor, thiz);
+	if (!p)
+	{
+		_free(thiz);
+		return NULL;
+	}
+
+	return p;
+}
+
@@ -0,0 +1,334 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "enesim_private.h"
+
+#include "enesim_main.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+
+#include "enesim_pool_private.h"
+#include "enesim_buffer_private.h"
+
+#include <sys/mman.h>
+#ifdef __linux__
+# include <sys/syscall.h>
+#endif
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_LOG_DEFAULT enesim_log_pool
+
+/* the usual huge page size, the mappings are rounded to it */
+#define ENESIM_POOL_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+/* buffers smaller than this do not get their own mapping */
+#define ENESIM_POOL_HUGE_MIN_SIZE (ENESIM_POOL_HUGE_PAGE_SIZE / 2)
+
+#if defined(__linux__) && defined(SYS_mbind)
+# define ENESIM_POOL_HUGE_NUMA 1
+# ifndef MPOL_INTERLEAVE
+#  define MPOL_INTERLEAVE 3
+# endif
+#endif
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+# define MAP_ANONYMOUS MAP_ANON
+#endif
+
+typedef struct _Enesim_Pool_Huge
+{
+	Eina_Bool hugetlb;
+	/* the online numa nodes */
+	unsigned long nodes;
+	unsigned int nnodes;
+} Enesim_Pool_Huge;
+
+typedef struct _Enesim_Pool_Huge_Data
+{
+	/* must be the first, the backend data is used as the sw data */
+	Enesim_Buffer_Sw_Data data;
+	/* the mapping, NULL in case of small buffers */
+	void *map;
+	size_t len;
+} Enesim_Pool_Huge_Data;
+
+static void _data_free_cb(void *data, void *user_data EINA_UNUSED)
+{
+	free(data);
+}
+
+#if ENESIM_POOL_HUGE_NUMA
+/* parse a list like "0,2-3" */
+static void _numa_nodes_get(Enesim_Pool_Huge *thiz)
+{
+	FILE *f;
+	char line[256];
+	char *s;
+
+	f = fopen("/sys/devices/system/node/online", "r");
+	if (!f) return;
+	if (!fgets(line, sizeof(line), f))
+	{
+		fclose(f);
+		return;
+	}
+	fclose(f);
+
+	s = line;
+	while (*s && *s != '\n')
+	{
+		long first, last;
+		char *end;
+
+		first = strtol(s, &end, 10);
+		if (end == s) break;
+		last = first;
+		if (*end == '-')
+		{
+			s = end + 1;
+			last = strtol(s, &end, 10);
+		}
+		for (; first <= last && first < (long)(sizeof(unsigned long) * 8); first++)
+		{
+			thiz->nodes |= 1UL << first;
+			thiz->nnodes++;
+		}
+		s = end;
+		if (*s == ',') s++;
+	}
+}
+
+/* The threaded renderer splits the rows between every cpu, so every page
+ * of a surface is written by every worker. Interleaving the pages between
+ * the nodes spreads the memory bandwidth instead of having every worker
+ * hitting the node of the thread that touched the surface first
+ */
+static void _numa_bind(Enesim_Pool_Huge *thiz, void *map, size_t len)
+{
+	if (thiz->nnodes < 2)
+		return;
+	if (syscall(SYS_mbind, map, len, MPOL_INTERLEAVE, &thiz->nodes,
+			sizeof(unsigned long) * 8 + 1, 0) < 0)
+		DBG("Can not interleave the pages between the nodes");
+}
+#endif
+
+static void * _map_new(Enesim_Pool_Huge *thiz, size_t *len)
+{
+	void *map = MAP_FAILED;
+	size_t l;
+
+	l = (*len + ENESIM_POOL_HUGE_PAGE_SIZE - 1) &
+			~((size_t)ENESIM_POOL_HUGE_PAGE_SIZE - 1);
+#ifdef MAP_HUGETLB
+	if (thiz->hugetlb)
+	{
+		map = mmap(NULL, l, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (map == MAP_FAILED)
+			DBG("No huge pages reserved, using transparent ones");
+	}
+#endif
+	if (map == MAP_FAILED)
+	{
+		map = mmap(NULL, l, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (map == MAP_FAILED)
+			return NULL;
+#ifdef MADV_HUGEPAGE
+		madvise(map, l, MADV_HUGEPAGE);
+#endif
+	}
+#if ENESIM_POOL_HUGE_NUMA
+	_numa_bind(thiz, map, l);
+#endif
+	*len = l;
+	return map;
+}
+/*----------------------------------------------------------------------------*
+ *                        The Enesim's pool interface                         *
+ *----------------------------------------------------------------------------*/
+static const char * _type_get(void)
+{
+	return "enesim.pool.huge";
+}
+
+static Eina_Bool _data_alloc(void *prv,
+		Enesim_Backend *backend,
+		void **backend_data,
+		Enesim_Buffer_Format fmt, uint32_t w, uint32_t h)
+{
+	Enesim_Pool_Huge *thiz = prv;
+	Enesim_Pool_Huge_Data *data;
+	size_t bytes;
+	int stride;
+	void *alloc_data;
+
+	bytes = enesim_buffer_format_size_get(fmt, w, h);
+	stride = enesim_buffer_format_size_get(fmt, w, 1);
+
+	data = calloc(1, sizeof(Enesim_Pool_Huge_Data));
+	if (bytes >= ENESIM_POOL_HUGE_MIN_SIZE)
+	{
+		/* the anonymous pages are already cleared */
+		data->len = bytes;
+		data->map = _map_new(thiz, &data->len);
+		alloc_data = data->map;
+	}
+	else
+	{
+		alloc_data = calloc(bytes, sizeof(char));
+	}
+	if (!alloc_data)
+	{
+		free(data);
+		return EINA_FALSE;
+	}
+	if (!enesim_buffer_sw_data_set(&data->data, fmt, alloc_data, stride))
+	{
+		if (data->map)
+			munmap(data->map, data->len);
+		else
+			free(alloc_data);
+		free(data);
+		return EINA_FALSE;
+	}
+
+	*backend = ENESIM_BACKEND_SOFTWARE;
+	*backend_data = data;
+	return EINA_TRUE;
+}
+
+static void _data_free(void *prv EINA_UNUSED,
+		void *backend_data,
+		Enesim_Buffer_Format fmt,
+		Eina_Bool external_allocated)
+{
+	Enesim_Pool_Huge_Data *data = backend_data;
+
+	if (data->map)
+		munmap(data->map, data->len);
+	else if (!external_allocated)
+		enesim_buffer_sw_data_free(&data->data, fmt, _data_free_cb, NULL);
+	free(data);
+}
+
+/* The external pixels are used as is, only the copies get their own
+ * mapping
+ */
+static Eina_Bool _data_from(void *prv,
+		Enesim_Backend *backend,
+		void **backend_data,
+		Enesim_Buffer_Format fmt,
+		uint32_t w, uint32_t h,
+		Eina_Bool copy,
+		Enesim_Buffer_Sw_Data *src)
+{
+	Enesim_Pool_Huge_Data *data;
+
+	if (copy)
+	{
+		if (!_data_alloc(prv, backend, backend_data, fmt, w, h))
+			return EINA_FALSE;
+		data = *backend_data;
+		if (!enesim_buffer_sw_data_copy(&data->data, src, fmt, w, h))
+		{
+			_data_free(prv, data, fmt, EINA_FALSE);
+			return EINA_FALSE;
+		}
+		return EINA_TRUE;
+	}
+
+	data = calloc(1, sizeof(Enesim_Pool_Huge_Data));
+	data->data = *src;
+	*backend = ENESIM_BACKEND_SOFTWARE;
+	*backend_data = data;
+
+	return EINA_TRUE;
+}
+
+static Eina_Bool _data_get(void *prv EINA_UNUSED,
+		void *backend_data,
+		Enesim_Buffer_Format fmt EINA_UNUSED,
+		uint32_t w EINA_UNUSED, uint32_t h EINA_UNUSED,
+		Enesim_Buffer_Sw_Data *dst)
+{
+	Enesim_Pool_Huge_Data *data = backend_data;
+
+	*dst = data->data;
+
+	return EINA_TRUE;
+}
+
+static void _free(void *prv)
+{
+	Enesim_Pool_Huge *thiz = prv;
+
+	free(thiz);
+}
+
+static Enesim_Pool_Descriptor _descriptor = {
+	/* .type_get =   */ _type_get,
+	/* .data_alloc = */ _data_alloc,
+	/* .data_free =  */ _data_free,
+	/* .data_from =  */ _data_from,
+	/* .data_get =   */ _data_get,
+	/* .data_put =   */ NULL,
+	/* .free =       */ _free,
+};
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+/** @endcond */
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Create a pool that allocates the big buffers on huge pages
+ * @param[in] hugetlb Use the huge pages reserved on the system when
+ * available instead of the transparent ones
+ * @return The newly allocated pool
+ *
+ * Every buffer of at least one megabyte gets its own mapping, aligned and
+ * rounded to the huge page size, which reduces the TLB misses when
+ * rendering big surfaces. On systems with several NUMA nodes the pages are
+ * interleaved between the nodes, as every rendering thread writes to every
+ * part of the surface. Smaller buffers are allocated on the heap.
+ * Use enesim_pool_default_set() to allocate every surface with it.
+ */
+EAPI Enesim_Pool * enesim_pool_huge_new(Eina_Bool hugetlb)
+{
+	Enesim_Pool_Huge *thiz;
+	Enesim_Pool *p;
+
+	thiz = calloc(1, sizeof(Enesim_Pool_Huge));
+	thiz->hugetlb = hugetlb;
+#if ENESIM_POOL_HUGE_NUMA
+	_numa_nodes_get(thiz);
+#endif
+
+	p = enesim_pool_new(&_descriptor, thiz);
+	if (!p)
+	{
+		free(thiz);
+		return NULL;
+	}
+
+	return p;
+}
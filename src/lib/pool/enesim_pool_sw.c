@@ -30,13 +30,178 @@
 /** @cond internal */
 #define ENESIM_LOG_DEFAULT enesim_log_pool
 
+/* the smallest size class */
+#define ENESIM_POOL_SW_CLASS_MIN_SHIFT 6
+/* the number of size classes on every power of two */
+#define ENESIM_POOL_SW_CLASS_STEPS_SHIFT 2
+#define ENESIM_POOL_SW_CLASSES ((sizeof(size_t) * 8) << ENESIM_POOL_SW_CLASS_STEPS_SHIFT)
+/* default number of bytes kept on the free lists */
+#define ENESIM_POOL_SW_CACHE_SIZE (32 * 1024 * 1024)
+
+typedef struct _Enesim_Pool_Sw_Block Enesim_Pool_Sw_Block;
+
+/* a free block, the link is stored on the pixels themselves */
+struct _Enesim_Pool_Sw_Block
+{
+	Enesim_Pool_Sw_Block *next;
+};
+
+typedef struct _Enesim_Pool_Sw_Data
+{
+	/* must be the first, the backend data is used as the sw data */
+	Enesim_Buffer_Sw_Data data;
+	/* the recyclable block, NULL in case of data set by the user */
+	void *block;
+	unsigned int sclass;
+} Enesim_Pool_Sw_Data;
+
+typedef struct _Enesim_Pool_Sw
+{
+	Eina_Lock lock;
+	/* the allocator for new blocks */
+	Eina_Mempool *mp;
+	Enesim_Pool_Sw_Block *free[ENESIM_POOL_SW_CLASSES];
+	size_t cache_size;
+	Enesim_Pool_Sw_Stats stats;
+} Enesim_Pool_Sw;
+
 static Enesim_Pool *_sw_pool = NULL;
+static Enesim_Pool_Sw _sw;
 
 static void _data_free_cb(void *data, void *user_data EINA_UNUSED)
 {
 	free(data);
 }
 
+/* Round a size up to its class, there are four classes on every power of
+ * two, so at most a quarter of a block is wasted
+ */
+static unsigned int _size_class_get(size_t bytes, size_t *csize)
+{
+	unsigned int shift = ENESIM_POOL_SW_CLASS_MIN_SHIFT;
+	unsigned int steps = ENESIM_POOL_SW_CLASS_STEPS_SHIFT;
+	size_t n;
+
+	if (bytes <= ((size_t)1 << shift))
+	{
+		*csize = (size_t)1 << shift;
+		return 0;
+	}
+	while (((bytes - 1) >> (shift + 1)))
+		shift++;
+	n = ((bytes - 1) >> (shift - steps)) + 1;
+	*csize = n << (shift - steps);
+	return ((shift - ENESIM_POOL_SW_CLASS_MIN_SHIFT) << steps) + n -
+			(1 << steps);
+}
+
+static size_t _size_class_size(unsigned int sclass)
+{
+	unsigned int steps = ENESIM_POOL_SW_CLASS_STEPS_SHIFT;
+	unsigned int shift;
+	size_t n;
+
+	if (!sclass)
+		return (size_t)1 << ENESIM_POOL_SW_CLASS_MIN_SHIFT;
+	shift = ENESIM_POOL_SW_CLASS_MIN_SHIFT + ((sclass - 1) >> steps);
+	n = ((sclass - 1) & ((1 << steps) - 1)) + (1 << steps) + 1;
+	return n << (shift - steps);
+}
+
+static void * _block_new(size_t size)
+{
+	if (_sw.mp)
+		return eina_mempool_malloc(_sw.mp, size);
+	return malloc(size);
+}
+
+static void _block_free(void *block)
+{
+	if (_sw.mp)
+		eina_mempool_free(_sw.mp, block);
+	else
+		free(block);
+}
+
+/* must be called with the lock taken */
+static void _trim(size_t size)
+{
+	int i;
+
+	/* release the biggest blocks first */
+	for (i = ENESIM_POOL_SW_CLASSES - 1; i >= 0 && _sw.stats.cached > size; i--)
+	{
+		size_t csize = _size_class_size(i);
+
+		while (_sw.free[i] && _sw.stats.cached > size)
+		{
+			Enesim_Pool_Sw_Block *b = _sw.free[i];
+
+			_sw.free[i] = b->next;
+			_sw.stats.cached -= csize;
+			_block_free(b);
+		}
+	}
+}
+
+static void * _block_get(size_t bytes, unsigned int *sclass)
+{
+	Enesim_Pool_Sw_Block *b;
+	size_t csize;
+	unsigned int c;
+
+	c = _size_class_get(bytes, &csize);
+	eina_lock_take(&_sw.lock);
+	_sw.stats.allocs++;
+	b = _sw.free[c];
+	if (b)
+	{
+		_sw.free[c] = b->next;
+		_sw.stats.cached -= csize;
+		_sw.stats.reuses++;
+	}
+	else
+	{
+		b = _block_new(csize);
+		/* under memory pressure give back every cached block and
+		 * try again
+		 */
+		if (!b && _sw.stats.cached)
+		{
+			_trim(0);
+			b = _block_new(csize);
+		}
+	}
+	if (b)
+		_sw.stats.used += csize;
+	eina_lock_release(&_sw.lock);
+
+	*sclass = c;
+	return b;
+}
+
+static void _block_put(void *block, unsigned int sclass)
+{
+	Enesim_Pool_Sw_Block *b = block;
+	size_t csize;
+
+	csize = _size_class_size(sclass);
+	eina_lock_take(&_sw.lock);
+	_sw.stats.used -= csize;
+	if (csize > _sw.cache_size)
+	{
+		_block_free(b);
+	}
+	else
+	{
+		_trim(_sw.cache_size - csize);
+		b->next = _sw.free[sclass];
+		_sw.free[sclass] = b;
+		_sw.stats.cached += csize;
+	}
+	eina_lock_release(&_sw.lock);
+}
+
 /*----------------------------------------------------------------------------*
  *                        The Enesim's pool interface                         *
  *----------------------------------------------------------------------------*/
@@ -50,63 +215,92 @@ static Eina_Bool _data_alloc(void *prv EINA_UNUSED,
 		void **backend_data,
 		Enesim_Buffer_Format fmt, uint32_t w, uint32_t h)
 {
-	Enesim_Buffer_Sw_Data *data;
-	Eina_Bool ret;
+	Enesim_Pool_Sw_Data *data;
+	size_t bytes;
+	int stride;
+	void *block;
 
-	data = malloc(sizeof(Enesim_Buffer_Sw_Data));
-	*backend = ENESIM_BACKEND_SOFTWARE;
-	*backend_data = data;
-	ret = enesim_buffer_sw_data_alloc(data, fmt, w, h);
-	if (!ret)
+	bytes = enesim_buffer_format_size_get(fmt, w, h);
+	stride = enesim_buffer_format_size_get(fmt, w, 1);
+	data = malloc(sizeof(Enesim_Pool_Sw_Data));
+	block = _block_get(bytes, &data->sclass);
+	if (!block)
+	{
+		free(data);
+		return EINA_FALSE;
+	}
+	if (!enesim_buffer_sw_data_set(&data->data, fmt, block, stride))
 	{
+		_block_put(block, data->sclass);
 		free(data);
+		return EINA_FALSE;
 	}
-	return ret;
+	/* recycled blocks keep the old pixels, buffers always start cleared */
+	memset(block, 0, bytes);
+	data->block = block;
+
+	*backend = ENESIM_BACKEND_SOFTWARE;
+	*backend_data = data;
+	return EINA_TRUE;
 }
 
-static Eina_Bool _data_from(void *prv EINA_UNUSED,
+static void _data_free(void *prv EINA_UNUSED, void *backend_data,
+		Enesim_Buffer_Format fmt,
+		Eina_Bool external_allocated)
+{
+	Enesim_Pool_Sw_Data *data = backend_data;
+
+	if (data->block)
+		_block_put(data->block, data->sclass);
+	else if (!external_allocated)
+		enesim_buffer_sw_data_free(&data->data, fmt, _data_free_cb, NULL);
+	free(data);
+}
+
+static Eina_Bool _data_from(void *prv,
 		Enesim_Backend *backend,
 		void **backend_data,
-		Enesim_Buffer_Format fmt EINA_UNUSED,
-		uint32_t w EINA_UNUSED, uint32_t h EINA_UNUSED,
+		Enesim_Buffer_Format fmt,
+		uint32_t w, uint32_t h,
 		Eina_Bool copy,
 		Enesim_Buffer_Sw_Data *src)
 {
 	if (copy)
 	{
-		ERR("Can't copy data TODO");
-		return EINA_FALSE;
+		Enesim_Pool_Sw_Data *data;
+
+		if (!_data_alloc(prv, backend, backend_data, fmt, w, h))
+			return EINA_FALSE;
+		data = *backend_data;
+		if (!enesim_buffer_sw_data_copy(&data->data, src, fmt, w, h))
+		{
+			_data_free(prv, data, fmt, EINA_FALSE);
+			return EINA_FALSE;
+		}
+		return EINA_TRUE;
 	}
 	else
 	{
-		Enesim_Buffer_Sw_Data *data;
+		Enesim_Pool_Sw_Data *data;
 
 		*backend = ENESIM_BACKEND_SOFTWARE;
-		data = malloc(sizeof(Enesim_Buffer_Sw_Data));
+		data = malloc(sizeof(Enesim_Pool_Sw_Data));
 		*backend_data = data;
-		*data = *src;
+		data->data = *src;
+		data->block = NULL;
+		data->sclass = 0;
 
 		return EINA_TRUE;
 	}
 }
 
-static void _data_free(void *prv EINA_UNUSED, void *backend_data,
-		Enesim_Buffer_Format fmt,
-		Eina_Bool external_allocated)
-{
-	Enesim_Buffer_Sw_Data *data = backend_data;
-	if (!external_allocated)
-		enesim_buffer_sw_data_free(data, fmt, _data_free_cb, NULL);
-	free(data);
-}
-
 static Eina_Bool _data_get(void *prv EINA_UNUSED, void *backend_data,
 		Enesim_Buffer_Format fmt EINA_UNUSED,
 		uint32_t w EINA_UNUSED, uint32_t h EINA_UNUSED,
 		Enesim_Buffer_Sw_Data *dst)
 {
-	Enesim_Buffer_Sw_Data *data = backend_data;
-	*dst = *data;
+	Enesim_Pool_Sw_Data *data = backend_data;
+	*dst = data->data;
 
 	return EINA_TRUE;
 }
@@ -127,6 +321,10 @@ static Enesim_Pool_Descriptor _sw_descriptor = {
 
 void enesim_pool_sw_init(void)
 {
+	eina_lock_new(&_sw.lock);
+	/* cache line aligned blocks, fallback to malloc otherwise */
+	_sw.mp = eina_mempool_add("aligned", "enesim.pool.sw", NULL);
+	_sw.cache_size = ENESIM_POOL_SW_CACHE_SIZE;
 	_sw_pool = enesim_pool_new(&_sw_descriptor, NULL);
 }
 
@@ -134,6 +332,16 @@ void enesim_pool_sw_shutdown(void)
 {
 	/* destroy the default pool */
 	enesim_pool_unref(_sw_pool);
+	/* release the cached blocks */
+	eina_lock_take(&_sw.lock);
+	_trim(0);
+	eina_lock_release(&_sw.lock);
+	if (_sw.mp)
+	{
+		eina_mempool_del(_sw.mp);
+		_sw.mp = NULL;
+	}
+	eina_lock_free(&_sw.lock);
 }
 
 /** @endcond */
@@ -149,3 +357,61 @@ EAPI Enesim_Pool * enesim_pool_sw_new(void)
 	return enesim_pool_ref(_sw_pool);
 }
 
+/**
+ * @brief Set the maximum number of bytes the Sw pool keeps for reuse
+ * @param[in] size The size in bytes
+ *
+ * The pixels of the buffers created by the Sw pool are not released when
+ * the buffer is destroyed but kept on a set of free lists, one for every
+ * size class, to be reused by the next buffer of a similar size. Once the
+ * free lists exceed @p size the biggest blocks are released.
+ * A size of zero disables the recycling.
+ */
+EAPI void enesim_pool_sw_cache_size_set(size_t size)
+{
+	eina_lock_take(&_sw.lock);
+	_sw.cache_size = size;
+	_trim(size);
+	eina_lock_release(&_sw.lock);
+}
+
+/**
+ * @brief Get the maximum number of bytes the Sw pool keeps for reuse
+ * @return The size in bytes
+ */
+EAPI size_t enesim_pool_sw_cache_size_get(void)
+{
+	size_t ret;
+
+	eina_lock_take(&_sw.lock);
+	ret = _sw.cache_size;
+	eina_lock_release(&_sw.lock);
+
+	return ret;
+}
+
+/**
+ * @brief Release the blocks kept for reuse by the Sw pool
+ * @param[in] size The number of bytes to keep
+ *
+ * Useful to give memory back to the system under memory pressure.
+ */
+EAPI void enesim_pool_sw_trim(size_t size)
+{
+	eina_lock_take(&_sw.lock);
+	_trim(size);
+	eina_lock_release(&_sw.lock);
+}
+
+/**
+ * @brief Get the statistics of the Sw pool
+ * @param[out] stats The statistics
+ */
+EAPI void enesim_pool_sw_stats_get(Enesim_Pool_Sw_Stats *stats)
+{
+	if (!stats) return;
+
+	eina_lock_take(&_sw.lock);
+	*stats = _sw.stats;
+	eina_lock_release(&_sw.lock);
+}
@@ -15,6 +15,7 @@ src/lib/renderer/enesim_renderer_gradient_radial.h \
 src/lib/renderer/enesim_renderer_grid.h \
 src/lib/renderer/enesim_renderer_image.h \
 src/lib/renderer/enesim_renderer_importer.h \
+src/lib/renderer/enesim_renderer_layer.h \
 src/lib/renderer/enesim_renderer_line.h \
 src/lib/renderer/enesim_renderer_map_quad.h \
 src/lib/renderer/enesim_renderer_path.h \
@@ -26,6 +27,7 @@ src/lib/renderer/enesim_renderer_rectangle.h \
 src/lib/renderer/enesim_renderer_shape.h \
 src/lib/renderer/enesim_renderer_stripes.h \
 src/lib/renderer/enesim_renderer_transition.h \
+src/lib/renderer/enesim_renderer_text_grid.h \
 src/lib/renderer/enesim_renderer_text_span.h
 
 src_lib_libenesim_la_SOURCES += \
@@ -44,6 +46,7 @@ src/lib/renderer/enesim_renderer_gradient_linear.c \
 src/lib/renderer/enesim_renderer_grid.c \
 src/lib/renderer/enesim_renderer_image.c \
 src/lib/renderer/enesim_renderer_importer.c \
+src/lib/renderer/enesim_renderer_layer.c \
 src/lib/renderer/enesim_renderer_line.c \
 src/lib/renderer/enesim_renderer_map_quad.c \
 src/lib/renderer/enesim_renderer_path.c \
@@ -58,6 +61,7 @@ src/lib/renderer/enesim_renderer_shape_private.h \
 src/lib/renderer/enesim_renderer_shape_path.c \
 src/lib/renderer/enesim_renderer_shape_path_private.h \
 src/lib/renderer/enesim_renderer_stripes.c \
+src/lib/renderer/enesim_renderer_text_grid.c \
 src/lib/renderer/enesim_renderer_text_span.c \
 src/lib/renderer/enesim_renderer_transition.c
 
@@ -91,8 +91,7 @@ typedef struct _Enesim_Renderer_Blur_Class {
 } Enesim_Renderer_Blur_Class;
 
 static Eina_Bool _blur_state_setup(Enesim_Renderer_Blur *thiz,
-		Enesim_Renderer *r, Enesim_Surface *s, Enesim_Rop rop,
-		Enesim_Log **l)
+		Enesim_Renderer *r, Enesim_Surface *s, Enesim_Log **l)
 {
 	if (!thiz->src && !thiz->src_r)
 	{
@@ -105,7 +104,8 @@ static Eina_Bool _blur_state_setup(Enesim_Renderer_Blur *thiz,
 	{
 		Enesim_Renderer *old_r;
 
-		if (!enesim_renderer_setup(thiz->src_r, s, rop, l))
+		/* the source is drawn on the cache */
+		if (!enesim_renderer_setup(thiz->src_r, s, ENESIM_ROP_FILL, l))
 			return EINA_FALSE;
 		enesim_draw_cache_renderer_get(thiz->cache, &old_r);
 		if (old_r != thiz->src_r)
@@ -498,7 +498,7 @@ static const char * _blur_name(Enesim_Renderer *r EINA_UNUSED)
 }
 
 static Eina_Bool _blur_sw_setup(Enesim_Renderer *r,
-		Enesim_Surface *s, Enesim_Rop rop, 
+		Enesim_Surface *s, Enesim_Rop rop EINA_UNUSED,
 		Enesim_Renderer_Sw_Fill *fill, Enesim_Log **l)
 {
 	Enesim_Renderer_Blur *thiz;
@@ -506,10 +506,22 @@ static Eina_Bool _blur_sw_setup(Enesim_Renderer *r,
 
 	thiz = ENESIM_RENDERER_BLUR(r);
 	thiz->color = enesim_renderer_color_get(r);
-	if (!_blur_state_setup(thiz, r, s, rop, l))
+	if (!_blur_state_setup(thiz, r, s, l))
 		return EINA_FALSE;
 	if (thiz->src_r)
-		enesim_draw_cache_setup_sw(thiz->cache, ENESIM_FORMAT_ARGB8888, NULL);
+	{
+		/* draw the damages now with the threads of the source instead
+		 * of span by span from the fill functions
+		 */
+		if (!enesim_draw_cache_setup_sw(thiz->cache, ENESIM_FORMAT_ARGB8888, NULL) ||
+				!enesim_draw_cache_refresh_sw(thiz->cache))
+		{
+			ENESIM_RENDERER_LOG(r, l, "Source renderer %s can not be drawn",
+					enesim_renderer_name_get(thiz->src_r));
+			_blur_state_cleanup(thiz, r, s);
+			return EINA_FALSE;
+		}
+	}
 	else
 	{
 		if (!enesim_surface_map(thiz->src, (void **)&thiz->ssrc, &thiz->sstride))
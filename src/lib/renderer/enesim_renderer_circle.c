@@ -88,7 +88,7 @@ static Eina_Bool _circle_setup(Enesim_Renderer *r, Enesim_Path *path)
 	Enesim_Renderer_Circle *thiz;
 
 	thiz = ENESIM_RENDERER_CIRCLE(r);
-	if (_circle_properties_have_changed(thiz) && !thiz->generated)
+	if (!thiz->generated)
 	{
 		Enesim_Renderer_Shape_Draw_Mode draw_mode;
 		double rad;
@@ -211,6 +211,11 @@ static void _enesim_renderer_circle_class_init(void *k)
 
 static void _enesim_renderer_circle_instance_init(void *o)
 {
+	Enesim_Renderer_Circle *thiz;
+
+	thiz = ENESIM_RENDERER_CIRCLE(o);
+	/* nothing to generate until a property is set */
+	thiz->generated = EINA_TRUE;
 	/* to maintain compatibility */
 	enesim_renderer_shape_stroke_location_set(ENESIM_RENDERER(o),
 			ENESIM_RENDERER_SHAPE_STROKE_LOCATION_INSIDE);
@@ -106,6 +106,7 @@ static inline void _compound_layer_remove(Enesim_Renderer_Compound *thiz,
 {
 	thiz->removed = eina_list_append(thiz->removed, l);
 	thiz->changed = EINA_TRUE;
+	l->owner = NULL;
 }
 
 static inline void _compound_layer_sw_hints_merge(Enesim_Renderer_Compound_Layer *l, Enesim_Rop rop,
@@ -1095,6 +1096,7 @@ EAPI void enesim_renderer_compound_layer_add(Enesim_Renderer *r,
 	thiz = ENESIM_RENDERER_COMPOUND(r);
 	thiz->added = eina_list_append(thiz->added, layer);
 	thiz->changed = EINA_TRUE;
+	layer->owner = r;
 }
 
 /**
@@ -1117,6 +1119,7 @@ EAPI void enesim_renderer_compound_layer_prepend(Enesim_Renderer *r,
 	thiz = ENESIM_RENDERER_COMPOUND(r);
 	thiz->added = eina_list_prepend(thiz->added, layer);
 	thiz->changed = EINA_TRUE;
+	layer->owner = r;
 }
 
 /**
@@ -139,7 +139,7 @@ static Eina_Bool _ellipse_setup(Enesim_Renderer *r, Enesim_Path *path)
 		return EINA_FALSE;
 	}
 
-	if (_ellipse_properties_have_changed(thiz) && !thiz->generated)
+	if (!thiz->generated)
 	{
 		enesim_path_command_clear(path);
 		enesim_path_move_to(path, x, y - ry);
@@ -147,6 +147,7 @@ static Eina_Bool _ellipse_setup(Enesim_Renderer *r, Enesim_Path *path)
 		enesim_path_arc_to(path, rx, ry, 0, EINA_FALSE, EINA_TRUE, x, y + ry);
 		enesim_path_arc_to(path, rx, ry, 0, EINA_FALSE, EINA_TRUE, x - rx, y);
 		enesim_path_arc_to(path, rx, ry, 0, EINA_FALSE, EINA_TRUE, x, y - ry);
+		thiz->generated = EINA_TRUE;
 	}
 	return EINA_TRUE;
 }
@@ -225,6 +226,11 @@ static void _enesim_renderer_ellipse_class_init(void *k)
 
 static void _enesim_renderer_ellipse_instance_init(void *o)
 {
+	Enesim_Renderer_Ellipse *thiz;
+
+	thiz = ENESIM_RENDERER_ELLIPSE(o);
+	/* nothing to generate until a property is set */
+	thiz->generated = EINA_TRUE;
 	/* to maintain compatibility */
 	enesim_renderer_shape_stroke_location_set(ENESIM_RENDERER(o),
 			ENESIM_RENDERER_SHAPE_STROKE_LOCATION_INSIDE);
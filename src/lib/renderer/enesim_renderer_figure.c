@@ -55,6 +55,10 @@ typedef struct _Enesim_Renderer_Figure
 	/* properties */
 	Enesim_Figure *figure;
 	int last_figure_change;
+	/* the change the path commands were generated for, the cleanup
+	 * commits the last change even when the renderer was kept prepared
+	 */
+	int generated_figure_change;
 } Enesim_Renderer_Figure;
 
 typedef struct _Enesim_Renderer_Figure_Class {
@@ -127,9 +131,10 @@ static Eina_Bool _figure_setup(Enesim_Renderer *r, Enesim_Path *path)
 		return EINA_FALSE;
 	}
 
-	if (thiz->last_figure_change != enesim_figure_changed(thiz->figure))
+	if (thiz->generated_figure_change != enesim_figure_changed(thiz->figure))
 	{
 		_figure_generate_commands(thiz, path);
+		thiz->generated_figure_change = enesim_figure_changed(thiz->figure);
 	}
 
 	return EINA_TRUE;
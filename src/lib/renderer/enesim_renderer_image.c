@@ -42,6 +42,7 @@
 #endif
 
 #include "enesim_color_private.h"
+#include "enesim_coord_private.h"
 #include "enesim_renderer_private.h"
 /**
  * @todo
@@ -83,6 +84,11 @@ typedef struct _Enesim_Renderer_Image
 	Eina_F16p16 mxx, myy;
 	Eina_F16p16 nxx, nyy;
 	Enesim_Matrix_F16p16 matrix;
+	/* the same inverse matrix and translation on full precision */
+	Enesim_Matrix dmatrix;
+	double dxx, dyy;
+	Enesim_Coord_Matrix cmatrix;
+	Enesim_Coord cxx, cyy;
 	Enesim_Compositor_Span span;
 #if BUILD_OPENGL
 	struct {
@@ -312,10 +318,11 @@ static void _image_fill_argb8888_no_scale_affine_fast(Enesim_Renderer *r,
 		int x, int y, int len, void *ddata)
 {
 	Enesim_Renderer_Image *thiz = ENESIM_RENDERER_IMAGE(r);
+	const Enesim_Coord_Matrix *m = &thiz->cmatrix;
 	uint32_t *dst = ddata, *end = dst + len;
 	uint32_t *src = thiz->src;
 	int sw = thiz->sw, sh = thiz->sh;
-	Eina_F16p16 xx, yy;
+	Enesim_Coord xx, yy;
 	Enesim_Color color = thiz->color;
 
 	if (!color)
@@ -326,19 +333,17 @@ static void _image_fill_argb8888_no_scale_affine_fast(Enesim_Renderer *r,
 	if (color == 0xffffffff)
 		color = 0;
 
-	xx = (thiz->matrix.xx * x) + (thiz->matrix.xx >> 1) +
-		(thiz->matrix.xy * y) + (thiz->matrix.xy >> 1) +
-		thiz->matrix.xz - 32768 - thiz->ixx;
-	yy = (thiz->matrix.yx * x) + (thiz->matrix.yx >> 1) +
-		(thiz->matrix.yy * y) + (thiz->matrix.yy >> 1) +
-		thiz->matrix.yz - 32768 - thiz->iyy;
+	xx = (m->xx * x) + (m->xx >> 1) + (m->xy * y) + (m->xy >> 1) +
+		m->xz - ENESIM_COORD_HALF - thiz->cxx;
+	yy = (m->yx * x) + (m->yx >> 1) + (m->yy * y) + (m->yy >> 1) +
+		m->yz - ENESIM_COORD_HALF - thiz->cyy;
 
 	while (dst < end)
 	{
 		uint32_t p0 = 0;
 
-		x = eina_f16p16_int_to(xx);
-		y = eina_f16p16_int_to(yy);
+		x = enesim_coord_int_to(xx);
+		y = enesim_coord_int_to(yy);
 
 		if (((unsigned)x < (unsigned)sw) & ((unsigned)y < (unsigned)sh))
 		{
@@ -346,7 +351,7 @@ static void _image_fill_argb8888_no_scale_affine_fast(Enesim_Renderer *r,
 			if (color && p0)
 				p0 = enesim_color_mul4_sym(p0, color);
 		}
-		*dst++ = p0;  xx += thiz->matrix.xx;  yy += thiz->matrix.yx;
+		*dst++ = p0;  xx += m->xx;  yy += m->yx;
 	}
 }
 
@@ -489,10 +494,11 @@ static void _image_fill_argb8888_no_scale_affine(Enesim_Renderer *r,
 		int x, int y, int len, void *ddata)
 {
 	Enesim_Renderer_Image *thiz = ENESIM_RENDERER_IMAGE(r);
-	uint32_t *dst = ddata, *end = dst + len;
+	Enesim_Coord_Stepper stepper;
+	uint32_t *dst = ddata;
 	uint32_t *src = thiz->src;
 	int sw = thiz->sw, sh = thiz->sh;
-	Eina_F16p16 xx, yy;
+	int offset;
 	Enesim_Color color = thiz->color;
 
 	if (!color)
@@ -503,49 +509,60 @@ static void _image_fill_argb8888_no_scale_affine(Enesim_Renderer *r,
 	if (color == 0xffffffff)
 		color = 0;
 
-	xx = (thiz->matrix.xx * x) + (thiz->matrix.xx >> 1) +
-		(thiz->matrix.xy * y) + (thiz->matrix.xy >> 1) +
-		thiz->matrix.xz - 32768 - thiz->ixx;
-	yy = (thiz->matrix.yx * x) + (thiz->matrix.yx >> 1) +
-		(thiz->matrix.yy * y) + (thiz->matrix.yy >> 1) +
-		thiz->matrix.yz - 32768 - thiz->iyy;
-
-	while (dst < end)
+	/* sample on the center of the pixels */
+	enesim_coord_stepper_affine_setup(&stepper, x + 0.5, y + 0.5,
+			thiz->dxx + 0.5, thiz->dyy + 0.5, &thiz->dmatrix);
+	for (offset = 0; offset < len; offset += ENESIM_COORD_STEPPER_CHUNK)
 	{
-		uint32_t p0 = 0;
+		double xs[ENESIM_COORD_STEPPER_CHUNK];
+		double ys[ENESIM_COORD_STEPPER_CHUNK];
+		int i, n;
 
-		x = eina_f16p16_int_to(xx);
-		y = eina_f16p16_int_to(yy);
+		n = len - offset;
+		if (n > ENESIM_COORD_STEPPER_CHUNK)
+			n = ENESIM_COORD_STEPPER_CHUNK;
+		enesim_coord_stepper_get(&stepper, offset, n, xs, ys);
 
-		if ( (((unsigned) (x + 1)) < ((unsigned) (sw + 1))) & (((unsigned) (y + 1)) < ((unsigned) (sh + 1))) )
+		for (i = 0; i < n; i++)
 		{
-			uint32_t *p = src + (y * sw) + x;
-			uint32_t p1 = 0, p2 = 0, p3 = 0;
+			uint32_t p0 = 0;
+			double fx = floor(xs[i]);
+			double fy = floor(ys[i]);
 
-			if ((x > -1) && (y > - 1))
-				p0 = *p;
-			if ((y > -1) && ((x + 1) < sw))
-				p1 = *(p + 1);
-			if ((y + 1) < sh)
-			{
-				if (x > -1)
-					p2 = *(p + sw);
-				if ((x + 1) < sw)
-					p3 = *(p + sw + 1);
-			}
-			if (p0 | p1 | p2 | p3)
+			/* compare before converting, the coordinates might not fit */
+			if ((fx >= -1) && (fx < sw) && (fy >= -1) && (fy < sh))
 			{
-				uint16_t ax = 1 + ((xx & 0xffff) >> 8);
-				uint16_t ay = 1 + ((yy & 0xffff) >> 8);
+				uint32_t *p;
+				uint32_t p1 = 0, p2 = 0, p3 = 0;
+
+				x = (int)fx;
+				y = (int)fy;
+				p = src + (y * sw) + x;
+				if ((x > -1) && (y > - 1))
+					p0 = *p;
+				if ((y > -1) && ((x + 1) < sw))
+					p1 = *(p + 1);
+				if ((y + 1) < sh)
+				{
+					if (x > -1)
+						p2 = *(p + sw);
+					if ((x + 1) < sw)
+						p3 = *(p + sw + 1);
+				}
+				if (p0 | p1 | p2 | p3)
+				{
+					uint16_t ax = 1 + (int)((xs[i] - fx) * 256);
+					uint16_t ay = 1 + (int)((ys[i] - fy) * 256);
 
-				p0 = enesim_color_interp_256(ax, p1, p0);
-				p2 = enesim_color_interp_256(ax, p3, p2);
-				p0 = enesim_color_interp_256(ay, p2, p0);
-				if (color && p0)
-					p0 = enesim_color_mul4_sym(p0, color);
+					p0 = enesim_color_interp_256(ax, p1, p0);
+					p2 = enesim_color_interp_256(ax, p3, p2);
+					p0 = enesim_color_interp_256(ay, p2, p0);
+					if (color && p0)
+						p0 = enesim_color_mul4_sym(p0, color);
+				}
 			}
+			*dst++ = p0;
 		}
-		*dst++ = p0;  xx += thiz->matrix.xx;  yy += thiz->matrix.yx;
 	}
 }
 
@@ -1505,6 +1522,7 @@ static Eina_Bool _image_sw_state_setup(Enesim_Renderer *r,
 	/* use the inverse matrix */
 	enesim_matrix_inverse(&m, &m);
 	enesim_matrix_matrix_f16p16_to(&m, &thiz->matrix);
+	thiz->dmatrix = m;
 	mtype = enesim_matrix_f16p16_type_get(&thiz->matrix);
 	if (mtype != ENESIM_MATRIX_TYPE_IDENTITY)
 	{
@@ -1521,6 +1539,8 @@ static Eina_Bool _image_sw_state_setup(Enesim_Renderer *r,
 			w *= sx;  h *= sy;  x *= sx;  y *= sy;
 			thiz->matrix.xx *= sx; thiz->matrix.xy *= sx; thiz->matrix.xz *= sx;
 			thiz->matrix.yx *= sy; thiz->matrix.yy *= sy; thiz->matrix.yz *= sy;
+			thiz->dmatrix.xx *= sx; thiz->dmatrix.xy *= sx; thiz->dmatrix.xz *= sx;
+			thiz->dmatrix.yx *= sy; thiz->dmatrix.yy *= sy; thiz->dmatrix.yz *= sy;
 			mtype = enesim_matrix_f16p16_type_get(&thiz->matrix);
 		}
 	}
@@ -1536,6 +1556,11 @@ static Eina_Bool _image_sw_state_setup(Enesim_Renderer *r,
 	thiz->ihh = (h * 65536);
 	thiz->ixx = 65536 * (x + ox);
 	thiz->iyy = 65536 * (y + oy);
+	thiz->dxx = x + ox;
+	thiz->dyy = y + oy;
+	enesim_coord_matrix_from(&thiz->cmatrix, &thiz->dmatrix);
+	thiz->cxx = enesim_coord_double_from(thiz->dxx);
+	thiz->cyy = enesim_coord_double_from(thiz->dyy);
 	thiz->mxx = 65536;  thiz->myy = 65536;
 	thiz->nxx = 65536;  thiz->nyy = 65536;
 
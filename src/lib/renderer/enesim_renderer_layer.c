@@ -0,0 +1,470 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_private.h"
+
+#include "enesim_main.h"
+#include "enesim_log.h"
+#include "enesim_color.h"
+#include "enesim_rectangle.h"
+#include "enesim_matrix.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+#include "enesim_format.h"
+#include "enesim_surface.h"
+#include "enesim_renderer.h"
+#include "enesim_renderer_layer.h"
+#include "enesim_object_descriptor.h"
+#include "enesim_object_class.h"
+#include "enesim_object_instance.h"
+
+#include "enesim_color_private.h"
+#include "enesim_renderer_private.h"
+#include "enesim_draw_cache_private.h"
+#include "enesim_coord_private.h"
+/*
+ * The source renderer is drawn into a surface of the size of its
+ * destination bounds and only the damaged areas of it are drawn again.
+ * Every draw of the layer just copies the pixels of that surface, moved
+ * by the origin of the layer
+ */
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_RENDERER_LAYER(o) ENESIM_OBJECT_INSTANCE_CHECK(o,		\
+		Enesim_Renderer_Layer,						\
+		enesim_renderer_layer_descriptor_get())
+
+typedef struct _Enesim_Renderer_Layer {
+	Enesim_Renderer parent;
+	/* the properties */
+	Enesim_Renderer *src_r;
+	Enesim_Pool *pool;
+	/* private */
+	Enesim_Draw_Cache *cache;
+	Eina_Bool changed;
+	/* generated at state setup */
+	Eina_Rectangle bounds;
+	uint32_t *sdata;
+	size_t sstride;
+	double ox;
+	double oy;
+	int ix;
+	int iy;
+} Enesim_Renderer_Layer;
+
+typedef struct _Enesim_Renderer_Layer_Class {
+	Enesim_Renderer_Class parent;
+} Enesim_Renderer_Layer_Class;
+
+typedef struct _Enesim_Renderer_Layer_Damage
+{
+	Enesim_Renderer *r;
+	Enesim_Renderer_Damage real_cb;
+	void *real_data;
+	double ox;
+	double oy;
+} Enesim_Renderer_Layer_Damage;
+
+/* move the damages of the source by the origin of the layer */
+static Eina_Bool _layer_damage_cb(Enesim_Renderer *r EINA_UNUSED,
+		const Eina_Rectangle *area, Eina_Bool past, void *data)
+{
+	Enesim_Renderer_Layer_Damage *ddata = data;
+	Enesim_Rectangle moved;
+	Eina_Rectangle damage;
+
+	enesim_rectangle_coords_from(&moved, area->x + ddata->ox,
+			area->y + ddata->oy, area->w, area->h);
+	enesim_rectangle_normalize(&moved, &damage);
+	return ddata->real_cb(ddata->r, &damage, past, ddata->real_data);
+}
+
+/* the origin is on a pixel boundary, just copy the pixels */
+static void _layer_span_identity(Enesim_Renderer *r,
+		int x, int y, int len, void *ddata)
+{
+	Enesim_Renderer_Layer *thiz;
+	uint32_t *dst = ddata;
+	uint32_t *src;
+	int sx, sy;
+	int left = 0;
+	int count;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	sx = x - thiz->ix;
+	sy = y - thiz->iy;
+	if (sy < 0 || sy >= thiz->bounds.h || sx >= thiz->bounds.w ||
+			sx + len <= 0)
+	{
+		memset(dst, 0, len * sizeof(uint32_t));
+		return;
+	}
+
+	if (sx < 0)
+	{
+		left = -sx;
+		memset(dst, 0, left * sizeof(uint32_t));
+		sx = 0;
+	}
+	count = MIN(len - left, thiz->bounds.w - sx);
+	src = enesim_color_at(thiz->sdata, thiz->sstride, sx, sy);
+	memcpy(dst + left, src, count * sizeof(uint32_t));
+	if (left + count < len)
+		memset(dst + left + count, 0,
+				(len - left - count) * sizeof(uint32_t));
+}
+
+/* the origin is between pixels, interpolate them */
+static void _layer_span_good(Enesim_Renderer *r,
+		int x, int y, int len, void *ddata)
+{
+	Enesim_Renderer_Layer *thiz;
+	uint32_t *dst = ddata;
+	uint32_t *end = dst + len;
+	Eina_F16p16 xx, yy;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	enesim_coord_identity_setup(&xx, &yy, x, y, thiz->ox, thiz->oy);
+	while (dst < end)
+	{
+		*dst++ = enesim_coord_sample_good_restrict(thiz->sdata,
+				thiz->sstride, thiz->bounds.w, thiz->bounds.h,
+				xx, yy);
+		xx += EINA_F16P16_ONE;
+	}
+}
+
+static Eina_Bool _layer_state_setup(Enesim_Renderer_Layer *thiz,
+		Enesim_Renderer *r, Enesim_Surface *s, Enesim_Log **l)
+{
+	Enesim_Buffer_Sw_Data mapped;
+	Eina_Bool redraw;
+
+	if (!thiz->src_r)
+	{
+		ENESIM_RENDERER_LOG(r, l, "No source renderer set");
+		return EINA_FALSE;
+	}
+
+	/* pick the damages of the source, everything the first time */
+	redraw = enesim_renderer_has_changed(thiz->src_r);
+	if (!enesim_draw_cache_setup_sw(thiz->cache, ENESIM_FORMAT_ARGB8888,
+			thiz->pool))
+	{
+		ENESIM_RENDERER_LOG(r, l, "Source renderer %s can not be cached",
+				enesim_renderer_name_get(thiz->src_r));
+		return EINA_FALSE;
+	}
+	enesim_draw_cache_geometry_get(thiz->cache, &thiz->bounds);
+
+	/* only setup the source when there is something to draw again */
+	if (!redraw)
+		redraw = enesim_draw_cache_is_damaged(thiz->cache);
+	if (redraw && !enesim_renderer_setup(thiz->src_r, s, ENESIM_ROP_FILL, l))
+	{
+		ENESIM_RENDERER_LOG(r, l, "Source renderer %s can not setup",
+				enesim_renderer_name_get(thiz->src_r));
+		return EINA_FALSE;
+	}
+	if (redraw)
+	{
+		Eina_Bool ret;
+
+		ret = enesim_draw_cache_refresh_sw(thiz->cache);
+		enesim_renderer_cleanup(thiz->src_r, s);
+		if (!ret)
+		{
+			ENESIM_RENDERER_LOG(r, l, "Source renderer %s can not be drawn",
+					enesim_renderer_name_get(thiz->src_r));
+			return EINA_FALSE;
+		}
+	}
+	enesim_draw_cache_map_sw(thiz->cache, NULL, &mapped);
+
+	thiz->sdata = mapped.argb8888.plane0;
+	thiz->sstride = mapped.argb8888.plane0_stride;
+	return EINA_TRUE;
+}
+/*----------------------------------------------------------------------------*
+ *                      The Enesim's renderer interface                       *
+ *----------------------------------------------------------------------------*/
+static const char * _layer_name(Enesim_Renderer *r EINA_UNUSED)
+{
+	return "layer";
+}
+
+static Eina_Bool _layer_sw_setup(Enesim_Renderer *r,
+		Enesim_Surface *s, Enesim_Rop rop EINA_UNUSED,
+		Enesim_Renderer_Sw_Fill *fill, Enesim_Log **l)
+{
+	Enesim_Renderer_Layer *thiz;
+	double ox, oy;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	if (!_layer_state_setup(thiz, r, s, l))
+		return EINA_FALSE;
+
+	enesim_renderer_origin_get(r, &ox, &oy);
+	if (enesim_renderer_quality_get(r) == ENESIM_QUALITY_FAST)
+	{
+		ox = floor(ox + 0.5);
+		oy = floor(oy + 0.5);
+	}
+
+	if (ox == floor(ox) && oy == floor(oy))
+	{
+		thiz->ix = thiz->bounds.x + (int)ox;
+		thiz->iy = thiz->bounds.y + (int)oy;
+		*fill = _layer_span_identity;
+	}
+	else
+	{
+		thiz->ox = thiz->bounds.x + ox;
+		thiz->oy = thiz->bounds.y + oy;
+		*fill = _layer_span_good;
+	}
+
+	return EINA_TRUE;
+}
+
+static void _layer_sw_cleanup(Enesim_Renderer *r,
+		Enesim_Surface *s EINA_UNUSED)
+{
+	Enesim_Renderer_Layer *thiz;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	thiz->sdata = NULL;
+	thiz->changed = EINA_FALSE;
+}
+
+static void _layer_features_get(Enesim_Renderer *r EINA_UNUSED,
+		int *features)
+{
+	*features = ENESIM_RENDERER_FEATURE_TRANSLATE |
+			ENESIM_RENDERER_FEATURE_ARGB8888 |
+			ENESIM_RENDERER_FEATURE_QUALITY;
+}
+
+static Eina_Bool _layer_bounds_get(Enesim_Renderer *r,
+		Enesim_Rectangle *rect, Enesim_Log **log)
+{
+	Enesim_Renderer_Layer *thiz;
+	Eina_Rectangle bounds;
+	double ox, oy;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	if (!thiz->src_r)
+	{
+		enesim_rectangle_coords_from(rect, 0, 0, 0, 0);
+		return EINA_FALSE;
+	}
+	/* the cached area is the destination area of the source */
+	if (!enesim_renderer_destination_bounds_get(thiz->src_r, &bounds, 0, 0,
+			log))
+	{
+		enesim_rectangle_coords_from(rect, 0, 0, 0, 0);
+		return EINA_FALSE;
+	}
+	enesim_renderer_origin_get(r, &ox, &oy);
+	enesim_rectangle_coords_from(rect, bounds.x + ox, bounds.y + oy,
+			bounds.w, bounds.h);
+	return EINA_TRUE;
+}
+
+static Eina_Bool _layer_has_changed(Enesim_Renderer *r)
+{
+	Enesim_Renderer_Layer *thiz;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	if (thiz->changed) return EINA_TRUE;
+	if (thiz->src_r)
+		return enesim_renderer_has_changed(thiz->src_r);
+	return EINA_FALSE;
+}
+
+static Eina_Bool _layer_damages_get(Enesim_Renderer *r,
+		const Eina_Rectangle *old_bounds,
+		Enesim_Renderer_Damage cb, void *data)
+{
+	Enesim_Renderer_Layer *thiz;
+	Enesim_Renderer_Layer_Damage ddata;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	/* the whole layer has moved */
+	if (thiz->changed || enesim_renderer_state_has_changed(r))
+	{
+		Eina_Rectangle current_bounds;
+
+		enesim_renderer_destination_bounds_get(r, &current_bounds, 0, 0, NULL);
+		cb(r, old_bounds, EINA_TRUE, data);
+		cb(r, &current_bounds, EINA_FALSE, data);
+		return EINA_TRUE;
+	}
+	if (!thiz->src_r)
+		return EINA_FALSE;
+
+	ddata.r = r;
+	ddata.real_cb = cb;
+	ddata.real_data = data;
+	enesim_renderer_origin_get(r, &ddata.ox, &ddata.oy);
+	return enesim_renderer_damages_get(thiz->src_r, _layer_damage_cb,
+			&ddata);
+}
+/*----------------------------------------------------------------------------*
+ *                            Object definition                               *
+ *----------------------------------------------------------------------------*/
+ENESIM_OBJECT_INSTANCE_BOILERPLATE(ENESIM_RENDERER_DESCRIPTOR,
+		Enesim_Renderer_Layer, Enesim_Renderer_Layer_Class,
+		enesim_renderer_layer);
+
+static void _enesim_renderer_layer_class_init(void *k)
+{
+	Enesim_Renderer_Class *klass;
+
+	klass = ENESIM_RENDERER_CLASS(k);
+	klass->base_name_get = _layer_name;
+	klass->bounds_get = _layer_bounds_get;
+	klass->features_get = _layer_features_get;
+	klass->damages_get = _layer_damages_get;
+	klass->has_changed = _layer_has_changed;
+	klass->sw_setup = _layer_sw_setup;
+	klass->sw_cleanup = _layer_sw_cleanup;
+}
+
+static void _enesim_renderer_layer_instance_init(void *o)
+{
+	Enesim_Renderer_Layer *thiz = ENESIM_RENDERER_LAYER(o);
+
+	thiz->cache = enesim_draw_cache_new();
+}
+
+static void _enesim_renderer_layer_instance_deinit(void *o)
+{
+	Enesim_Renderer_Layer *thiz = ENESIM_RENDERER_LAYER(o);
+
+	if (thiz->cache)
+	{
+		enesim_draw_cache_free(thiz->cache);
+		thiz->cache = NULL;
+	}
+
+	if (thiz->src_r)
+	{
+		enesim_renderer_unref(thiz->src_r);
+		thiz->src_r = NULL;
+	}
+
+	if (thiz->pool)
+	{
+		enesim_pool_unref(thiz->pool);
+		thiz->pool = NULL;
+	}
+}
+/** @endcond */
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Creates a new layer renderer
+ *
+ * A layer draws its source renderer into a surface and keeps it between
+ * draws. Only the damaged areas of the source are drawn again, every other
+ * draw of the layer is a copy of the kept pixels, even when the origin of
+ * the layer changes. Use it for renderers that are expensive to draw and
+ * rarely change, like static panels, complex vector logos or blocks of
+ * text.
+ * @return The new renderer
+ */
+EAPI Enesim_Renderer * enesim_renderer_layer_new(void)
+{
+	Enesim_Renderer *r;
+
+	r = ENESIM_OBJECT_INSTANCE_NEW(enesim_renderer_layer);
+	return r;
+}
+
+/**
+ * @brief Sets the renderer to keep drawn on the layer
+ * @ender_prop{source_renderer}
+ * @param[in] r The layer renderer
+ * @param[in] sr The renderer to keep drawn @ender_transfer{full}
+ */
+EAPI void enesim_renderer_layer_source_renderer_set(Enesim_Renderer *r,
+		Enesim_Renderer *sr)
+{
+	Enesim_Renderer_Layer *thiz;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	if (thiz->src_r)
+		enesim_renderer_unref(thiz->src_r);
+	thiz->src_r = sr;
+	/* the cache keeps its own reference */
+	enesim_draw_cache_renderer_set(thiz->cache, enesim_renderer_ref(sr));
+	thiz->changed = EINA_TRUE;
+}
+
+/**
+ * @brief Gets the renderer kept drawn on the layer
+ * @ender_prop{source_renderer}
+ * @param[in] r The layer renderer
+ * @return The renderer kept drawn @ender_transfer{none}
+ */
+EAPI Enesim_Renderer * enesim_renderer_layer_source_renderer_get(Enesim_Renderer *r)
+{
+	Enesim_Renderer_Layer *thiz;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	return enesim_renderer_ref(thiz->src_r);
+}
+
+/**
+ * @brief Sets the pool to allocate the surface of the layer from
+ * @ender_prop{pool}
+ * @param[in] r The layer renderer
+ * @param[in] pool The pool to use, NULL to use the default one @ender_transfer{full}
+ */
+EAPI void enesim_renderer_layer_pool_set(Enesim_Renderer *r, Enesim_Pool *pool)
+{
+	Enesim_Renderer_Layer *thiz;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	if (thiz->pool)
+		enesim_pool_unref(thiz->pool);
+	thiz->pool = pool;
+	/* start again with a surface from the new pool */
+	enesim_draw_cache_free(thiz->cache);
+	thiz->cache = enesim_draw_cache_new();
+	enesim_draw_cache_renderer_set(thiz->cache,
+			enesim_renderer_ref(thiz->src_r));
+	thiz->changed = EINA_TRUE;
+}
+
+/**
+ * @brief Gets the pool the surface of the layer is allocated from
+ * @ender_prop{pool}
+ * @param[in] r The layer renderer
+ * @return The pool used @ender_transfer{none}
+ */
+EAPI Enesim_Pool * enesim_renderer_layer_pool_get(Enesim_Renderer *r)
+{
+	Enesim_Renderer_Layer *thiz;
+
+	thiz = ENESIM_RENDERER_LAYER(r);
+	return enesim_pool_ref(thiz->pool);
+}
@@ -0,0 +1,44 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ENESIM_RENDERER_LAYER_H_
+#define ENESIM_RENDERER_LAYER_H_
+
+/**
+ * @file
+ * @ender_group{Enesim_Renderer_Layer}
+ */
+
+/**
+ * @defgroup Enesim_Renderer_Layer Layer
+ * @brief Renderer that keeps another renderer drawn on a surface @ender_inherits{Enesim_Renderer}
+ * @ingroup Enesim_Renderer
+ * @{
+ */
+
+EAPI Enesim_Renderer * enesim_renderer_layer_new(void);
+EAPI void enesim_renderer_layer_source_renderer_set(Enesim_Renderer *r,
+		Enesim_Renderer *sr);
+EAPI Enesim_Renderer * enesim_renderer_layer_source_renderer_get(Enesim_Renderer *r);
+EAPI void enesim_renderer_layer_pool_set(Enesim_Renderer *r, Enesim_Pool *pool);
+EAPI Enesim_Pool * enesim_renderer_layer_pool_get(Enesim_Renderer *r);
+
+/**
+ * @}
+ */
+
+#endif
@@ -108,7 +108,7 @@ static Eina_Bool _line_setup(Enesim_Renderer *r, Enesim_Path *path)
 	Enesim_Renderer_Line *thiz;
 
 	thiz = ENESIM_RENDERER_LINE(r);
-	if (_line_changed(thiz) && !thiz->generated)
+	if (!thiz->generated)
 	{
 		enesim_path_command_clear(path);
 		enesim_path_move_to(path, thiz->current.x0, thiz->current.y0);
@@ -183,8 +183,12 @@ static void _enesim_renderer_line_class_init(void *k)
 
 static void _enesim_renderer_line_instance_init(void *o)
 {
+	Enesim_Renderer_Line *thiz;
 	Enesim_Renderer *r;
 
+	thiz = ENESIM_RENDERER_LINE(o);
+	/* nothing to generate until a property is set */
+	thiz->generated = EINA_TRUE;
 	r = ENESIM_RENDERER(o);
 	/* the draw mode should be always a stroke only */
 	enesim_renderer_shape_draw_mode_set(r, ENESIM_RENDERER_SHAPE_DRAW_MODE_STROKE);
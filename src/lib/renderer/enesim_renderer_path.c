@@ -269,6 +269,15 @@ static void _path_sw_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
 	_path_cleanup(r, s);
 }
 
+static void _path_sw_runs_get(Enesim_Renderer *r, int x, int y, int len,
+		Enesim_Renderer_Sw_Run cb, void *data)
+{
+	Enesim_Renderer_Path *thiz;
+
+	thiz = ENESIM_RENDERER_PATH(r);
+	enesim_renderer_sw_runs_get(thiz->current, x, y, len, cb, data);
+}
+
 #if BUILD_OPENGL
 static Eina_Bool _path_opengl_setup(Enesim_Renderer *r, Enesim_Surface *s,
 		Enesim_Rop rop, Enesim_Renderer_OpenGL_Draw *draw,
@@ -342,6 +351,7 @@ static void _enesim_renderer_path_class_init(void *k)
 	klass->sw_hints_get = _path_sw_hints;
 	klass->sw_setup = _path_sw_setup;
 	klass->sw_cleanup = _path_sw_cleanup;
+	klass->sw_runs_get = _path_sw_runs_get;
 #if BUILD_OPENGL
 	klass->opengl_setup = _path_opengl_setup;
 	klass->opengl_cleanup = _path_opengl_cleanup;
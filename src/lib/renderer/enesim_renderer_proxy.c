@@ -174,7 +174,6 @@ static void _proxy_sw_hints_get(Enesim_Renderer *r, Enesim_Rop rop,
 	Enesim_Renderer_Proxy *thiz;
 	Enesim_Renderer_Sw_Hint proxied_hints;
 	const Enesim_Renderer_State *state;
-	const Enesim_Renderer_State *proxied_state;
 
 	thiz = ENESIM_RENDERER_PROXY(r);
 	*hints = 0;
@@ -182,10 +181,9 @@ static void _proxy_sw_hints_get(Enesim_Renderer *r, Enesim_Rop rop,
 		return;
 
 	state = enesim_renderer_state_get(r);
-	proxied_state = enesim_renderer_state_get(thiz->proxied);
 	enesim_renderer_sw_hints_get(thiz->proxied, rop, &proxied_hints);
 	/* check if we can to colorize */
-	if (proxied_state->current.color == state->current.color)
+	if (enesim_renderer_color_get(thiz->proxied) == state->current.color)
 		*hints |= ENESIM_RENDERER_SW_HINT_COLORIZE;
 	/*  we can rop because we use another renderer to draw */
 	*hints |= ENESIM_RENDERER_SW_HINT_ROP;
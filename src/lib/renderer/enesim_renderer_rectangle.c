@@ -162,7 +162,11 @@ static Eina_Bool _rectangle_setup(Enesim_Renderer *r, Enesim_Path *path)
 	Enesim_Renderer_Rectangle *thiz;
 
 	thiz = ENESIM_RENDERER_RECTANGLE(r);
-	if (_rectangle_properties_have_changed(thiz) && !thiz->generated)
+	/* the cleanup commits the properties, even the ones set while the
+	 * renderer was kept prepared, so only the setters tell when the path
+	 * must be generated again
+	 */
+	if (!thiz->generated)
 	{
 		Enesim_Renderer_Shape_Draw_Mode draw_mode;
 		double rx, ry;
@@ -301,6 +305,11 @@ static void _enesim_renderer_rectangle_class_init(void *k)
 
 static void _enesim_renderer_rectangle_instance_init(void *o)
 {
+	Enesim_Renderer_Rectangle *thiz;
+
+	thiz = ENESIM_RENDERER_RECTANGLE(o);
+	/* nothing to generate until a property is set */
+	thiz->generated = EINA_TRUE;
 	/* to maintain compatibility */
 	enesim_renderer_shape_stroke_location_set(ENESIM_RENDERER(o),
 			ENESIM_RENDERER_SHAPE_STROKE_LOCATION_INSIDE);
@@ -531,7 +531,12 @@ static Eina_Bool _enesim_renderer_shape_damage(Enesim_Renderer *r,
 	{
 		do_send_old = klass->has_changed(r);
 		if (do_send_old)
+		{
 			DBG("Implementation changed");
+			if (klass->damages_get &&
+					klass->damages_get(r, old_bounds, cb, data))
+				return EINA_TRUE;
+		}
 	}
 
 send_old:
@@ -154,6 +154,15 @@ static void _shape_path_sw_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
 	_shape_path_cleanup(r, s);
 }
 
+static void _shape_path_sw_runs_get(Enesim_Renderer *r, int x, int y,
+		int len, Enesim_Renderer_Sw_Run cb, void *data)
+{
+	Enesim_Renderer_Shape_Path *thiz;
+
+	thiz = ENESIM_RENDERER_SHAPE_PATH(r);
+	enesim_renderer_sw_runs_get(thiz->r_path, x, y, len, cb, data);
+}
+
 static void _shape_path_features_get(Enesim_Renderer *r EINA_UNUSED,
 		int *features)
 {
@@ -238,6 +247,7 @@ static void _enesim_renderer_shape_path_class_init(void *k)
 	 */
 	klass->sw_setup = _shape_path_sw_setup;
 	klass->sw_cleanup = _shape_path_sw_cleanup;
+	klass->sw_runs_get = _shape_path_sw_runs_get;
 #if BUILD_OPENGL
 	klass->opengl_setup = _shape_path_opengl_setup;
 	klass->opengl_cleanup = _shape_path_opengl_cleanup;
@@ -80,6 +80,10 @@ typedef struct _Enesim_Renderer_Shape_Class {
 	/* shape functions */
 	Enesim_Renderer_Shape_Features_Get_Cb features_get;
 	Enesim_Renderer_Shape_Geometry_Get_Cb geometry_get;
+	/* called whenever the implementation has changed to send a smaller area
+	 * than the whole bounds, returns EINA_FALSE to damage the whole bounds
+	 */
+	Enesim_Renderer_Damages_Get_Cb damages_get;
 } Enesim_Renderer_Shape_Class;
 
 Enesim_Object_Descriptor * enesim_renderer_shape_descriptor_get(void);
@@ -1,5 +1,5 @@
-/* ETEX - Enesim's Text Renderer
- * Copyright (C) 2010 Jorge Luis Zapata
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
  *
  * This library is free software; you can redistribute it and/or
  * modify it under the terms of the GNU Lesser General Public
@@ -15,206 +15,571 @@
  * License along with this library.
  * If not, see <http://www.gnu.org/licenses/>.
  */
-
-#if HAVE_CONFIG_H
-# include <config.h>
-#endif
-
-#include "Enesim_Text.h"
+#include "enesim_private.h"
+
+#include "enesim_main.h"
+#include "enesim_log.h"
+#include "enesim_color.h"
+#include "enesim_rectangle.h"
+#include "enesim_matrix.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+#include "enesim_format.h"
+#include "enesim_surface.h"
+#include "enesim_text.h"
+#include "enesim_renderer.h"
+#include "enesim_renderer_text_grid.h"
+#include "enesim_object_descriptor.h"
+#include "enesim_object_class.h"
+#include "enesim_object_instance.h"
+
+#include "enesim_color_private.h"
 #include "enesim_text_private.h"
-/* for now we are using only chars, until we need utf8 */
+#include "enesim_renderer_private.h"
+
+/*
+ * The cells are rendered into a private buffer of the size of the grid
+ * and the spans are just copied from it. Only the cells that have changed
+ * since the last draw are rendered again. Scrolling moves the rendered rows
+ * on the buffer, so only the new rows need to be rendered.
+ * The glyphs come from the shared glyph cache, the grid keeps a reference to
+ * the ASCII ones to avoid looking them up on every cell.
+ */
 /*============================================================================*
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
-typedef struct _Enesim_Text_Grid_Cell
+#define ENESIM_LOG_DEFAULT enesim_log_renderer
+
+#define ENESIM_RENDERER_TEXT_GRID(o) ENESIM_OBJECT_INSTANCE_CHECK(o,		\
+		Enesim_Renderer_Text_Grid,					\
+		enesim_renderer_text_grid_descriptor_get())
+
+#define ENESIM_RENDERER_TEXT_GRID_ASCII 128
+
+typedef struct _Enesim_Renderer_Text_Grid_Cell
 {
-	Enesim_Color background;
+	Eina_Unicode c;
 	Enesim_Color foreground;
-	char c;
-} Enesim_Text_Grid_Cell;
+	Enesim_Color background;
+	Eina_Bool dirty;
+} Enesim_Renderer_Text_Grid_Cell;
 
-typedef struct _Enesim_Text_Grid
+typedef struct _Enesim_Renderer_Text_Grid_State
 {
-	Enesim_Text_Engine *engine;
 	Enesim_Text_Font *font;
-	unsigned int cell_width;
-	unsigned int cell_height;
-	unsigned int rows;
 	unsigned int columns;
-	Enesim_Text_Grid_Cell *cells;
-} Enesim_Text_Grid;
+	unsigned int rows;
+} Enesim_Renderer_Text_Grid_State;
 
-static inline Enesim_Text_Grid * _enesim_text_grid_get(Enesim_Renderer *r)
+typedef struct _Enesim_Renderer_Text_Grid
+{
+	Enesim_Renderer parent;
+	/* properties */
+	Enesim_Renderer_Text_Grid_State current;
+	Enesim_Renderer_Text_Grid_State past;
+	Enesim_Renderer_Text_Grid_Cell *cells;
+	/* private */
+	Eina_Bool changed : 1;
+	/* the rows have been scrolled since the last draw */
+	Eina_Bool scrolled : 1;
+	/* every cell must be rendered again */
+	Eina_Bool invalid : 1;
+	unsigned int ndirty;
+	/* the font metrics */
+	int cell_width;
+	int cell_height;
+	int ascent;
+	Enesim_Text_Glyph *ascii[ENESIM_RENDERER_TEXT_GRID_ASCII];
+	/* the rendered cells */
+	uint32_t *pixels;
+	size_t stride;
+	int pw;
+	int ph;
+	int ox;
+	int oy;
+} Enesim_Renderer_Text_Grid;
+
+typedef struct _Enesim_Renderer_Text_Grid_Class {
+	Enesim_Renderer_Class parent;
+} Enesim_Renderer_Text_Grid_Class;
+
+static Enesim_Text_Glyph * _text_grid_glyph_load(Enesim_Text_Font *font,
+		Eina_Unicode c)
 {
-	Enesim_Text_Grid *thiz;
+	Enesim_Text_Glyph *g;
 
-	thiz = enesim_text_base_data_get(r);
-	return thiz;
+	g = enesim_text_font_glyph_get(font, c);
+	if (!g) return NULL;
+	if (!enesim_text_glyph_load(g, ENESIM_TEXT_GLYPH_FORMAT_SURFACE))
+	{
+		enesim_text_glyph_unref(g);
+		return NULL;
+	}
+	enesim_text_glyph_cache(enesim_text_glyph_ref(g));
+	return g;
 }
 
-static inline Eina_Bool _enesim_text_grid_has_changed(Enesim_Renderer *r)
+static void _text_grid_glyphs_clear(Enesim_Renderer_Text_Grid *thiz)
 {
-	Enesim_Text_Grid *thiz;
-	Eina_Bool invalidate = EINA_FALSE;
+	int i;
 
-	thiz = _enesim_text_grid_get(r);
-	/* check that the current state is different from the old state */
-	invalidate = enesim_text_base_has_changed(r);
-	return invalidate;
+	for (i = 0; i < ENESIM_RENDERER_TEXT_GRID_ASCII; i++)
+	{
+		if (!thiz->ascii[i]) continue;
+		enesim_text_glyph_unref(thiz->ascii[i]);
+		thiz->ascii[i] = NULL;
+	}
 }
 
-static inline void _enesim_text_grid_update(Enesim_Renderer *r)
+static void _text_grid_metrics_update(Enesim_Renderer_Text_Grid *thiz)
 {
+	Enesim_Text_Glyph *g;
+
+	thiz->cell_width = 0;
+	thiz->cell_height = 0;
+	thiz->ascent = 0;
+	if (!thiz->current.font)
+		return;
+	thiz->ascent = enesim_text_font_max_ascent_get(thiz->current.font);
+	thiz->cell_height = thiz->ascent +
+			enesim_text_font_max_descent_get(thiz->current.font);
+	/* the grid is meant for monospaced fonts */
+	g = _text_grid_glyph_load(thiz->current.font, 'M');
+	if (g)
+	{
+		thiz->cell_width = g->x_advance;
+		thiz->ascii['M'] = g;
+	}
 }
 
-static inline Eina_Bool _enesim_text_grid_calculate(Enesim_Renderer *r)
+static void _text_grid_cell_set(Enesim_Renderer_Text_Grid *thiz,
+		Enesim_Renderer_Text_Grid_Cell *cell, Eina_Unicode c,
+		Enesim_Color foreground, Enesim_Color background)
 {
-	Enesim_Text_Grid *thiz;
-	Enesim_Text_Font *font;
-	Eina_Bool invalidate;
-	int masc;
-	int mdesc;
-
-	invalidate = _enesim_text_grid_has_changed(r);
-	if (invalidate) return EINA_TRUE;
-
-	thiz = _enesim_text_grid_get(r);
-	/* update our font */
-	enesim_text_base_setup(r);
-	font = enesim_text_base_font_get(r);
-	if (!font) return EINA_FALSE;
-	/* we should preload every glyph now? or better preload only an area?
-	 * like whenever we want to draw some row we can preload the group
-	 * of rows based on that and keep track of what has been updated
-	 * and what not?
-	 */
+	if (cell->c == c && cell->foreground == foreground &&
+			cell->background == background)
+		return;
+	cell->c = c;
+	cell->foreground = foreground;
+	cell->background = background;
+	if (!cell->dirty)
+	{
+		cell->dirty = EINA_TRUE;
+		thiz->ndirty++;
+	}
+}
 
-	enesim_text_base_max_ascent_get(r, &masc);
-	enesim_text_base_max_descent_get(r, &mdesc);
-	thiz->cell_height = masc + mdesc;
-	if (thiz->font)
+static void _text_grid_cells_resize(Enesim_Renderer_Text_Grid *thiz,
+		unsigned int columns, unsigned int rows)
+{
+	Enesim_Renderer_Text_Grid_Cell *cells = NULL;
+	unsigned int i;
+
+	if (columns && rows)
 	{
-		enesim_text_font_unref(thiz->font);
+		unsigned int mc, mr;
+
+		cells = calloc(columns * rows, sizeof(Enesim_Renderer_Text_Grid_Cell));
+		/* keep the content of the common area */
+		mc = columns < thiz->current.columns ? columns : thiz->current.columns;
+		mr = rows < thiz->current.rows ? rows : thiz->current.rows;
+		for (i = 0; i < mr; i++)
+		{
+			memcpy(&cells[i * columns],
+					&thiz->cells[i * thiz->current.columns],
+					sizeof(Enesim_Renderer_Text_Grid_Cell) * mc);
+		}
 	}
-	thiz->font = font;
-	_enesim_text_grid_update(r);
+	free(thiz->cells);
+	thiz->cells = cells;
+	thiz->current.columns = columns;
+	thiz->current.rows = rows;
+	/* the new size is rendered completely */
+	thiz->ndirty = 0;
+	for (i = 0; i < columns * rows; i++)
+		thiz->cells[i].dirty = EINA_FALSE;
+	thiz->invalid = EINA_TRUE;
+	thiz->changed = EINA_TRUE;
+}
 
-	return EINA_TRUE;
+static void _text_grid_cell_draw(Enesim_Renderer_Text_Grid *thiz,
+		unsigned int row, unsigned int column)
+{
+	Enesim_Renderer_Text_Grid_Cell *cell;
+	Enesim_Text_Glyph *g = NULL;
+	Enesim_Color fg, bg;
+	uint32_t *dst;
+	uint32_t *gdata;
+	size_t gstride;
+	int gw, gh;
+	int gy, sy, ey;
+	int x, y;
+
+	cell = &thiz->cells[(row * thiz->current.columns) + column];
+	fg = cell->foreground;
+	bg = cell->background;
+	dst = (uint32_t *)((uint8_t *)thiz->pixels +
+			(row * thiz->cell_height * thiz->stride)) +
+			(column * thiz->cell_width);
+	/* fill the background */
+	for (y = 0; y < thiz->cell_height; y++)
+	{
+		uint32_t *d = (uint32_t *)((uint8_t *)dst + (y * thiz->stride));
+
+		for (x = 0; x < thiz->cell_width; x++)
+			*d++ = bg;
+	}
+	if (!cell->c || cell->c == ' ')
+		return;
+
+	if (cell->c < ENESIM_RENDERER_TEXT_GRID_ASCII)
+	{
+		g = thiz->ascii[cell->c];
+		if (!g)
+		{
+			g = _text_grid_glyph_load(thiz->current.font, cell->c);
+			thiz->ascii[cell->c] = g;
+		}
+	}
+	else
+	{
+		g = _text_grid_glyph_load(thiz->current.font, cell->c);
+	}
+	if (!g || !g->surface)
+		goto done;
+
+	/* blend the glyph coverage directly */
+	enesim_surface_size_get(g->surface, &gw, &gh);
+	enesim_surface_sw_data_get(g->surface, (void **)&gdata, &gstride);
+	if (gw > thiz->cell_width)
+		gw = thiz->cell_width;
+	gy = thiz->ascent - g->origin;
+	sy = gy < 0 ? -gy : 0;
+	ey = gh;
+	if (gy + ey > thiz->cell_height)
+		ey = thiz->cell_height - gy;
+	for (y = sy; y < ey; y++)
+	{
+		uint32_t *s = (uint32_t *)((uint8_t *)gdata + (y * gstride));
+		uint32_t *d = (uint32_t *)((uint8_t *)dst + ((gy + y) * thiz->stride));
+
+		for (x = 0; x < gw; x++)
+		{
+			uint16_t a = (*s++) >> 24;
+
+			if (a == 255)
+				*d = fg;
+			else if (a)
+				*d = enesim_color_interp_256(a + 1, fg, bg);
+			d++;
+		}
+	}
+done:
+	if (g && cell->c >= ENESIM_RENDERER_TEXT_GRID_ASCII)
+		enesim_text_glyph_unref(g);
 }
 
-static void _enesim_text_grid_draw_identity(Enesim_Renderer *r, int x, int y, unsigned int len, void *dst)
+static void _text_grid_pixels_update(Enesim_Renderer_Text_Grid *thiz)
 {
-	/* on drawing a possibility is to always have a cell_width*cell_height allocated space
-	 * then fill the background color and then blend on top of it the char
-	 */
+	unsigned int row, column;
+	int pw, ph;
+
+	pw = thiz->cell_width * thiz->current.columns;
+	ph = thiz->cell_height * thiz->current.rows;
+	if (pw != thiz->pw || ph != thiz->ph)
+	{
+		free(thiz->pixels);
+		thiz->pixels = NULL;
+		thiz->stride = pw * sizeof(uint32_t);
+		if (pw && ph)
+			thiz->pixels = malloc(thiz->stride * ph);
+		thiz->pw = pw;
+		thiz->ph = ph;
+		thiz->invalid = EINA_TRUE;
+	}
+	if (!thiz->pixels)
+		return;
+
+	if (thiz->invalid)
+	{
+		for (row = 0; row < thiz->current.rows; row++)
+		{
+			for (column = 0; column < thiz->current.columns; column++)
+				_text_grid_cell_draw(thiz, row, column);
+		}
+	}
+	else if (thiz->ndirty)
+	{
+		Enesim_Renderer_Text_Grid_Cell *cell = thiz->cells;
+
+		for (row = 0; row < thiz->current.rows; row++)
+		{
+			for (column = 0; column < thiz->current.columns; column++)
+			{
+				if ((cell++)->dirty)
+					_text_grid_cell_draw(thiz, row, column);
+			}
+		}
+	}
+}
+
+static Eina_Bool _text_grid_state_changed(Enesim_Renderer_Text_Grid *thiz)
+{
+	if (!thiz->changed)
+		return EINA_FALSE;
+	if (thiz->current.font != thiz->past.font)
+		return EINA_TRUE;
+	if (thiz->current.columns != thiz->past.columns)
+		return EINA_TRUE;
+	if (thiz->current.rows != thiz->past.rows)
+		return EINA_TRUE;
+	return EINA_FALSE;
+}
+
+static void _text_grid_state_cleanup(Enesim_Renderer_Text_Grid *thiz)
+{
+	if (thiz->ndirty)
+	{
+		unsigned int i;
+
+		for (i = 0; i < thiz->current.columns * thiz->current.rows; i++)
+			thiz->cells[i].dirty = EINA_FALSE;
+		thiz->ndirty = 0;
+	}
+	if (thiz->past.font != thiz->current.font)
+	{
+		if (thiz->past.font)
+			enesim_text_font_unref(thiz->past.font);
+		thiz->past.font = NULL;
+		if (thiz->current.font)
+			thiz->past.font = enesim_text_font_ref(thiz->current.font);
+	}
+	thiz->past.columns = thiz->current.columns;
+	thiz->past.rows = thiz->current.rows;
+	thiz->scrolled = EINA_FALSE;
+	thiz->invalid = EINA_FALSE;
+	thiz->changed = EINA_FALSE;
+}
+/*----------------------------------------------------------------------------*
+ *                               Span functions                               *
+ *----------------------------------------------------------------------------*/
+static void _text_grid_span_identity(Enesim_Renderer *r,
+		int x, int y, int len, void *ddata)
+{
+	Enesim_Renderer_Text_Grid *thiz;
+	uint32_t *dst = ddata;
+	uint32_t *end = dst + len;
+	uint32_t *src;
+	int n;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	x -= thiz->ox;
+	y -= thiz->oy;
+	if (y < 0 || y >= thiz->ph || x >= thiz->pw || x + len <= 0)
+	{
+		memset(dst, 0, len * sizeof(uint32_t));
+		return;
+	}
+	if (x < 0)
+	{
+		memset(dst, 0, -x * sizeof(uint32_t));
+		dst -= x;
+		x = 0;
+	}
+	src = (uint32_t *)((uint8_t *)thiz->pixels + (y * thiz->stride)) + x;
+	n = thiz->pw - x;
+	if (n > end - dst)
+		n = end - dst;
+	memcpy(dst, src, n * sizeof(uint32_t));
+	dst += n;
+	if (dst < end)
+		memset(dst, 0, (end - dst) * sizeof(uint32_t));
 }
 /*----------------------------------------------------------------------------*
  *                      The Enesim's renderer interface                       *
  *----------------------------------------------------------------------------*/
-static const char * _enesim_text_grid_name(Enesim_Renderer *r)
+static const char * _text_grid_name(Enesim_Renderer *r EINA_UNUSED)
 {
-	return "enesim_text_grid";
+	return "text_grid";
 }
 
-static Eina_Bool _enesim_text_grid_setup(Enesim_Renderer *r,
-		const Enesim_Renderer_State *states[ENESIM_RENDERER_STATES],
-		Enesim_Surface *s,
-		Enesim_Renderer_Sw_Fill *fill, Enesim_Log **l)
+static Eina_Bool _text_grid_bounds_get(Enesim_Renderer *r,
+		Enesim_Rectangle *rect, Enesim_Log **log EINA_UNUSED)
 {
-	Enesim_Text_Grid *e;
-
-	e = _enesim_text_grid_get(r);
-	if (!e) return EINA_FALSE;
-	if (!_enesim_text_grid_calculate(r))
-		return EINA_FALSE;
-	*fill = _enesim_text_grid_draw_identity;
-
+	Enesim_Renderer_Text_Grid *thiz;
+	double ox, oy;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	enesim_renderer_origin_get(r, &ox, &oy);
+	enesim_rectangle_coords_from(rect, ox, oy,
+			thiz->cell_width * thiz->current.columns,
+			thiz->cell_height * thiz->current.rows);
 	return EINA_TRUE;
 }
 
-static void _enesim_text_grid_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
+static Eina_Bool _text_grid_damages_get(Enesim_Renderer *r,
+		const Eina_Rectangle *old_bounds,
+		Enesim_Renderer_Damage cb, void *data)
 {
-	Enesim_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid_Cell *cell;
+	Eina_Rectangle current_bounds;
+	Eina_Bool ret = EINA_FALSE;
+	unsigned int row, column;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	enesim_renderer_destination_bounds_get(r, &current_bounds, 0, 0, NULL);
+	/* the common properties or the geometry have changed */
+	if (enesim_renderer_state_has_changed(r) || _text_grid_state_changed(thiz))
+	{
+		cb(r, old_bounds, EINA_TRUE, data);
+		cb(r, &current_bounds, EINA_FALSE, data);
+		return EINA_TRUE;
+	}
+	/* the rows have moved, the destination must be updated completely even
+	 * if only the new rows have been rendered
+	 */
+	if (thiz->scrolled || thiz->invalid)
+	{
+		cb(r, &current_bounds, EINA_FALSE, data);
+		return EINA_TRUE;
+	}
+	if (!thiz->ndirty)
+		return EINA_FALSE;
 
-	thiz = _enesim_text_grid_get(r);
+	/* send every run of dirty cells on a row */
+	cell = thiz->cells;
+	for (row = 0; row < thiz->current.rows; row++)
+	{
+		unsigned int start = 0;
+		Eina_Bool in_run = EINA_FALSE;
+
+		for (column = 0; column <= thiz->current.columns; column++)
+		{
+			Eina_Rectangle area;
+
+			if (column < thiz->current.columns && (cell++)->dirty)
+			{
+				if (!in_run)
+				{
+					start = column;
+					in_run = EINA_TRUE;
+				}
+				continue;
+			}
+			if (!in_run)
+				continue;
+			in_run = EINA_FALSE;
+			eina_rectangle_coords_from(&area,
+					current_bounds.x + (start * thiz->cell_width),
+					current_bounds.y + (row * thiz->cell_height),
+					(column - start) * thiz->cell_width,
+					thiz->cell_height);
+			cb(r, &area, EINA_FALSE, data);
+			ret = EINA_TRUE;
+		}
+	}
+	return ret;
 }
 
-static void _enesim_text_grid_free(Enesim_Renderer *r)
+static Eina_Bool _text_grid_has_changed(Enesim_Renderer *r)
 {
-	Enesim_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid *thiz;
 
-	thiz = _enesim_text_grid_get(r);
-	free(thiz);
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	if (thiz->ndirty || thiz->scrolled || thiz->invalid)
+		return EINA_TRUE;
+	return _text_grid_state_changed(thiz);
 }
 
-static void _enesim_text_grid_bounds(Enesim_Renderer *r,
-		const Enesim_Renderer_State *states[ENESIM_RENDERER_STATES],
-		Enesim_Rectangle *rect)
+static void _text_grid_features_get(Enesim_Renderer *r EINA_UNUSED,
+		int *features)
 {
-	Enesim_Text_Grid *thiz;
-	unsigned int size;
-
-	thiz = _enesim_text_grid_get(r);
+	*features = ENESIM_RENDERER_FEATURE_TRANSLATE |
+			ENESIM_RENDERER_FEATURE_ARGB8888;
+}
 
-	_enesim_text_grid_calculate(r);
-	rect->x = 0;
-	rect->y = 0;
-	rect->h = thiz->cell_height * thiz->rows;
-	/* FIXME for now */
-	enesim_text_base_size_get(r, &size);
-	rect->w = thiz->cell_width * size;
+static void _text_grid_sw_hints_get(Enesim_Renderer *r EINA_UNUSED,
+		Enesim_Rop rop EINA_UNUSED, Enesim_Renderer_Sw_Hint *hints)
+{
+	*hints = 0;
 }
 
-static void _enesim_text_grid_features_get(Enesim_Renderer *r, Enesim_Renderer_Feature *features)
+static Eina_Bool _text_grid_sw_setup(Enesim_Renderer *r,
+		Enesim_Surface *s EINA_UNUSED, Enesim_Rop rop EINA_UNUSED,
+		Enesim_Renderer_Sw_Fill *fill, Enesim_Log **l)
 {
-	Enesim_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid *thiz;
+	double ox, oy;
 
-	thiz = _enesim_text_grid_get(r);
-	if (!thiz)
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	if (!thiz->current.font)
 	{
-		*features = 0;
-		return;
+		ENESIM_RENDERER_LOG(r, l, "No font set");
+		return EINA_FALSE;
+	}
+	enesim_renderer_origin_get(r, &ox, &oy);
+	thiz->ox = floor(ox);
+	thiz->oy = floor(oy);
+	_text_grid_pixels_update(thiz);
+	if (!thiz->pixels)
+	{
+		ENESIM_RENDERER_LOG(r, l, "Empty grid");
+		return EINA_FALSE;
 	}
-	*features = ENESIM_RENDERER_FEATURE_TRANSLATE |
-			ENESIM_RENDERER_FEATURE_ARGB8888;
-}
 
-static Enesim_Renderer_Descriptor _enesim_text_grid_descriptor = {
-	/* .version = 			*/ ENESIM_RENDERER_API,
-	/* .name = 			*/ _enesim_text_grid_name,
-	/* .free = 			*/ _enesim_text_grid_free,
-	/* .bounds_get = 		*/ _enesim_text_grid_bounds,
-	/* .destination_transform = 	*/ NULL,
-	/* .features_get = 			*/ _enesim_text_grid_features_get,
-	/* .is_inside = 		*/ NULL,
-	/* .damage = 			*/ NULL,
-	/* .has_changed = 		*/ NULL,
-	/* .sw_setup = 			*/ _enesim_text_grid_setup,
-	/* .sw_cleanup = 		*/ _enesim_text_grid_cleanup,
-};
+	*fill = _text_grid_span_identity;
+	return EINA_TRUE;
+}
 
-static Enesim_Renderer * _enesim_text_grid_new(Enesim_Text_Engine *engine)
+static void _text_grid_sw_cleanup(Enesim_Renderer *r,
+		Enesim_Surface *s EINA_UNUSED)
 {
-	Enesim_Text_Grid *thiz;
-	Enesim_Renderer *r;
+	Enesim_Renderer_Text_Grid *thiz;
 
-	thiz = calloc(1, sizeof(Enesim_Text_Grid));
-	if (!thiz)
-		return NULL;
-
-	thiz->engine = engine;
-
-	r = enesim_text_base_new(engine, &_enesim_text_grid_descriptor, thiz);
-	if (!thiz) goto renderer_err;
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	_text_grid_state_cleanup(thiz);
+}
+/*----------------------------------------------------------------------------*
+ *                            Object definition                               *
+ *----------------------------------------------------------------------------*/
+ENESIM_OBJECT_INSTANCE_BOILERPLATE(ENESIM_RENDERER_DESCRIPTOR,
+		Enesim_Renderer_Text_Grid, Enesim_Renderer_Text_Grid_Class,
+		enesim_renderer_text_grid);
 
-	return r;
+static void _enesim_renderer_text_grid_class_init(void *k)
+{
+	Enesim_Renderer_Class *klass;
+
+	klass = ENESIM_RENDERER_CLASS(k);
+	klass->base_name_get = _text_grid_name;
+	klass->bounds_get = _text_grid_bounds_get;
+	klass->features_get = _text_grid_features_get;
+	klass->damages_get = _text_grid_damages_get;
+	klass->has_changed = _text_grid_has_changed;
+	klass->sw_hints_get = _text_grid_sw_hints_get;
+	klass->sw_setup = _text_grid_sw_setup;
+	klass->sw_cleanup = _text_grid_sw_cleanup;
+}
 
-renderer_err:
-	free(thiz);
-	return NULL;
+static void _enesim_renderer_text_grid_instance_init(void *o EINA_UNUSED)
+{
 }
 
+static void _enesim_renderer_text_grid_instance_deinit(void *o)
+{
+	Enesim_Renderer_Text_Grid *thiz;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(o);
+	_text_grid_glyphs_clear(thiz);
+	if (thiz->current.font)
+		enesim_text_font_unref(thiz->current.font);
+	if (thiz->past.font)
+		enesim_text_font_unref(thiz->past.font);
+	free(thiz->cells);
+	free(thiz->pixels);
+}
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
@@ -222,42 +587,280 @@ renderer_err:
 /*============================================================================*
  *                                   API                                      *
  *============================================================================*/
-EAPI Enesim_Renderer * enesim_text_grid_new(void)
+/**
+ * Creates a text grid renderer
+ * @return The new renderer
+ */
+EAPI Enesim_Renderer * enesim_renderer_text_grid_new(void)
+{
+	Enesim_Renderer *r;
+
+	r = ENESIM_OBJECT_INSTANCE_NEW(enesim_renderer_text_grid);
+	return r;
+}
+
+/**
+ * @brief Sets the font of a text grid renderer
+ * @ender_prop{font}
+ * @param[in] r The text grid renderer
+ * @param[in] font The font to use @ender_transfer{full}
+ *
+ * The width of every cell is the advance of the 'M' glyph, so a
+ * monospaced font is expected.
+ */
+EAPI void enesim_renderer_text_grid_font_set(Enesim_Renderer *r,
+		Enesim_Text_Font *font)
 {
-	return _enesim_text_grid_new(enesim_text_engine_default_get());
+	Enesim_Renderer_Text_Grid *thiz;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	_text_grid_glyphs_clear(thiz);
+	if (thiz->current.font)
+		enesim_text_font_unref(thiz->current.font);
+	thiz->current.font = font;
+	_text_grid_metrics_update(thiz);
+	thiz->invalid = EINA_TRUE;
+	thiz->changed = EINA_TRUE;
 }
 
-EAPI Enesim_Renderer * enesim_text_grid_new_from_engine(Enesim_Text_Engine *e)
+/**
+ * @brief Gets the font of a text grid renderer
+ * @ender_prop{font}
+ * @param[in] r The text grid renderer
+ * @return The font @ender_transfer{full}
+ */
+EAPI Enesim_Text_Font * enesim_renderer_text_grid_font_get(Enesim_Renderer *r)
 {
-	return _enesim_text_grid_new(e);
+	Enesim_Renderer_Text_Grid *thiz;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	if (thiz->current.font)
+		return enesim_text_font_ref(thiz->current.font);
+	return NULL;
 }
 
-EAPI void enesim_text_grid_columns_set(Enesim_Renderer *r, unsigned int columns)
+/**
+ * @brief Sets the number of columns of a text grid renderer
+ * @ender_prop{columns}
+ * @param[in] r The text grid renderer
+ * @param[in] columns The number of columns
+ */
+EAPI void enesim_renderer_text_grid_columns_set(Enesim_Renderer *r,
+		unsigned int columns)
 {
-	Enesim_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid *thiz;
 
-	thiz = _enesim_text_grid_get(r);
-	thiz->columns = columns;
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	if (thiz->current.columns == columns)
+		return;
+	_text_grid_cells_resize(thiz, columns, thiz->current.rows);
 }
 
-EAPI void enesim_text_grid_rows_set(Enesim_Renderer *r, unsigned int rows)
+/**
+ * @brief Gets the number of columns of a text grid renderer
+ * @ender_prop{columns}
+ * @param[in] r The text grid renderer
+ * @return The number of columns
+ */
+EAPI unsigned int enesim_renderer_text_grid_columns_get(Enesim_Renderer *r)
 {
-	Enesim_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid *thiz;
 
-	thiz = _enesim_text_grid_get(r);
-	thiz->rows = rows;
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	return thiz->current.columns;
 }
 
-EAPI void enesim_text_grid_text_set(Enesim_Renderer *r, Enesim_Text_Grid_String *string)
+/**
+ * @brief Sets the number of rows of a text grid renderer
+ * @ender_prop{rows}
+ * @param[in] r The text grid renderer
+ * @param[in] rows The number of rows
+ */
+EAPI void enesim_renderer_text_grid_rows_set(Enesim_Renderer *r,
+		unsigned int rows)
 {
-	Enesim_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid *thiz;
 
-	thiz = _enesim_text_grid_get(r);
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	if (thiz->current.rows == rows)
+		return;
+	_text_grid_cells_resize(thiz, thiz->current.columns, rows);
 }
 
-EAPI void enesim_text_grid_char_set(Enesim_Renderer *r, Enesim_Text_Grid_Char *ch)
+/**
+ * @brief Gets the number of rows of a text grid renderer
+ * @ender_prop{rows}
+ * @param[in] r The text grid renderer
+ * @return The number of rows
+ */
+EAPI unsigned int enesim_renderer_text_grid_rows_get(Enesim_Renderer *r)
 {
-	Enesim_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid *thiz;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	return thiz->current.rows;
+}
 
-	thiz = _enesim_text_grid_get(r);
+/**
+ * @brief Gets the size of every cell of a text grid renderer
+ * @param[in] r The text grid renderer
+ * @param[out] w The width of a cell
+ * @param[out] h The height of a cell
+ */
+EAPI void enesim_renderer_text_grid_cell_size_get(Enesim_Renderer *r,
+		int *w, int *h)
+{
+	Enesim_Renderer_Text_Grid *thiz;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	if (w) *w = thiz->cell_width;
+	if (h) *h = thiz->cell_height;
+}
+
+/**
+ * @brief Sets the content of a cell of a text grid renderer
+ * @param[in] r The text grid renderer
+ * @param[in] row The row of the cell
+ * @param[in] column The column of the cell
+ * @param[in] c The character of the cell
+ * @param[in] foreground The color of the character
+ * @param[in] background The color of the cell
+ *
+ * Only the cells that have changed are drawn again and reported as damaged.
+ */
+EAPI void enesim_renderer_text_grid_char_set(Enesim_Renderer *r,
+		unsigned int row, unsigned int column, Eina_Unicode c,
+		Enesim_Color foreground, Enesim_Color background)
+{
+	Enesim_Renderer_Text_Grid *thiz;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	if (row >= thiz->current.rows || column >= thiz->current.columns)
+		return;
+	_text_grid_cell_set(thiz,
+			&thiz->cells[(row * thiz->current.columns) + column],
+			c, foreground, background);
+}
+
+/**
+ * @brief Sets the content of consecutive cells of a text grid renderer
+ * @param[in] r The text grid renderer
+ * @param[in] row The row of the first cell
+ * @param[in] column The column of the first cell
+ * @param[in] str The UTF-8 string to set
+ * @param[in] foreground The color of the characters
+ * @param[in] background The color of the cells
+ *
+ * The string is clipped at the end of the row.
+ */
+EAPI void enesim_renderer_text_grid_string_set(Enesim_Renderer *r,
+		unsigned int row, unsigned int column, const char *str,
+		Enesim_Color foreground, Enesim_Color background)
+{
+	Enesim_Renderer_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid_Cell *cell;
+	Eina_Unicode c;
+	int idx = 0;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	if (!str) return;
+	if (row >= thiz->current.rows)
+		return;
+	cell = &thiz->cells[(row * thiz->current.columns) + column];
+	while (column < thiz->current.columns &&
+			(c = eina_unicode_utf8_next_get(str, &idx)))
+	{
+		_text_grid_cell_set(thiz, cell++, c, foreground, background);
+		column++;
+	}
+}
+
+/**
+ * @brief Scrolls the content of a text grid renderer
+ * @param[in] r The text grid renderer
+ * @param[in] rows The number of rows to scroll, positive values move the
+ * content up, negative values move it down
+ * @param[in] background The color of the new empty cells
+ *
+ * The already drawn rows are moved instead of drawn again, only the new
+ * empty rows are drawn.
+ */
+EAPI void enesim_renderer_text_grid_scroll(Enesim_Renderer *r, int rows,
+		Enesim_Color background)
+{
+	Enesim_Renderer_Text_Grid *thiz;
+	Enesim_Renderer_Text_Grid_Cell *cells;
+	unsigned int n;
+	unsigned int columns;
+	unsigned int i;
+	size_t row_size;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	if (!rows || !thiz->cells)
+		return;
+	n = rows < 0 ? -rows : rows;
+	if (n > thiz->current.rows)
+		n = thiz->current.rows;
+	columns = thiz->current.columns;
+	row_size = sizeof(Enesim_Renderer_Text_Grid_Cell) * columns;
+	/* move the cells, the dirty ones are still dirty on their new place */
+	if (rows > 0)
+	{
+		memmove(thiz->cells, thiz->cells + (n * columns),
+				row_size * (thiz->current.rows - n));
+		cells = thiz->cells + ((thiz->current.rows - n) * columns);
+	}
+	else
+	{
+		memmove(thiz->cells + (n * columns), thiz->cells,
+				row_size * (thiz->current.rows - n));
+		cells = thiz->cells;
+	}
+	/* recount the dirty cells, some of them might have gone */
+	thiz->ndirty = 0;
+	for (i = 0; i < n * columns; i++)
+	{
+		cells[i].c = 0;
+		cells[i].foreground = background;
+		cells[i].background = background;
+		cells[i].dirty = EINA_TRUE;
+	}
+	for (i = 0; i < thiz->current.rows * columns; i++)
+	{
+		if (thiz->cells[i].dirty)
+			thiz->ndirty++;
+	}
+	/* move the rendered rows */
+	if (thiz->pixels && !thiz->invalid &&
+			thiz->pw == (int)(thiz->cell_width * columns) &&
+			thiz->ph == (int)(thiz->cell_height * thiz->current.rows))
+	{
+		size_t offset = n * thiz->cell_height * thiz->stride;
+		size_t size = (thiz->ph * thiz->stride) - offset;
+
+		if (rows > 0)
+			memmove(thiz->pixels, (uint8_t *)thiz->pixels + offset, size);
+		else
+			memmove((uint8_t *)thiz->pixels + offset, thiz->pixels, size);
+	}
+	thiz->scrolled = EINA_TRUE;
+}
+
+/**
+ * @brief Clears every cell of a text grid renderer
+ * @param[in] r The text grid renderer
+ * @param[in] background The color of the empty cells
+ */
+EAPI void enesim_renderer_text_grid_clear(Enesim_Renderer *r,
+		Enesim_Color background)
+{
+	Enesim_Renderer_Text_Grid *thiz;
+	unsigned int i;
+
+	thiz = ENESIM_RENDERER_TEXT_GRID(r);
+	for (i = 0; i < thiz->current.columns * thiz->current.rows; i++)
+	{
+		_text_grid_cell_set(thiz, &thiz->cells[i], 0, background,
+				background);
+	}
 }
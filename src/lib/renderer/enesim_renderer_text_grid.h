@@ -19,37 +19,40 @@
 #define ENESIM_RENDERER_TEXT_GRID_H_
 
 /**
- * @defgroup Enesim_Text_Grid_Renderer Text Grid
+ * @file
+ * @ender_group{Enesim_Renderer_Text_Grid}
+ */
+
+/**
+ * @defgroup Enesim_Renderer_Text_Grid Text Grid
+ * @brief Grid of monospaced characters renderer @ender_inherits{Enesim_Renderer}
  * @ingroup Enesim_Renderer
  * @{
  */
+EAPI Enesim_Renderer * enesim_renderer_text_grid_new(void);
 
-typedef struct _Enesim_Text_Grid_Char
-{
-	char c;
-	unsigned int row;
-	unsigned int column;
-	Enesim_Color foreground;
-	Enesim_Color background;
-} Enesim_Text_Grid_Char;
+EAPI void enesim_renderer_text_grid_font_set(Enesim_Renderer *r, Enesim_Text_Font *font);
+EAPI Enesim_Text_Font * enesim_renderer_text_grid_font_get(Enesim_Renderer *r);
 
-typedef struct _Enesim_Text_Grid_String
-{
-	const char *string;
-	unsigned int row;
-	unsigned int column;
-	Enesim_Color foreground;
-	Enesim_Color background;
-} Enesim_Text_Grid_String;
+EAPI void enesim_renderer_text_grid_columns_set(Enesim_Renderer *r, unsigned int columns);
+EAPI unsigned int enesim_renderer_text_grid_columns_get(Enesim_Renderer *r);
+EAPI void enesim_renderer_text_grid_rows_set(Enesim_Renderer *r, unsigned int rows);
+EAPI unsigned int enesim_renderer_text_grid_rows_get(Enesim_Renderer *r);
+EAPI void enesim_renderer_text_grid_cell_size_get(Enesim_Renderer *r, int *w, int *h);
 
-EAPI Enesim_Renderer * enesim_text_grid_new(void);
-EAPI Enesim_Renderer * enesim_text_grid_new_from_engine(Enesim_Text_Engine *e);
-EAPI void enesim_text_grid_columns_set(Enesim_Renderer *r, unsigned int columns);
-EAPI void enesim_text_grid_rows_set(Enesim_Renderer *r, unsigned int rows);
+EAPI void enesim_renderer_text_grid_char_set(Enesim_Renderer *r,
+		unsigned int row, unsigned int column, Eina_Unicode c,
+		Enesim_Color foreground, Enesim_Color background);
+EAPI void enesim_renderer_text_grid_string_set(Enesim_Renderer *r,
+		unsigned int row, unsigned int column, const char *str,
+		Enesim_Color foreground, Enesim_Color background);
+EAPI void enesim_renderer_text_grid_scroll(Enesim_Renderer *r, int rows,
+		Enesim_Color background);
+EAPI void enesim_renderer_text_grid_clear(Enesim_Renderer *r,
+		Enesim_Color background);
 
 /**
  * @}
  */
 
 #endif
-
@@ -91,8 +91,23 @@ typedef struct _Enesim_Renderer_Text_Span_State
 	Eina_Bool s_state_changed : 1;
 	/* our own properties have changed */
 	Eina_Bool had_changed : 1;
+	/* every glyph has been laid out again */
+	Eina_Bool glyphs_reset : 1;
 } Enesim_Renderer_Text_Span_State;
 
+/* every character of the text buffer has one of these */
+typedef struct _Enesim_Renderer_Text_Span_Glyph
+{
+	Enesim_Text_Glyph *g;
+	/* the layer on the compound, if the glyph has something to draw */
+	Enesim_Renderer_Compound_Layer *layer;
+	/* the pen position before the glyph */
+	double x;
+	double kern;
+	/* the glyph surface the image layer is using */
+	Enesim_Surface *surface;
+} Enesim_Renderer_Text_Span_Glyph;
+
 typedef struct _Enesim_Renderer_Text_Span
 {
 	Enesim_Renderer_Shape parent;
@@ -101,21 +116,17 @@ typedef struct _Enesim_Renderer_Text_Span
 	Enesim_Renderer *compound;
 	Enesim_Renderer_Text_Span_Glyph_Mode mode;
 	Enesim_Rectangle geometry;
+	/* the laid out characters */
+	Enesim_Renderer_Text_Span_Glyph *glyphs;
+	int nglyphs;
+	int glyphs_size;
+	double width;
 } Enesim_Renderer_Text_Span;
 
 typedef struct _Enesim_Renderer_Text_Span_Class {
 	Enesim_Renderer_Shape_Class parent;
 } Enesim_Renderer_Text_Span_Class;
 
-typedef struct _Enesim_Renderer_Text_Span_Propagate_Cb_Data
-{
-	Enesim_Renderer *r;
-	Enesim_Text_Glyph *prev;
-	int idx;
-	double ox;
-	Eina_Bool has_kerning;
-} Enesim_Renderer_Text_Span_Propagate_Cb_Data;
-
 static void _enesim_renderer_text_span_glyph_propagate(Enesim_Renderer *r,
 		Enesim_Renderer *glyph, double ox, double oy)
 {
@@ -145,45 +156,251 @@ static void _enesim_renderer_text_span_glyph_propagate(Enesim_Renderer *r,
 	enesim_renderer_transformation_set(glyph, &tx);
 }
 
-static Eina_Bool _enesim_renderer_text_span_propagate_cb(
-		Enesim_Renderer *c EINA_UNUSED,
-		Enesim_Renderer_Compound_Layer *layer, void *data)
+static void _enesim_renderer_text_span_glyph_place(
+		Enesim_Renderer_Text_Span *thiz,
+		Enesim_Renderer_Text_Span_Glyph *sg)
 {
-	Enesim_Renderer_Text_Span *thiz;
-	Enesim_Renderer_Text_Span_Propagate_Cb_Data *cb_data = data;
 	Enesim_Renderer *rl;
-	Enesim_Text_Glyph *g = NULL;
+	double x;
+
+	if (!sg->layer)
+		return;
+	rl = enesim_renderer_compound_layer_renderer_get(sg->layer);
+	x = thiz->state.current.x + sg->x + sg->kern;
+	/* use the surface rasterized at the nearest subpixel position and
+	 * draw it on an integer position, that way the image renderer does
+	 * not need to sample between pixels
+	 */
+	if (thiz->mode == ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE)
+	{
+		Enesim_Surface *s;
+		int ix;
+
+		s = enesim_text_glyph_surface_get(sg->g, x, &ix);
+		if (s && s != sg->surface)
+		{
+			int w, h;
+
+			enesim_surface_size_get(s, &w, &h);
+			enesim_renderer_image_size_set(rl, w, h);
+			enesim_renderer_image_source_surface_set(rl,
+					enesim_surface_ref(s));
+			sg->surface = s;
+		}
+		x = ix;
+	}
+	_enesim_renderer_text_span_glyph_propagate(ENESIM_RENDERER(thiz), rl,
+			x, thiz->state.current.y - sg->g->origin);
+	enesim_renderer_unref(rl);
+}
+
+static void _enesim_renderer_text_span_glyph_load(
+		Enesim_Renderer_Text_Span *thiz,
+		Enesim_Renderer_Text_Span_Glyph *sg, Eina_Unicode unicode)
+{
+	Enesim_Text_Glyph *g;
+	Enesim_Renderer *i;
+	Enesim_Renderer_Compound_Layer *l;
+
+	sg->g = NULL;
+	sg->layer = NULL;
+	sg->x = 0;
+	sg->kern = 0;
+	sg->surface = NULL;
+
+	g = enesim_text_font_glyph_get(thiz->state.current.font, unicode);
+	if (!g)
+		return;
+	/* load and cache the glyph */
+	if (!enesim_text_glyph_load(g, ENESIM_TEXT_GLYPH_FORMAT_SURFACE | ENESIM_TEXT_GLYPH_FORMAT_PATH))
+	{
+		enesim_text_glyph_unref(g);
+		return;
+	}
+	enesim_text_glyph_cache(enesim_text_glyph_ref(g));
+	sg->g = g;
+
+	if (!g->surface || !g->path)
+		return;
+
+	if (thiz->mode == ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE)
+	{
+		int w, h;
+
+		i = enesim_renderer_image_new();
+		enesim_surface_size_get(g->surface, &w, &h);
+		enesim_renderer_image_size_set(i, w, h);
+		enesim_renderer_image_source_surface_set(i,
+				enesim_surface_ref(g->surface));
+		sg->surface = g->surface;
+	}
+	else
+	{
+		i = enesim_renderer_path_new();
+		enesim_renderer_path_inner_path_set(i, enesim_path_ref(g->path));
+	}
+
+	/* add the new layer, keep a reference to remove it later */
+	l = enesim_renderer_compound_layer_new();
+	enesim_renderer_compound_layer_renderer_set(l, i);
+	enesim_renderer_compound_layer_rop_set(l, ENESIM_ROP_BLEND);
+	enesim_renderer_compound_layer_add(thiz->compound,
+			enesim_renderer_compound_layer_ref(l));
+	sg->layer = l;
+}
+
+static void _enesim_renderer_text_span_glyph_unload(
+		Enesim_Renderer_Text_Span *thiz,
+		Enesim_Renderer_Text_Span_Glyph *sg)
+{
+	if (sg->layer)
+	{
+		/* the compound takes our reference */
+		enesim_renderer_compound_layer_remove(thiz->compound, sg->layer);
+		sg->layer = NULL;
+	}
+	if (sg->g)
+	{
+		enesim_text_glyph_unref(sg->g);
+		sg->g = NULL;
+	}
+}
+
+static void _enesim_renderer_text_span_glyphs_clear(
+		Enesim_Renderer_Text_Span *thiz)
+{
+	int i;
+
+	/* much faster than removing every layer */
+	enesim_renderer_compound_layer_clear(thiz->compound);
+	for (i = 0; i < thiz->nglyphs; i++)
+	{
+		Enesim_Renderer_Text_Span_Glyph *sg = &thiz->glyphs[i];
+
+		enesim_renderer_compound_layer_unref(sg->layer);
+		enesim_text_glyph_unref(sg->g);
+	}
+	thiz->nglyphs = 0;
+	thiz->width = 0;
+}
+
+/* Lay out the characters modified since the last time and move the ones after
+ * them. The glyphs and layers of the characters before the modified range
+ * are kept as is
+ */
+static void _enesim_renderer_text_span_glyphs_layout(
+		Enesim_Renderer_Text_Span *thiz, Eina_Bool full)
+{
+	Enesim_Renderer_Text_Span_Glyph *sg;
+	Enesim_Text_Glyph *prev = NULL;
+	Eina_Bool has_kerning;
 	const char *text;
-	double kern = 0;
+	double ox = 0;
+	int start = 0;
+	int tail = 0;
+	int count;
+	int end, old_end;
+	int iidx = 0;
+	int i;
 
-	thiz = ENESIM_RENDERER_TEXT_SPAN(cb_data->r);
-	rl = enesim_renderer_compound_layer_renderer_get(layer);
+	count = enesim_text_buffer_length_get(thiz->state.buffer);
+	if (count < 0)
+		count = 0;
+	if (!full && enesim_text_buffer_smart_dirty_range_get(thiz->state.buffer,
+			&start, &tail))
+	{
+		/* the whole buffer has been modified or in a way we can not
+		 * follow
+		 */
+		if ((!start && !tail) || start > thiz->nglyphs || start > count)
+			full = EINA_TRUE;
+	}
+	if (full)
+	{
+		_enesim_renderer_text_span_glyphs_clear(thiz);
+		start = 0;
+		tail = 0;
+	}
+	if (tail > count - start)
+		tail = count - start;
+	if (tail > thiz->nglyphs - start)
+		tail = thiz->nglyphs - start;
+
+	/* the range [start, old_end) is replaced by [start, end) */
+	end = count - tail;
+	old_end = thiz->nglyphs - tail;
+	for (i = start; i < old_end; i++)
+		_enesim_renderer_text_span_glyph_unload(thiz, &thiz->glyphs[i]);
+	if (count > thiz->glyphs_size)
+	{
+		thiz->glyphs = realloc(thiz->glyphs,
+				sizeof(Enesim_Renderer_Text_Span_Glyph) * count);
+		thiz->glyphs_size = count;
+	}
+	if (tail && end != old_end)
+		memmove(&thiz->glyphs[end], &thiz->glyphs[old_end],
+				sizeof(Enesim_Renderer_Text_Span_Glyph) * tail);
+	thiz->nglyphs = count;
+
+	/* create the new glyphs */
 	text = enesim_text_buffer_string_get(thiz->state.buffer);
-	while (!g)
+	for (i = 0; text && i < start; i++)
+		eina_unicode_utf8_next_get(text, &iidx);
+	for (i = start; text && i < end; i++)
 	{
 		Eina_Unicode unicode;
 
-		unicode = eina_unicode_utf8_next_get(text, &cb_data->idx);
-		g = enesim_text_font_glyph_get(thiz->state.current.font, unicode);
-		if (cb_data->has_kerning)
-			kern = enesim_text_glyph_kerning_get(g, cb_data->prev);
-		if (!g->surface || !g->path)
+		unicode = eina_unicode_utf8_next_get(text, &iidx);
+		_enesim_renderer_text_span_glyph_load(thiz, &thiz->glyphs[i], unicode);
+	}
+
+	/* find the pen position where the modified range starts */
+	for (i = start - 1; i >= 0; i--)
+	{
+		sg = &thiz->glyphs[i];
+		if (!sg->g)
+			continue;
+		prev = sg->g;
+		ox = sg->x + sg->g->x_advance + sg->kern;
+		break;
+	}
+
+	/* place the new glyphs and move the following ones */
+	has_kerning = enesim_text_font_has_kerning(thiz->state.current.font);
+	for (i = start; i < count; i++)
+	{
+		Eina_Bool moved = EINA_TRUE;
+
+		sg = &thiz->glyphs[i];
+		if (i >= end)
 		{
-			cb_data->ox += g->x_advance + kern;
-			enesim_text_glyph_unref(cb_data->prev);
-			cb_data->prev = g;
-			g = NULL;
+			/* the rest of the glyphs did not move */
+			if (i > end && sg->x == ox)
+			{
+				ox = thiz->width;
+				break;
+			}
+			moved = sg->x != ox;
 		}
-	}
-	_enesim_renderer_text_span_glyph_propagate(cb_data->r, rl,
-			thiz->state.current.x + cb_data->ox + kern,
-			thiz->state.current.y - g->origin);
-	cb_data->ox += g->x_advance + kern;
-	enesim_text_glyph_unref(cb_data->prev);
-	cb_data->prev = g;
-	enesim_renderer_unref(rl);
+		sg->x = ox;
+		if (!sg->g)
+			continue;
+		/* the first unmodified glyph has a new previous glyph */
+		if (has_kerning && i <= end)
+		{
+			double kern;
 
-	return EINA_TRUE;
+			kern = enesim_text_glyph_kerning_get(sg->g, prev);
+			if (kern != sg->kern)
+				moved = EINA_TRUE;
+			sg->kern = kern;
+		}
+		if (moved)
+			_enesim_renderer_text_span_glyph_place(thiz, sg);
+		ox += sg->g->x_advance + sg->kern;
+		prev = sg->g;
+	}
+	thiz->width = ox;
 }
 
 static Eina_Bool _enesim_renderer_text_span_state_changed(Enesim_Renderer_Text_Span *thiz)
@@ -215,10 +432,7 @@ static Eina_Bool _enesim_renderer_text_span_glyphs_generate(Enesim_Renderer_Text
 	Eina_Bool r_changed = EINA_FALSE;
 	Eina_Bool s_changed = EINA_FALSE;
 	Eina_Bool glyphs_generated = EINA_TRUE;
-	Eina_Unicode unicode;
-	int iidx = 0;
-	const char *text;
-	double ox = 0;
+	Eina_Bool changed = EINA_FALSE;
 
 	/* commit the state */
 	if (thiz->state.changed)
@@ -240,11 +454,13 @@ static Eina_Bool _enesim_renderer_text_span_glyphs_generate(Enesim_Renderer_Text
 		{
 			thiz->state.past.x = thiz->state.current.x;
 			thiz->state.had_changed = EINA_TRUE;
+			changed = EINA_TRUE;
 		}
 		if (thiz->state.current.y != thiz->state.past.y)
 		{
 			thiz->state.past.y = thiz->state.current.y;
 			thiz->state.had_changed = EINA_TRUE;
+			changed = EINA_TRUE;
 		}
 		thiz->state.changed = EINA_FALSE;
 	}
@@ -284,107 +500,51 @@ static Eina_Bool _enesim_renderer_text_span_glyphs_generate(Enesim_Renderer_Text
 			!glyphs_generated)
 	{
 		Enesim_Renderer *fr;
-		Enesim_Text_Glyph *prev = NULL;
-		Eina_Bool has_kerning;
+		Enesim_Renderer_Text_Span_Glyph_Mode mode;
 
 		/* define the mode */
 		fr = enesim_renderer_shape_fill_renderer_get(r);
 		if (enesim_renderer_shape_draw_mode_get(r) & ENESIM_RENDERER_SHAPE_DRAW_MODE_STROKE)
 		{
-			thiz->mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_PATH;
+			mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_PATH;
 		}
 		else if (fr)
 		{
-			thiz->mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_PATH;
+			mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_PATH;
 		}
 		else
 		{
-			thiz->mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE;
+			mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE;
 		}
 		enesim_renderer_unref(fr);
-		/* regenerate the glyphs */
-		has_kerning = enesim_text_font_has_kerning(thiz->state.current.font);
-		enesim_renderer_compound_layer_clear(thiz->compound);
-		text = enesim_text_buffer_string_get(thiz->state.buffer);
-		while ((unicode = eina_unicode_utf8_next_get(text, &iidx)))
+		if (mode != thiz->mode)
 		{
-			Enesim_Text_Glyph *g;
-
-			g = enesim_text_font_glyph_get(thiz->state.current.font, unicode);
-			if (g)
-			{
-				Enesim_Renderer *i;
-				Enesim_Renderer_Compound_Layer *l;
-				double kern = 0;
-
-				/* load and cache the glyph */
-				if (!enesim_text_glyph_load(g, ENESIM_TEXT_GLYPH_FORMAT_SURFACE | ENESIM_TEXT_GLYPH_FORMAT_PATH))
-					continue;
-				enesim_text_glyph_cache(enesim_text_glyph_ref(g));
-				if (has_kerning)
-					kern = enesim_text_glyph_kerning_get(g, prev);
-
-				if (!g->surface || !g->path)
-					goto next;
-
-				if (thiz->mode == ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE)
-				{
-					int w, h;
-
-					i = enesim_renderer_image_new();
-					enesim_surface_size_get(g->surface, &w, &h);
-					enesim_renderer_image_size_set(i, w, h);
-					enesim_renderer_image_source_surface_set(i,
-							enesim_surface_ref(g->surface));
-				}
-				else
-				{
-					i = enesim_renderer_path_new();
-					enesim_renderer_path_inner_path_set(i, enesim_path_ref(g->path));
-				}
-
-				_enesim_renderer_text_span_glyph_propagate(r, i,
-						thiz->state.current.x + ox + kern,
-						thiz->state.current.y - g->origin);
-
-				/* add the new layer */
-				l = enesim_renderer_compound_layer_new();
-				enesim_renderer_compound_layer_renderer_set(l, i);
-				enesim_renderer_compound_layer_rop_set(l, ENESIM_ROP_BLEND);
-				enesim_renderer_compound_layer_add(thiz->compound, l);
-next:
-				ox += g->x_advance + kern;
-				enesim_text_glyph_unref(prev);
-				prev = g;
-			}
+			thiz->mode = mode;
+			glyphs_generated = EINA_FALSE;
 		}
-		enesim_text_glyph_unref(prev);
-		enesim_rectangle_coords_from(&thiz->geometry,
-				thiz->state.current.x, thiz->state.current.y,
-				ox,
-				enesim_text_font_max_ascent_get(thiz->state.current.font) +
-				enesim_text_font_max_descent_get(thiz->state.current.font));
+		/* regenerate the glyphs */
+		_enesim_renderer_text_span_glyphs_layout(thiz, !glyphs_generated);
+		if (!glyphs_generated)
+			thiz->state.glyphs_reset = EINA_TRUE;
 		thiz->state.buffer_changed = EINA_TRUE;
 		enesim_text_buffer_smart_clear(thiz->state.buffer);
 	}
 	/* check the common renderer and shape renderer attributes to propagate them
 	 * on every inner renderer. Also attributes that dont require a glyph generate
 	 */
-	else if (r_changed || s_changed || thiz->state.had_changed)
+	if (glyphs_generated && (r_changed || s_changed || changed))
 	{
-		Enesim_Renderer_Text_Span_Propagate_Cb_Data cb_data;
-
-		cb_data.r = r;
-		cb_data.idx = 0;
-		cb_data.ox = 0;
-		cb_data.prev = NULL;
-		cb_data.has_kerning = enesim_text_font_has_kerning(thiz->state.current.font);
+		int i;
 
 		/* just propagate the properties */
-		enesim_renderer_compound_layer_foreach(thiz->compound,
-				_enesim_renderer_text_span_propagate_cb, &cb_data);
-		enesim_text_glyph_unref(cb_data.prev);
+		for (i = 0; i < thiz->nglyphs; i++)
+			_enesim_renderer_text_span_glyph_place(thiz, &thiz->glyphs[i]);
 	}
+	enesim_rectangle_coords_from(&thiz->geometry,
+			thiz->state.current.x, thiz->state.current.y,
+			thiz->width,
+			enesim_text_font_max_ascent_get(thiz->state.current.font) +
+			enesim_text_font_max_descent_get(thiz->state.current.font));
 
 	return EINA_TRUE;
 }
@@ -532,6 +692,8 @@ static void _enesim_renderer_text_span_cleanup(Enesim_Renderer_Text_Span *thiz,
 	thiz->state.buffer_changed = EINA_FALSE;
 	thiz->state.r_state_changed = EINA_FALSE;
 	thiz->state.s_state_changed = EINA_FALSE;
+	thiz->state.had_changed = EINA_FALSE;
+	thiz->state.glyphs_reset = EINA_FALSE;
 }
 /*----------------------------------------------------------------------------*
  *                             Shape interface                                *
@@ -575,6 +737,25 @@ static Eina_Bool _enesim_renderer_text_span_has_changed(Enesim_Renderer *r)
 	return EINA_FALSE;
 }
 
+static Eina_Bool _enesim_renderer_text_span_damages_get(Enesim_Renderer *r,
+		const Eina_Rectangle *old_bounds EINA_UNUSED,
+		Enesim_Renderer_Damage cb, void *data)
+{
+	Enesim_Renderer_Text_Span *thiz;
+
+	thiz = ENESIM_RENDERER_TEXT_SPAN(r);
+	if (!_enesim_renderer_text_span_generate(thiz))
+		return EINA_FALSE;
+	/* in case only some glyphs have been laid out again, the compound
+	 * knows the areas of the added, removed and moved layers
+	 */
+	if (thiz->state.glyphs_reset || thiz->state.r_state_changed ||
+			thiz->state.s_state_changed || thiz->state.had_changed)
+		return EINA_FALSE;
+	enesim_renderer_damages_get(thiz->compound, cb, data);
+	return EINA_TRUE;
+}
+
 static Eina_Bool _enesim_renderer_text_span_geometry_get(Enesim_Renderer *r,
 		Enesim_Rectangle *geometry)
 {
@@ -684,6 +865,7 @@ static void _enesim_renderer_text_span_class_init(void *k)
 	klass->sw_setup = _enesim_renderer_text_span_sw_setup;
 	klass->sw_cleanup = _enesim_renderer_text_span_sw_cleanup;
 	klass->geometry_get = _enesim_renderer_text_span_geometry_get;
+	klass->damages_get = _enesim_renderer_text_span_damages_get;
 #if BUILD_OPENGL
 	klass->opengl_setup = _enesim_renderer_text_span_opengl_setup;
 	klass->opengl_cleanup = _enesim_renderer_text_span_opengl_cleanup;
@@ -723,6 +905,8 @@ static void _enesim_renderer_text_span_instance_deinit(void *o)
 		enesim_text_buffer_unref(thiz->state.buffer);
 		thiz->state.buffer = NULL;
 	}
+	_enesim_renderer_text_span_glyphs_clear(thiz);
+	free(thiz->glyphs);
 	enesim_renderer_unref(thiz->compound);
 }
 
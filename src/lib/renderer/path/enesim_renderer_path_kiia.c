@@ -617,6 +617,332 @@ static Eina_Bool _kiia_setup(Enesim_Renderer *r, Enesim_Backend backend,
 	return EINA_TRUE;
 }
 
+/*----------------------------------------------------------------------------*
+ *                              Coverage runs                                 *
+ *----------------------------------------------------------------------------*/
+/* The coverage of a pixel depends on the samples of the edges on its left.
+ * Between the pixels the edges fall on, the samples accumulated are the
+ * same for every pixel, so the whole gap has the same coverage
+ */
+#define KIIA_RUNS_MAX_EDGES 64
+
+typedef struct _Enesim_Renderer_Path_Kiia_Runs_Edge
+{
+	/* the first and last pixel the samples of the edge fall on */
+	int x0;
+	int x1;
+	/* the figure of the edge */
+	int figure;
+	/* the samples of the edge on the row and its direction */
+	uint32_t mask;
+	int sgn;
+} Enesim_Renderer_Path_Kiia_Runs_Edge;
+
+typedef struct _Enesim_Renderer_Path_Kiia_Runs
+{
+	Enesim_Renderer_Path_Kiia_Figure *figures[2];
+	Eina_Bool even_odd[2];
+	int nfigures;
+	/* the samples accumulated on every figure, as a mask for the even-odd
+	 * rule and as the winding of every sample for the non-zero rule, the
+	 * edges of a row can cover different samples, so their windings can
+	 * not be summed as a whole
+	 */
+	uint32_t mask[2];
+	int winding[2][32];
+	/* the number of samples with a winding */
+	int wound[2];
+	uint32_t mask_max;
+	int nsamples;
+	/* the run to emit, consecutive runs of the same coverage are merged */
+	Enesim_Renderer_Sw_Run cb;
+	void *data;
+	int x;
+	int len;
+	Enesim_Renderer_Sw_Coverage coverage;
+} Enesim_Renderer_Path_Kiia_Runs;
+
+static void _kiia_runs_add(Enesim_Renderer_Path_Kiia_Runs *thiz, int x,
+		int len, Enesim_Renderer_Sw_Coverage coverage)
+{
+	if (len <= 0)
+		return;
+	if (thiz->len && thiz->coverage == coverage)
+	{
+		thiz->len += len;
+		return;
+	}
+	if (thiz->len)
+		thiz->cb(thiz->x, thiz->len, thiz->coverage, thiz->data);
+	thiz->x = x;
+	thiz->len = len;
+	thiz->coverage = coverage;
+}
+
+static Enesim_Renderer_Sw_Coverage _kiia_runs_samples_get(
+		Enesim_Renderer_Path_Kiia_Runs *thiz, int figure)
+{
+	if (thiz->even_odd[figure])
+	{
+		if (!thiz->mask[figure])
+			return ENESIM_RENDERER_SW_COVERAGE_NONE;
+		if (thiz->mask[figure] == thiz->mask_max)
+			return ENESIM_RENDERER_SW_COVERAGE_FULL;
+	}
+	else
+	{
+		if (!thiz->wound[figure])
+			return ENESIM_RENDERER_SW_COVERAGE_NONE;
+		if (thiz->wound[figure] == thiz->nsamples)
+			return ENESIM_RENDERER_SW_COVERAGE_FULL;
+	}
+	return ENESIM_RENDERER_SW_COVERAGE_PARTIAL;
+}
+
+static void _kiia_runs_edge_add(Enesim_Renderer_Path_Kiia_Runs *thiz,
+		Enesim_Renderer_Path_Kiia_Runs_Edge *redge)
+{
+	int *winding;
+	uint32_t mask;
+	int f = redge->figure;
+	int i;
+
+	if (thiz->even_odd[f])
+	{
+		thiz->mask[f] ^= redge->mask;
+		return;
+	}
+
+	winding = thiz->winding[f];
+	for (mask = redge->mask, i = 0; mask; mask >>= 1, i++)
+	{
+		if (!(mask & 1))
+			continue;
+		if (!winding[i])
+			thiz->wound[f]++;
+		winding[i] += redge->sgn;
+		if (!winding[i])
+			thiz->wound[f]--;
+	}
+}
+
+/* the coverage of the pixels drawn by a figure given its samples */
+static Enesim_Renderer_Sw_Coverage _kiia_runs_figure_coverage_get(
+		Enesim_Renderer_Path_Kiia_Figure *f,
+		Enesim_Renderer_Sw_Coverage samples)
+{
+	if (samples == ENESIM_RENDERER_SW_COVERAGE_NONE)
+		return samples;
+	/* the pixels of a renderer are never known */
+	if (f->ren)
+		return ENESIM_RENDERER_SW_COVERAGE_PARTIAL;
+	if (!f->color)
+		return ENESIM_RENDERER_SW_COVERAGE_NONE;
+	if (samples == ENESIM_RENDERER_SW_COVERAGE_FULL &&
+			enesim_color_alpha_get(f->color) == 0xff)
+		return ENESIM_RENDERER_SW_COVERAGE_FULL;
+	return ENESIM_RENDERER_SW_COVERAGE_PARTIAL;
+}
+
+static Enesim_Renderer_Sw_Coverage _kiia_runs_coverage_get(
+		Enesim_Renderer_Path_Kiia_Runs *thiz)
+{
+	Enesim_Renderer_Sw_Coverage fill;
+	Enesim_Renderer_Sw_Coverage stroke;
+	Enesim_Renderer_Sw_Coverage samples;
+
+	fill = _kiia_runs_figure_coverage_get(thiz->figures[0],
+			_kiia_runs_samples_get(thiz, 0));
+	if (thiz->nfigures == 1)
+		return fill;
+
+	/* the stroke is drawn on top of the fill */
+	samples = _kiia_runs_samples_get(thiz, 1);
+	stroke = _kiia_runs_figure_coverage_get(thiz->figures[1], samples);
+	if (samples == ENESIM_RENDERER_SW_COVERAGE_FULL)
+		return stroke;
+	if (samples == ENESIM_RENDERER_SW_COVERAGE_NONE)
+		return fill;
+	if (stroke == ENESIM_RENDERER_SW_COVERAGE_NONE &&
+			fill == ENESIM_RENDERER_SW_COVERAGE_NONE)
+		return ENESIM_RENDERER_SW_COVERAGE_NONE;
+	return ENESIM_RENDERER_SW_COVERAGE_PARTIAL;
+}
+
+/* Get the samples of every edge of a figure on the row at y, the same way
+ * the figure is evaluated when drawing
+ */
+static Eina_Bool _kiia_runs_edges_get(Enesim_Renderer_Path_Kiia *thiz,
+		Enesim_Renderer_Path_Kiia_Figure *f, int figure, int y,
+		Enesim_Renderer_Path_Kiia_Runs_Edge *redges, int *nredges)
+{
+	Eina_F16p16 yy0, yy1;
+	int i;
+
+	yy0 = eina_f16p16_int_from(y);
+	yy1 = eina_f16p16_int_from(y + 1);
+	for (i = 0; i < f->nedges; i++)
+	{
+		Enesim_Renderer_Path_Kiia_Edge_Sw *edges = f->edges;
+		Enesim_Renderer_Path_Kiia_Edge_Sw *edge = &edges[i];
+		Enesim_Renderer_Path_Kiia_Runs_Edge *redge;
+		Eina_F16p16 yyy0, yyy1;
+		Eina_F16p16 cx, lcx;
+		int sample;
+		int n;
+
+		/* up the span */
+		if (yy0 >= edge->yy1)
+			continue;
+		/* down the span, the edges are ordered in y */
+		if (yy1 < edge->yy0)
+			break;
+
+		yyy1 = yy1;
+		if (yyy1 > edge->yy1)
+			yyy1 = edge->yy1;
+		if (yy0 <= edge->yy0)
+		{
+			yyy0 = edge->yy0;
+			cx = edge->mx;
+			sample = eina_f16p16_fracc_get(yyy0) / thiz->inc;
+		}
+		else
+		{
+			Eina_F16p16 inc;
+
+			yyy0 = yy0;
+			inc = eina_f16p16_mul(yyy0 - edge->yy0,
+					eina_f16p16_int_from(thiz->nsamples));
+			cx = edge->mx + eina_f16p16_mul(inc, edge->slope);
+			sample = 0;
+		}
+		if (yyy0 >= yyy1)
+			continue;
+		/* too many edges on this row */
+		if (*nredges == KIIA_RUNS_MAX_EDGES)
+			return EINA_FALSE;
+
+		n = (yyy1 - yyy0 + thiz->inc - 1) / thiz->inc;
+		lcx = cx + ((n - 1) * edge->slope);
+		redge = &redges[(*nredges)++];
+		/* the sampling pattern moves the samples up to one pixel */
+		if (lcx < cx)
+		{
+			redge->x0 = eina_f16p16_int_to(lcx);
+			redge->x1 = eina_f16p16_int_to(cx) + 1;
+		}
+		else
+		{
+			redge->x0 = eina_f16p16_int_to(cx);
+			redge->x1 = eina_f16p16_int_to(lcx) + 1;
+		}
+		redge->figure = figure;
+		redge->sgn = edge->sgn;
+		if (n == 32)
+			redge->mask = 0xffffffff;
+		else
+			redge->mask = ((1U << n) - 1) << sample;
+	}
+	return EINA_TRUE;
+}
+
+static void _kiia_sw_runs_get(Enesim_Renderer *r, int x, int y, int len,
+		Enesim_Renderer_Sw_Run cb, void *data)
+{
+	Enesim_Renderer_Path_Kiia *thiz;
+	Enesim_Renderer_Path_Kiia_Runs_Edge redges[KIIA_RUNS_MAX_EDGES];
+	Enesim_Renderer_Path_Kiia_Runs runs;
+	int nredges = 0;
+	int end = x + len;
+	int i;
+
+	thiz = ENESIM_RENDERER_PATH_KIIA(r);
+	if (thiz->current)
+	{
+		runs.figures[0] = thiz->current;
+		/* the stroke must always be non-zero */
+		runs.even_odd[0] = thiz->current == &thiz->fill &&
+				thiz->fill_rule == ENESIM_RENDERER_SHAPE_FILL_RULE_EVEN_ODD;
+		runs.nfigures = 1;
+	}
+	else
+	{
+		runs.figures[0] = &thiz->fill;
+		runs.even_odd[0] = thiz->fill_rule == ENESIM_RENDERER_SHAPE_FILL_RULE_EVEN_ODD;
+		runs.figures[1] = &thiz->stroke;
+		runs.even_odd[1] = EINA_FALSE;
+		runs.nfigures = 2;
+	}
+
+	for (i = 0; i < runs.nfigures; i++)
+	{
+		if (!_kiia_runs_edges_get(thiz, runs.figures[i], i, y, redges,
+				&nredges))
+		{
+			cb(x, len, ENESIM_RENDERER_SW_COVERAGE_PARTIAL, data);
+			return;
+		}
+	}
+	/* sort the edges on x */
+	for (i = 1; i < nredges; i++)
+	{
+		Enesim_Renderer_Path_Kiia_Runs_Edge tmp = redges[i];
+		int j;
+
+		for (j = i; j > 0 && redges[j - 1].x0 > tmp.x0; j--)
+			redges[j] = redges[j - 1];
+		redges[j] = tmp;
+	}
+
+	memset(runs.mask, 0, sizeof(runs.mask));
+	memset(runs.winding, 0, sizeof(runs.winding));
+	memset(runs.wound, 0, sizeof(runs.wound));
+	runs.nsamples = thiz->nsamples;
+	runs.mask_max = thiz->nsamples == 32 ? 0xffffffff :
+			(1U << thiz->nsamples) - 1;
+	runs.cb = cb;
+	runs.data = data;
+	runs.len = 0;
+
+	i = 0;
+	while (i < nredges && x < end)
+	{
+		int x0 = redges[i].x0;
+		int x1 = redges[i].x1;
+
+		/* the gap before the edges */
+		_kiia_runs_add(&runs, x, (x0 < end ? x0 : end) - x,
+				_kiia_runs_coverage_get(&runs));
+		/* the edges that overlap, or the ones with a gap too small
+		 * in between
+		 */
+		do
+		{
+			Enesim_Renderer_Path_Kiia_Runs_Edge *redge = &redges[i];
+
+			_kiia_runs_edge_add(&runs, redge);
+			if (redge->x1 > x1)
+				x1 = redge->x1;
+			i++;
+		} while (i < nredges &&
+				redges[i].x0 <= x1 + ENESIM_RENDERER_SW_RUN_MIN);
+		/* the pixels the edges fall on */
+		if (x0 < x)
+			x0 = x;
+		x1++;
+		if (x1 > end)
+			x1 = end;
+		_kiia_runs_add(&runs, x0, x1 - x0,
+				ENESIM_RENDERER_SW_COVERAGE_PARTIAL);
+		if (x1 > x)
+			x = x1;
+	}
+	/* the gap after the edges */
+	_kiia_runs_add(&runs, x, end - x, _kiia_runs_coverage_get(&runs));
+	if (runs.len)
+		cb(runs.x, runs.len, runs.coverage, data);
+}
 /*----------------------------------------------------------------------------*
  *                               Path abstract                                *
  *----------------------------------------------------------------------------*/
@@ -689,6 +1015,7 @@ static Eina_Bool _kiia_sw_setup(Enesim_Renderer *r,
 		*draw = _fill_simple[quality][fr][has_renderer];
 	}
 
+	thiz->fill_rule = fr;
 	thiz->inc = eina_f16p16_double_from(1/(double)thiz->nsamples);
 	/* set the y coordinate with the topmost value */
 	y = ceil(ty);
@@ -1037,6 +1364,7 @@ static void _enesim_renderer_path_kiia_class_init(void *k)
 	r_klass->base_name_get = _kiia_name;
 	r_klass->features_get = _kiia_features_get;
 	r_klass->sw_hints_get = _kiia_sw_hints;
+	r_klass->sw_runs_get = _kiia_sw_runs_get;
 	r_klass->bounds_get = _kiia_bounds_get;
 #ifdef BUILD_OPENCL
 	r_klass->opencl_kernel_setup = _kiia_opencl_kernel_setup;
@@ -120,6 +120,8 @@ typedef struct _Enesim_Renderer_Path_Kiia
 	Eina_F16p16 llx;
 	/* The number of samples (8, 16, 32) */
 	int nsamples;
+	/* The fill rule used on the fill figure */
+	Enesim_Renderer_Shape_Fill_Rule fill_rule;
 	/* the increment on the y direction (i.e 1/num samples) */
 	Eina_F16p16 inc;
 	/* the pattern to use */
@@ -600,8 +600,8 @@ void enesim_renderer_path_kiia_##nsamples##_##fill_mode##_##fill##_simple(	\
 	int nworker;								\
 										\
 	thiz = ENESIM_RENDERER_PATH_KIIA(r);					\
-	/* pick the worker at y coordinate */					\
-	nworker = y % thiz->nworkers;						\
+	/* pick the worker of the thread drawing the band at y */		\
+	nworker = enesim_renderer_sw_band_get(y) % thiz->nworkers;		\
 	if (nworker < 0)							\
 		nworker = nworker + thiz->nworkers;				\
 	w = &thiz->workers[nworker];						\
@@ -721,8 +721,8 @@ enesim_renderer_path_kiia_##nsamples##_##fill_mode##_##ft##_##st##_full(	\
 	int nworker;								\
 										\
 	thiz = ENESIM_RENDERER_PATH_KIIA(r);					\
-	/* pick the worker at y coordinate */					\
-	nworker = y % thiz->nworkers;						\
+	/* pick the worker of the thread drawing the band at y */		\
+	nworker = enesim_renderer_sw_band_get(y) % thiz->nworkers;		\
 	if (nworker < 0)							\
 		nworker = nworker + thiz->nworkers;				\
 	w = &thiz->workers[nworker];						\
@@ -2,7 +2,9 @@ src_lib_libenesim_la_SOURCES += \
 src/lib/text/enesim_text_buffer.c \
 src/lib/text/enesim_text_engine.c \
 src/lib/text/enesim_text_font.c \
+src/lib/text/enesim_text_font_preload.c \
 src/lib/text/enesim_text_glyph.c \
+src/lib/text/enesim_text_glyph_cache.c \
 src/lib/text/glyph/enesim_text_glyph_freetype.c \
 src/lib/text/font/enesim_text_font_freetype.c \
 src/lib/text/engine/enesim_text_engine_freetype.c
@@ -33,7 +33,39 @@ typedef struct _Enesim_Text_Buffer_Smart
 {
 	Enesim_Text_Buffer *real;
 	Eina_Bool dirty;
+	/* the range of characters modified since the last clear, start is
+	 * the first modified character and tail the number of characters at the
+	 * end of the string that have not been modified. A negative start means
+	 * that no character has been modified
+	 */
+	int start;
+	int tail;
 } Enesim_Text_Buffer_Smart;
+
+static void _smart_range_add(Enesim_Text_Buffer_Smart *thiz, int start,
+		int tail)
+{
+	if (start < 0) start = 0;
+	if (tail < 0) tail = 0;
+	if (thiz->start < 0)
+	{
+		thiz->start = start;
+		thiz->tail = tail;
+	}
+	else
+	{
+		if (start < thiz->start)
+			thiz->start = start;
+		if (tail < thiz->tail)
+			thiz->tail = tail;
+	}
+}
+
+static void _smart_range_full(Enesim_Text_Buffer_Smart *thiz)
+{
+	thiz->start = 0;
+	thiz->tail = 0;
+}
 /*----------------------------------------------------------------------------*
  *                           Text buffer interface                            *
  *----------------------------------------------------------------------------*/
@@ -48,6 +80,7 @@ static void _smart_string_set(void *data, const char *string, int length)
 	if (thiz->real)
 	{
 		thiz->dirty = EINA_TRUE;
+		_smart_range_full(thiz);
 		enesim_text_buffer_string_set(thiz->real, string, length);
 	}
 }
@@ -57,8 +90,19 @@ static int _smart_string_insert(void *data, const char *string, int length, ssiz
 	Enesim_Text_Buffer_Smart *thiz = data;
 	if (thiz->real)
 	{
+		int old_length;
+		int ret;
+
+		old_length = enesim_text_buffer_length_get(thiz->real);
 		thiz->dirty = EINA_TRUE;
-		return enesim_text_buffer_string_insert(thiz->real, string, length, offset);
+		ret = enesim_text_buffer_string_insert(thiz->real, string, length, offset);
+		/* same offset sanitizing as the real buffers */
+		if (offset < 0 || offset > old_length)
+			offset = old_length;
+		if (ret > 0)
+			_smart_range_add(thiz, offset,
+					enesim_text_buffer_length_get(thiz->real) - offset - ret);
+		return ret;
 	}
 	return 0;
 }
@@ -68,8 +112,19 @@ static int _smart_string_delete(void *data, int length, ssize_t offset)
 	Enesim_Text_Buffer_Smart *thiz = data;
 	if (thiz->real)
 	{
+		int old_length;
+		int ret;
+
+		old_length = enesim_text_buffer_length_get(thiz->real);
 		thiz->dirty = EINA_TRUE;
-		return enesim_text_buffer_string_delete(thiz->real, length, offset);
+		ret = enesim_text_buffer_string_delete(thiz->real, length, offset);
+		/* a negative offset deletes from the end */
+		if (offset < 0)
+			offset = old_length - length;
+		if (ret > 0)
+			_smart_range_add(thiz, offset,
+					enesim_text_buffer_length_get(thiz->real) - offset);
+		return ret;
 	}
 	return 0;
 }
@@ -111,6 +166,31 @@ static Enesim_Text_Buffer_Descriptor _enesim_text_buffer_smart = {
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
+/* Get the range of characters modified since the last clear. The characters
+ * in [start, length - tail) must be laid out again, the rest are the same
+ */
+Eina_Bool enesim_text_buffer_smart_dirty_range_get(Enesim_Text_Buffer *b,
+		int *start, int *tail)
+{
+	Enesim_Text_Buffer_Smart *thiz;
+
+	thiz = enesim_text_buffer_data_get(b);
+	if (!thiz->dirty)
+		return EINA_FALSE;
+	/* dirty but nothing modified, the range is empty */
+	if (thiz->start < 0)
+	{
+		if (start) *start = thiz->real ?
+				enesim_text_buffer_length_get(thiz->real) : 0;
+		if (tail) *tail = 0;
+	}
+	else
+	{
+		if (start) *start = thiz->start;
+		if (tail) *tail = thiz->tail;
+	}
+	return EINA_TRUE;
+}
 /** @endcond */
 /*============================================================================*
  *                                   API                                      *
@@ -121,6 +201,7 @@ EAPI Enesim_Text_Buffer * enesim_text_buffer_smart_new(Enesim_Text_Buffer *real)
 
 	thiz = calloc(1, sizeof(Enesim_Text_Buffer_Smart));
 	thiz->real = real;
+	thiz->start = -1;
 	return enesim_text_buffer_new_from_descriptor(&_enesim_text_buffer_smart, thiz);
 }
 
@@ -148,6 +229,7 @@ EAPI void enesim_text_buffer_smart_real_set(Enesim_Text_Buffer *b,
 	}
 	thiz->real = real;
 	thiz->dirty = EINA_TRUE;
+	_smart_range_full(thiz);
 }
 
 EAPI void enesim_text_buffer_smart_dirty(Enesim_Text_Buffer *b)
@@ -156,6 +238,7 @@ EAPI void enesim_text_buffer_smart_dirty(Enesim_Text_Buffer *b)
 
 	thiz = enesim_text_buffer_data_get(b);
 	thiz->dirty = EINA_TRUE;
+	_smart_range_full(thiz);
 }
 
 EAPI void enesim_text_buffer_smart_clear(Enesim_Text_Buffer *b)
@@ -164,6 +247,8 @@ EAPI void enesim_text_buffer_smart_clear(Enesim_Text_Buffer *b)
 
 	thiz = enesim_text_buffer_data_get(b);
 	thiz->dirty = EINA_FALSE;
+	thiz->start = -1;
+	thiz->tail = 0;
 }
 
 EAPI Eina_Bool enesim_text_buffer_smart_is_dirty(Enesim_Text_Buffer *b)
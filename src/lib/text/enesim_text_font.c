@@ -37,6 +37,9 @@
 /** @cond internal */
 #define ENESIM_LOG_DEFAULT enesim_log_text
 
+/* fonts can be referenced from the preload threads */
+static Eina_Lock _lock;
+
 static Eina_Bool _dump(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata)
 {
 	Enesim_Text_Glyph *g = (Enesim_Text_Glyph *)data;
@@ -81,6 +84,16 @@ static void _enesim_text_font_instance_deinit(void *o)
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
+void enesim_text_font_init(void)
+{
+	eina_lock_new(&_lock);
+}
+
+void enesim_text_font_shutdown(void)
+{
+	eina_lock_free(&_lock);
+}
+
 Enesim_Text_Glyph * enesim_text_font_glyph_get(Enesim_Text_Font *thiz, Eina_Unicode c)
 {
 	Enesim_Text_Glyph *g;
@@ -88,15 +101,18 @@ Enesim_Text_Glyph * enesim_text_font_glyph_get(Enesim_Text_Font *thiz, Eina_Unic
 
 	if (!thiz)
 		return NULL;
-	g = eina_hash_find(thiz->glyphs, &c);
+	g = enesim_text_glyph_cache_find(thiz, c);
 	if (g)
-		return enesim_text_glyph_ref(g);
+		return g;
 	klass = ENESIM_TEXT_FONT_CLASS_GET(thiz);
 	if (klass->glyph_get)
 	{
 		g = klass->glyph_get(thiz, c);
-		g->font = enesim_text_font_ref(thiz);
-		g->code = c;
+		if (g)
+		{
+			g->font = enesim_text_font_ref(thiz);
+			g->code = c;
+		}
 	}
 
 	return g;
@@ -191,15 +207,21 @@ EAPI Enesim_Text_Font * enesim_text_font_new_file_from(
 EAPI Enesim_Text_Font * enesim_text_font_ref(Enesim_Text_Font *thiz)
 {
 	if (!thiz) return NULL;
+	eina_lock_take(&_lock);
 	thiz->ref++;
+	eina_lock_release(&_lock);
 	return thiz;
 }
 
 EAPI void enesim_text_font_unref(Enesim_Text_Font *thiz)
 {
+	int ref;
+
 	if (!thiz) return;
-	thiz->ref--;
-	if (!thiz->ref)
+	eina_lock_take(&_lock);
+	ref = --thiz->ref;
+	eina_lock_release(&_lock);
+	if (!ref)
 	{
 		enesim_object_instance_free(ENESIM_OBJECT_INSTANCE(thiz));
 	}
@@ -0,0 +1,230 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_private.h"
+
+#include "enesim_main.h"
+
+#include "enesim_text.h"
+#include "enesim_text_private.h"
+#include "enesim_thread_private.h"
+
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_LOG_DEFAULT enesim_log_text
+
+struct _Enesim_Text_Font_Preload
+{
+	Enesim_Text_Font *font;
+	Enesim_Text_Font_Range *ranges;
+	unsigned int count;
+	/* the fence */
+	Eina_Lock lock;
+	Eina_Condition cond;
+	Eina_Bool done;
+	Eina_Bool cancel;
+#ifdef BUILD_THREAD
+	Enesim_Thread tid;
+	Eina_Bool threaded;
+#endif
+};
+
+/* the cancel flag is written from the thread freeing the fence */
+static Eina_Bool _preload_is_cancelled(Enesim_Text_Font_Preload *thiz)
+{
+	Eina_Bool ret;
+
+	eina_lock_take(&thiz->lock);
+	ret = thiz->cancel;
+	eina_lock_release(&thiz->lock);
+
+	return ret;
+}
+
+static Eina_Bool _preload_glyph(Enesim_Text_Font_Preload *thiz,
+		Eina_Unicode c)
+{
+	Enesim_Text_Glyph *g;
+
+	if (_preload_is_cancelled(thiz))
+		return EINA_FALSE;
+	g = enesim_text_font_glyph_get(thiz->font, c);
+	if (!g)
+		return EINA_TRUE;
+	/* same formats as the text span uses */
+	if (enesim_text_glyph_load(g, ENESIM_TEXT_GLYPH_FORMAT_SURFACE |
+			ENESIM_TEXT_GLYPH_FORMAT_PATH))
+		enesim_text_glyph_cache(g);
+	else
+		enesim_text_glyph_unref(g);
+	return EINA_TRUE;
+}
+
+static void _preload_glyphs(Enesim_Text_Font_Preload *thiz)
+{
+	unsigned int i;
+
+	for (i = 0; i < thiz->count; i++)
+	{
+		Eina_Unicode first = thiz->ranges[i].first;
+		Eina_Unicode last = thiz->ranges[i].last;
+		Eina_Unicode c;
+
+		if (first > last)
+			continue;
+		/* the last one is loaded outside, it might be the biggest
+		 * codepoint and the loop would never end
+		 */
+		for (c = first; c < last; c++)
+		{
+			if (!_preload_glyph(thiz, c))
+				return;
+		}
+		if (!_preload_glyph(thiz, last))
+			return;
+	}
+}
+
+static void _preload_done(Enesim_Text_Font_Preload *thiz)
+{
+	eina_lock_take(&thiz->lock);
+	thiz->done = EINA_TRUE;
+	eina_condition_broadcast(&thiz->cond);
+	eina_lock_release(&thiz->lock);
+}
+
+#ifdef BUILD_THREAD
+#ifdef _WIN32
+static DWORD WINAPI _preload_run(void *data)
+#else
+static void * _preload_run(void *data)
+#endif
+{
+	Enesim_Text_Font_Preload *thiz = data;
+
+	_preload_glyphs(thiz);
+	_preload_done(thiz);
+
+#ifdef _WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+#endif
+/** @endcond */
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Rasterize a set of glyphs of a font on the background
+ * @param[in] thiz The font to preload the glyphs from
+ * @param[in] ranges The codepoint ranges to preload
+ * @param[in] count The number of ranges
+ * @return The fence to wait for the preload to finish
+ *
+ * The glyphs are loaded and stored on the glyph cache, so the first use of
+ * them does not need to rasterize them. The preload is done on a background
+ * thread, use enesim_text_font_preload_wait() to wait for it to finish. In
+ * case the thread can not be created the glyphs are loaded before returning.
+ * The returned fence must be freed with enesim_text_font_preload_free()
+ */
+EAPI Enesim_Text_Font_Preload * enesim_text_font_preload(Enesim_Text_Font *thiz,
+		const Enesim_Text_Font_Range *ranges, unsigned int count)
+{
+	Enesim_Text_Font_Preload *p;
+
+	if (!thiz) return NULL;
+
+	p = calloc(1, sizeof(Enesim_Text_Font_Preload));
+	p->font = enesim_text_font_ref(thiz);
+	if (count)
+	{
+		p->ranges = malloc(sizeof(Enesim_Text_Font_Range) * count);
+		memcpy(p->ranges, ranges, sizeof(Enesim_Text_Font_Range) * count);
+		p->count = count;
+	}
+	eina_lock_new(&p->lock);
+	eina_condition_new(&p->cond, &p->lock);
+#ifdef BUILD_THREAD
+	p->threaded = enesim_thread_new(&p->tid, _preload_run, p);
+	if (p->threaded)
+		return p;
+	WRN("Can not create the preload thread, loading the glyphs now");
+#endif
+	_preload_glyphs(p);
+	_preload_done(p);
+	return p;
+}
+
+/**
+ * @brief Check if a preload has finished
+ * @param[in] thiz The preload fence
+ * @return EINA_TRUE if every glyph has been loaded, EINA_FALSE otherwise
+ */
+EAPI Eina_Bool enesim_text_font_preload_is_done(Enesim_Text_Font_Preload *thiz)
+{
+	Eina_Bool ret;
+
+	if (!thiz) return EINA_TRUE;
+	eina_lock_take(&thiz->lock);
+	ret = thiz->done;
+	eina_lock_release(&thiz->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Wait for a preload to finish
+ * @param[in] thiz The preload fence
+ */
+EAPI void enesim_text_font_preload_wait(Enesim_Text_Font_Preload *thiz)
+{
+	if (!thiz) return;
+	eina_lock_take(&thiz->lock);
+	while (!thiz->done)
+		eina_condition_wait(&thiz->cond);
+	eina_lock_release(&thiz->lock);
+}
+
+/**
+ * @brief Free a preload fence
+ * @param[in] thiz The preload fence
+ *
+ * In case the preload has not finished yet, the pending glyphs are not
+ * loaded.
+ */
+EAPI void enesim_text_font_preload_free(Enesim_Text_Font_Preload *thiz)
+{
+	if (!thiz) return;
+
+	eina_lock_take(&thiz->lock);
+	thiz->cancel = EINA_TRUE;
+	eina_lock_release(&thiz->lock);
+	enesim_text_font_preload_wait(thiz);
+#ifdef BUILD_THREAD
+	if (thiz->threaded)
+		enesim_thread_free(thiz->tid);
+#endif
+	eina_condition_free(&thiz->cond);
+	eina_lock_free(&thiz->lock);
+	enesim_text_font_unref(thiz->font);
+	free(thiz->ranges);
+	free(thiz);
+}
@@ -56,6 +56,8 @@ typedef struct _Enesim_Text_Font_Class
 } Enesim_Text_Font_Class;
 
 Enesim_Object_Descriptor * enesim_text_font_descriptor_get(void);
+void enesim_text_font_init(void);
+void enesim_text_font_shutdown(void);
 Enesim_Text_Glyph * enesim_text_font_glyph_get(Enesim_Text_Font *f, Eina_Unicode c);
 Eina_Bool enesim_text_font_has_kerning(Enesim_Text_Font *f);
 void enesim_text_font_glyph_cache(Enesim_Text_Font *thiz, Enesim_Text_Glyph *g);
@@ -27,6 +27,9 @@
 /** @cond internal */
 #define ENESIM_LOG_DEFAULT enesim_log_text
 
+/* glyphs can be referenced from the preload threads */
+static Eina_Lock _lock;
+
 ENESIM_OBJECT_ABSTRACT_BOILERPLATE(ENESIM_OBJECT_DESCRIPTOR, Enesim_Text_Glyph,
 		Enesim_Text_Glyph_Class, enesim_text_glyph);
 /*----------------------------------------------------------------------------*
@@ -49,27 +52,51 @@ static void _enesim_text_glyph_instance_deinit(void *o EINA_UNUSED)
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
+void enesim_text_glyph_init(void)
+{
+	eina_lock_new(&_lock);
+}
+
+void enesim_text_glyph_shutdown(void)
+{
+	eina_lock_free(&_lock);
+}
+
 Enesim_Text_Glyph * enesim_text_glyph_ref(Enesim_Text_Glyph *thiz)
 {
 	if (!thiz)
 		return NULL;
+	eina_lock_take(&_lock);
 	thiz->ref++;
+	eina_lock_release(&_lock);
 	return thiz;
 }
 
 void enesim_text_glyph_unref(Enesim_Text_Glyph *thiz)
 {
+	int ref;
+
 	if (!thiz)
 		return;
-	thiz->ref--;
-	if (!thiz->ref)
+	eina_lock_take(&_lock);
+	ref = --thiz->ref;
+	eina_lock_release(&_lock);
+	if (!ref)
 	{
+		int i;
+
 		enesim_text_font_unref(thiz->font);
 		if (thiz->surface)
 		{
 			enesim_surface_unref(thiz->surface);
 			thiz->surface = NULL;
 		}
+		for (i = 0; i < ENESIM_TEXT_GLYPH_PHASES - 1; i++)
+		{
+			if (!thiz->phases[i]) continue;
+			enesim_surface_unref(thiz->phases[i]);
+			thiz->phases[i] = NULL;
+		}
 		if (thiz->path)
 		{
 			enesim_path_unref(thiz->path);
@@ -81,19 +108,13 @@ void enesim_text_glyph_unref(Enesim_Text_Glyph *thiz)
 
 void enesim_text_glyph_cache(Enesim_Text_Glyph *thiz)
 {
-	if (!thiz->cache)
-		enesim_text_font_glyph_cache(thiz->font,
-				enesim_text_glyph_ref(thiz));
+	enesim_text_glyph_cache_add(thiz);
 	enesim_text_glyph_unref(thiz);
-	thiz->cache++;
 }
 
 void enesim_text_glyph_uncache(Enesim_Text_Glyph *thiz)
 {
-	thiz->cache--;
-	if (!thiz->cache)
-		enesim_text_font_glyph_uncache(thiz->font, thiz);
-	enesim_text_glyph_unref(thiz);
+	enesim_text_glyph_cache_del(thiz);
 }
 
 Eina_Bool enesim_text_glyph_load(Enesim_Text_Glyph *thiz,
@@ -113,6 +134,59 @@ Eina_Bool enesim_text_glyph_load(Enesim_Text_Glyph *thiz,
 	return EINA_FALSE;
 }
 
+/* Get the surface to draw the glyph at x. The position is quantized to
+ * ENESIM_TEXT_GLYPH_PHASES steps per pixel, the surface of the fractional step
+ * must be drawn at the integer position ix. The surface belongs to the glyph
+ */
+Enesim_Surface * enesim_text_glyph_surface_get(Enesim_Text_Glyph *thiz,
+		double x, int *ix)
+{
+	Enesim_Text_Glyph_Class *klass;
+	Enesim_Surface *s;
+	Enesim_Surface *other = NULL;
+	int q;
+	int phase;
+
+	q = (int)floor((x * ENESIM_TEXT_GLYPH_PHASES) + 0.5);
+	*ix = (int)floor((double)q / ENESIM_TEXT_GLYPH_PHASES);
+	phase = q - (*ix * ENESIM_TEXT_GLYPH_PHASES);
+	if (!phase || !thiz->surface)
+		return thiz->surface;
+
+	eina_lock_take(&_lock);
+	s = thiz->phases[phase - 1];
+	eina_lock_release(&_lock);
+	if (s)
+		return s;
+
+	klass = ENESIM_TEXT_GLYPH_CLASS_GET(thiz);
+	if (!klass->phase_load)
+		goto snap;
+	s = klass->phase_load(thiz, phase);
+	if (!s)
+		goto snap;
+	/* another thread might have loaded the same phase */
+	eina_lock_take(&_lock);
+	if (thiz->phases[phase - 1])
+	{
+		other = s;
+		s = thiz->phases[phase - 1];
+	}
+	else
+	{
+		thiz->phases[phase - 1] = s;
+	}
+	eina_lock_release(&_lock);
+	if (other)
+		enesim_surface_unref(other);
+	else
+		enesim_text_glyph_cache_update(thiz);
+	return s;
+snap:
+	*ix = (int)floor(x + 0.5);
+	return thiz->surface;
+}
+
 double enesim_text_glyph_kerning_get(Enesim_Text_Glyph *thiz, Enesim_Text_Glyph *prev)
 {
 	Enesim_Text_Glyph_Class *klass;
@@ -0,0 +1,420 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_private.h"
+
+#include "enesim_main.h"
+
+#include "enesim_text.h"
+#include "enesim_text_private.h"
+
+/*
+ * The glyph cache is shared by every font. Every cached glyph is kept on a
+ * LRU list and its pixels are accounted against a global budget. Once the
+ * budget is exceeded the least recently used glyphs are removed from their
+ * font cache.
+ * Small glyphs are not allocated individually, instead they are rasterized
+ * into cells of bigger slabs. The surface of such glyphs points directly into
+ * the slab memory, so the slab cell is released once the surface is freed
+ */
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_LOG_DEFAULT enesim_log_text
+
+#define ENESIM_TEXT_GLYPH_CACHE_BUDGET (4 * 1024 * 1024)
+/* the side of a slab in pixels */
+#define ENESIM_TEXT_GLYPH_SLAB_SIZE 128
+/* the number of different cell sizes */
+#define ENESIM_TEXT_GLYPH_SLAB_CLASSES 2
+
+typedef struct _Enesim_Text_Glyph_Slab
+{
+	uint8_t *data;
+	/* the side of every cell in pixels */
+	int cell;
+	/* the mask of the cells in use, at most 64 cells per slab */
+	uint64_t used;
+	uint64_t full;
+} Enesim_Text_Glyph_Slab;
+
+static const int _cells[ENESIM_TEXT_GLYPH_SLAB_CLASSES] = { 16, 32 };
+
+static Eina_Lock _lock;
+static Eina_List *_lru = NULL;
+static Eina_List *_slabs[ENESIM_TEXT_GLYPH_SLAB_CLASSES];
+static size_t _budget = ENESIM_TEXT_GLYPH_CACHE_BUDGET;
+static size_t _bytes = 0;
+static unsigned int _glyphs = 0;
+static unsigned int _nslabs = 0;
+static unsigned int _hits = 0;
+static unsigned int _misses = 0;
+static unsigned int _evictions = 0;
+
+static int _slab_class_get(int w, int h)
+{
+	int i;
+
+	for (i = 0; i < ENESIM_TEXT_GLYPH_SLAB_CLASSES; i++)
+	{
+		if (w <= _cells[i] && h <= _cells[i])
+			return i;
+	}
+	return -1;
+}
+
+static size_t _surface_size_get(Enesim_Surface *s)
+{
+	int w, h;
+	int sc;
+
+	if (!s)
+		return 0;
+	enesim_surface_size_get(s, &w, &h);
+	sc = _slab_class_get(w, h);
+	if (sc >= 0)
+		return _cells[sc] * _cells[sc] * 4;
+	return w * h * 4;
+}
+
+static size_t _glyph_size_get(Enesim_Text_Glyph *g)
+{
+	size_t size;
+	int i;
+
+	size = _surface_size_get(g->surface);
+	for (i = 0; i < ENESIM_TEXT_GLYPH_PHASES - 1; i++)
+		size += _surface_size_get(g->phases[i]);
+	return size;
+}
+
+static void _slab_cell_free(void *data, void *user_data)
+{
+	Enesim_Text_Glyph_Slab *slab = user_data;
+	size_t offset;
+	int stride;
+	int x, y;
+	int idx;
+
+	stride = ENESIM_TEXT_GLYPH_SLAB_SIZE * 4;
+	offset = (uint8_t *)data - slab->data;
+	x = (offset % stride) / 4;
+	y = offset / stride;
+	idx = ((y / slab->cell) * (ENESIM_TEXT_GLYPH_SLAB_SIZE / slab->cell)) +
+			(x / slab->cell);
+
+	eina_lock_take(&_lock);
+	slab->used &= ~(((uint64_t)1) << idx);
+	if (!slab->used)
+	{
+		int sc;
+
+		sc = _slab_class_get(slab->cell, slab->cell);
+		_slabs[sc] = eina_list_remove(_slabs[sc], slab);
+		_nslabs--;
+		free(slab->data);
+		free(slab);
+	}
+	eina_lock_release(&_lock);
+}
+
+static void _glyph_free(void *data, void *user_data EINA_UNUSED)
+{
+	free(data);
+}
+
+static Enesim_Surface * _slab_surface_new(int sc, int w, int h)
+{
+	Enesim_Text_Glyph_Slab *slab = NULL;
+	Eina_List *l;
+	uint8_t *cdata;
+	int stride;
+	int idx;
+	int i;
+
+	eina_lock_take(&_lock);
+	EINA_LIST_FOREACH(_slabs[sc], l, slab)
+	{
+		if (slab->used != slab->full)
+			break;
+	}
+	if (!l)
+	{
+		int cells;
+
+		cells = ENESIM_TEXT_GLYPH_SLAB_SIZE / _cells[sc];
+		cells *= cells;
+
+		slab = calloc(1, sizeof(Enesim_Text_Glyph_Slab));
+		slab->data = malloc(ENESIM_TEXT_GLYPH_SLAB_SIZE *
+				ENESIM_TEXT_GLYPH_SLAB_SIZE * 4);
+		slab->cell = _cells[sc];
+		slab->full = cells == 64 ? ~((uint64_t)0) : (((uint64_t)1) << cells) - 1;
+		_slabs[sc] = eina_list_prepend(_slabs[sc], slab);
+		_nslabs++;
+	}
+	/* find the first free cell */
+	for (idx = 0; slab->used & (((uint64_t)1) << idx); idx++);
+	slab->used |= ((uint64_t)1) << idx;
+	eina_lock_release(&_lock);
+
+	stride = ENESIM_TEXT_GLYPH_SLAB_SIZE * 4;
+	cdata = slab->data;
+	cdata += (idx / (ENESIM_TEXT_GLYPH_SLAB_SIZE / slab->cell)) * slab->cell * stride;
+	cdata += (idx % (ENESIM_TEXT_GLYPH_SLAB_SIZE / slab->cell)) * slab->cell * 4;
+	/* the rasterizer only writes the covered pixels */
+	for (i = 0; i < h; i++)
+		memset(cdata + (i * stride), 0, w * 4);
+
+	return enesim_surface_new_data_from(ENESIM_FORMAT_ARGB8888, w, h,
+			EINA_FALSE, cdata, stride, _slab_cell_free, slab);
+}
+
+/* must be called with the lock taken, the evicted glyphs are returned
+ * to be unreferenced once the lock is released
+ */
+static Eina_List * _evict(Enesim_Text_Glyph *keep, Eina_Bool all)
+{
+	Eina_List *evicted = NULL;
+
+	while ((all || _bytes > _budget) && _lru)
+	{
+		Enesim_Text_Glyph *g;
+
+		g = eina_list_data_get(_lru);
+		if (g == keep)
+			break;
+
+		enesim_text_font_glyph_uncache(g->font, g);
+		_lru = eina_list_remove_list(_lru, g->lru);
+		g->lru = NULL;
+		g->cache = 0;
+		_bytes -= g->size;
+		_glyphs--;
+		_evictions++;
+		evicted = eina_list_append(evicted, g);
+	}
+	return evicted;
+}
+
+static void _evicted_free(Eina_List *evicted)
+{
+	Enesim_Text_Glyph *g;
+
+	EINA_LIST_FREE(evicted, g)
+		enesim_text_glyph_unref(g);
+}
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+void enesim_text_glyph_cache_init(void)
+{
+	eina_lock_new(&_lock);
+}
+
+void enesim_text_glyph_cache_shutdown(void)
+{
+	enesim_text_glyph_cache_flush();
+	if (_nslabs)
+		WRN("%d glyph slabs still in use", _nslabs);
+	eina_lock_free(&_lock);
+}
+
+Enesim_Text_Glyph * enesim_text_glyph_cache_find(Enesim_Text_Font *f,
+		Eina_Unicode c)
+{
+	Enesim_Text_Glyph *g;
+
+	eina_lock_take(&_lock);
+	g = eina_hash_find(f->glyphs, &c);
+	if (g)
+	{
+		_lru = eina_list_demote_list(_lru, g->lru);
+		g = enesim_text_glyph_ref(g);
+		_hits++;
+	}
+	else
+	{
+		_misses++;
+	}
+	eina_lock_release(&_lock);
+
+	return g;
+}
+
+void enesim_text_glyph_cache_add(Enesim_Text_Glyph *g)
+{
+	Eina_List *evicted;
+	size_t size;
+
+	eina_lock_take(&_lock);
+	size = _glyph_size_get(g);
+	if (!g->cache)
+	{
+		/* another thread might have cached the same glyph already */
+		if (eina_hash_find(g->font->glyphs, &g->code))
+		{
+			eina_lock_release(&_lock);
+			return;
+		}
+		enesim_text_font_glyph_cache(g->font, enesim_text_glyph_ref(g));
+		_lru = eina_list_append(_lru, g);
+		g->lru = eina_list_last(_lru);
+		_glyphs++;
+	}
+	else
+	{
+		_lru = eina_list_demote_list(_lru, g->lru);
+		_bytes -= g->size;
+	}
+	/* the surface might have been loaded after the glyph was cached */
+	g->size = size;
+	_bytes += size;
+	g->cache++;
+	evicted = _evict(g, EINA_FALSE);
+	eina_lock_release(&_lock);
+
+	_evicted_free(evicted);
+}
+
+void enesim_text_glyph_cache_del(Enesim_Text_Glyph *g)
+{
+	eina_lock_take(&_lock);
+	if (!g->cache)
+	{
+		eina_lock_release(&_lock);
+		return;
+	}
+	g->cache--;
+	if (g->cache)
+	{
+		eina_lock_release(&_lock);
+		return;
+	}
+	enesim_text_font_glyph_uncache(g->font, g);
+	_lru = eina_list_remove_list(_lru, g->lru);
+	g->lru = NULL;
+	_bytes -= g->size;
+	_glyphs--;
+	eina_lock_release(&_lock);
+
+	enesim_text_glyph_unref(g);
+}
+
+/* account the surfaces loaded after the glyph was cached */
+void enesim_text_glyph_cache_update(Enesim_Text_Glyph *g)
+{
+	Eina_List *evicted;
+	size_t size;
+
+	eina_lock_take(&_lock);
+	if (!g->cache)
+	{
+		eina_lock_release(&_lock);
+		return;
+	}
+	size = _glyph_size_get(g);
+	_bytes -= g->size;
+	g->size = size;
+	_bytes += size;
+	evicted = _evict(g, EINA_FALSE);
+	eina_lock_release(&_lock);
+
+	_evicted_free(evicted);
+}
+
+Enesim_Surface * enesim_text_glyph_cache_surface_new(int w, int h)
+{
+	void *data;
+	int sc;
+
+	if (w <= 0 || h <= 0)
+		return NULL;
+
+	sc = _slab_class_get(w, h);
+	if (sc >= 0)
+		return _slab_surface_new(sc, w, h);
+
+	data = calloc(w * h, sizeof(uint32_t));
+	return enesim_surface_new_data_from(ENESIM_FORMAT_ARGB8888, w, h,
+			EINA_FALSE, data, w * 4, _glyph_free, NULL);
+}
+/** @endcond */
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Set the maximum number of bytes the glyph cache can use
+ * @param[in] bytes The number of bytes
+ *
+ * Whenever the cached glyphs of every font use more memory than the
+ * budget, the least recently used glyphs are evicted from the cache.
+ */
+EAPI void enesim_text_glyph_cache_budget_set(size_t bytes)
+{
+	Eina_List *evicted;
+
+	eina_lock_take(&_lock);
+	_budget = bytes;
+	evicted = _evict(NULL, EINA_FALSE);
+	eina_lock_release(&_lock);
+
+	_evicted_free(evicted);
+}
+
+/**
+ * @brief Get the maximum number of bytes the glyph cache can use
+ * @return The number of bytes
+ */
+EAPI size_t enesim_text_glyph_cache_budget_get(void)
+{
+	return _budget;
+}
+
+/**
+ * @brief Get the statistics of the glyph cache
+ * @param[out] stats The statistics
+ */
+EAPI void enesim_text_glyph_cache_stats_get(Enesim_Text_Glyph_Cache_Stats *stats)
+{
+	if (!stats) return;
+
+	eina_lock_take(&_lock);
+	stats->budget = _budget;
+	stats->bytes = _bytes;
+	stats->glyphs = _glyphs;
+	stats->slabs = _nslabs;
+	stats->hits = _hits;
+	stats->misses = _misses;
+	stats->evictions = _evictions;
+	eina_lock_release(&_lock);
+}
+
+/**
+ * @brief Evict every glyph from the glyph cache
+ */
+EAPI void enesim_text_glyph_cache_flush(void)
+{
+	Eina_List *evicted;
+
+	eina_lock_take(&_lock);
+	evicted = _evict(NULL, EINA_TRUE);
+	eina_lock_release(&_lock);
+
+	_evicted_free(evicted);
+}
@@ -31,6 +31,10 @@
 #include "enesim_text_font_private.h"
 
 #define ENESIM_TEXT_GLYPH_DESCRIPTOR enesim_text_glyph_descriptor_get()
+/* the number of horizontal subpixel positions a glyph surface can be
+ * rasterized at
+ */
+#define ENESIM_TEXT_GLYPH_PHASES 4
 #define ENESIM_TEXT_GLYPH_CLASS(k) ENESIM_OBJECT_CLASS_CHECK(k, 		\
 		Enesim_Text_Glyph_Class, ENESIM_TEXT_GLYPH_DESCRIPTOR)
 #define ENESIM_TEXT_GLYPH_CLASS_GET(o) ENESIM_TEXT_GLYPH_CLASS(		\
@@ -48,6 +52,8 @@ typedef struct _Enesim_Text_Glyph
 	Enesim_Text_Font *font;
 	/* the surface associated with the glyph */
 	Enesim_Surface *surface;
+	/* the surfaces rasterized at a subpixel offset, loaded on demand */
+	Enesim_Surface *phases[ENESIM_TEXT_GLYPH_PHASES - 1];
 	/* the path associated with the glyph */
 	Enesim_Path *path;
 	/* the unicode char for this glyph */
@@ -57,6 +63,10 @@ typedef struct _Enesim_Text_Glyph
 	int x_advance;
 	int ref;
 	int cache;
+	/* the node on the glyph cache LRU list */
+	Eina_List *lru;
+	/* the number of bytes accounted on the glyph cache */
+	size_t size;
 } Enesim_Text_Glyph;
 
 typedef struct _Enesim_Text_Glyph_Class
@@ -65,6 +75,8 @@ typedef struct _Enesim_Text_Glyph_Class
 	/* load glyph */
 	Eina_Bool (*load)(Enesim_Text_Glyph *thiz, int formats);
 	double (*kerning_get)(Enesim_Text_Glyph *thiz, Enesim_Text_Glyph *prev);
+	/* rasterize the glyph moved phase / ENESIM_TEXT_GLYPH_PHASES pixels */
+	Enesim_Surface * (*phase_load)(Enesim_Text_Glyph *thiz, int phase);
 } Enesim_Text_Glyph_Class;
 
 typedef struct _Enesim_Text_Glyph_Position
@@ -81,11 +93,24 @@ typedef enum _Enesim_Text_Glyph_Format
 } Enesim_Text_Glyph_Format;
 
 Enesim_Object_Descriptor * enesim_text_glyph_descriptor_get(void);
+void enesim_text_glyph_init(void);
+void enesim_text_glyph_shutdown(void);
 Enesim_Text_Glyph * enesim_text_glyph_ref(Enesim_Text_Glyph *thiz);
 double enesim_text_glyph_kerning_get(Enesim_Text_Glyph *thiz, Enesim_Text_Glyph *prev);
 void enesim_text_glyph_unref(Enesim_Text_Glyph *thiz);
 Eina_Bool enesim_text_glyph_load(Enesim_Text_Glyph *thiz, int formats);
+Enesim_Surface * enesim_text_glyph_surface_get(Enesim_Text_Glyph *thiz,
+		double x, int *ix);
 void enesim_text_glyph_cache(Enesim_Text_Glyph *thiz);
 void enesim_text_glyph_uncache(Enesim_Text_Glyph *thiz);
 
+/* glyph cache */
+void enesim_text_glyph_cache_init(void);
+void enesim_text_glyph_cache_shutdown(void);
+Enesim_Text_Glyph * enesim_text_glyph_cache_find(Enesim_Text_Font *f, Eina_Unicode c);
+void enesim_text_glyph_cache_add(Enesim_Text_Glyph *g);
+void enesim_text_glyph_cache_del(Enesim_Text_Glyph *g);
+void enesim_text_glyph_cache_update(Enesim_Text_Glyph *g);
+Enesim_Surface * enesim_text_glyph_cache_surface_new(int w, int h);
+
 #endif
@@ -95,27 +95,42 @@ static void _raster_callback(const int y,
 	}
 }
 
-static void _enesim_text_glyph_freetype_load_surface(Enesim_Text_Glyph *g,
-		FT_GlyphSlot glyph)
+static Enesim_Surface * _enesim_text_glyph_freetype_surface_new(
+		Enesim_Text_Glyph *g, FT_GlyphSlot glyph, int phase)
 {
 	Enesim_Text_Glyph_Freetype_Load_Data efg;
 	Enesim_Buffer_Sw_Data sdata;
+	Enesim_Surface *s;
 	FT_Library lib;
 	FT_Outline *outline = &glyph->outline;
 	FT_Raster_Params params;
 	unsigned int width, height;
+	size_t stride;
 	void *gdata;
 
 	lib = enesim_text_engine_freetype_lib_get(g->font->engine);
 	width = glyph->metrics.width >> 6;
 	height = glyph->metrics.height >> 6;
 	if (!width || !height)
-		return;
+		return NULL;
+	/* move the outline to the subpixel position, the coverage spreads
+	 * at most one pixel more to the right
+	 */
+	if (phase)
+	{
+		FT_Outline_Translate(outline,
+				(phase * 64) / ENESIM_TEXT_GLYPH_PHASES, 0);
+		width++;
+	}
 
-	gdata = calloc(width * height, sizeof(uint32_t));
+	/* the glyph cache gives us a cleared area to render into */
+	s = enesim_text_glyph_cache_surface_new(width, height);
+	if (!s)
+		return NULL;
+	enesim_surface_sw_data_get(s, &gdata, &stride);
 
 	sdata.argb8888_pre.plane0 = gdata;
-	sdata.argb8888_pre.plane0_stride = width * 4;
+	sdata.argb8888_pre.plane0_stride = stride;
 
 	efg.data = &sdata;
 	efg.glyph = glyph;
@@ -126,10 +141,13 @@ static void _enesim_text_glyph_freetype_load_surface(Enesim_Text_Glyph *g,
 	params.user = &efg;
 
 	FT_Outline_Render(lib, outline, &params);
-	g->surface = enesim_surface_new_data_from(
-			ENESIM_FORMAT_ARGB8888, width, height,
-			EINA_FALSE, gdata, width * 4, NULL,
-			NULL);
+	return s;
+}
+
+static void _enesim_text_glyph_freetype_load_surface(Enesim_Text_Glyph *g,
+		FT_GlyphSlot glyph)
+{
+	g->surface = _enesim_text_glyph_freetype_surface_new(g, glyph, 0);
 }
 
 static Eina_Bool _enesim_text_glyph_freetype_load_path(Enesim_Text_Glyph *g,
@@ -350,6 +368,27 @@ static Eina_Bool _enesim_text_glyph_freetype_load(Enesim_Text_Glyph *g,
 	return EINA_TRUE;
 }
 
+static Enesim_Surface * _enesim_text_glyph_freetype_phase_load(
+		Enesim_Text_Glyph *g, int phase)
+{
+	Enesim_Text_Glyph_Freetype *thiz;
+	Enesim_Surface *s = NULL;
+	FT_Face face;
+
+	enesim_text_engine_freetype_lock(g->font->engine);
+	face = enesim_text_font_freetype_face_get(g->font);
+
+	thiz = ENESIM_TEXT_GLYPH_FREETYPE(g);
+	if (!FT_Load_Glyph(face, thiz->index, FT_LOAD_NO_BITMAP))
+	{
+		if (face->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+			s = _enesim_text_glyph_freetype_surface_new(g,
+					face->glyph, phase);
+	}
+	enesim_text_engine_freetype_unlock(g->font->engine);
+	return s;
+}
+
 static double _enesim_text_glyph_freetype_kerning_get(Enesim_Text_Glyph *g,
 		Enesim_Text_Glyph *prev)
 {
@@ -382,6 +421,7 @@ static void _enesim_text_glyph_freetype_class_init(void *k)
 	Enesim_Text_Glyph_Class *klass = k;
 	klass->load = _enesim_text_glyph_freetype_load;
 	klass->kerning_get = _enesim_text_glyph_freetype_kerning_get;
+	klass->phase_load = _enesim_text_glyph_freetype_phase_load;
 }
 
 static void _enesim_text_glyph_freetype_instance_init(void *o EINA_UNUSED)
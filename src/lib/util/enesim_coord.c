@@ -99,6 +99,35 @@ void enesim_coord_projective_setup(Eina_F16p16 *fpx, Eina_F16p16 *fpy,
 	*fpy = eina_f16p16_sub(*fpy, oy);
 }
 
+void enesim_coord_matrix_from(Enesim_Coord_Matrix *dst,
+		const Enesim_Matrix *m)
+{
+	dst->xx = enesim_coord_double_from(m->xx);
+	dst->xy = enesim_coord_double_from(m->xy);
+	dst->xz = enesim_coord_double_from(m->xz);
+	dst->yx = enesim_coord_double_from(m->yx);
+	dst->yy = enesim_coord_double_from(m->yy);
+	dst->yz = enesim_coord_double_from(m->yz);
+	dst->zx = enesim_coord_double_from(m->zx);
+	dst->zy = enesim_coord_double_from(m->zy);
+	dst->zz = enesim_coord_double_from(m->zz);
+}
+
+/*
+ * x' = (xx * x) + (xy * y) + xz;
+ * y' = (yx * x) + (yy * y) + yz;
+ * with the increments of moving one pixel to the right
+ */
+void enesim_coord_stepper_affine_setup(Enesim_Coord_Stepper *s,
+		double x, double y, double pre_x, double pre_y,
+		const Enesim_Matrix *matrix)
+{
+	s->x = (matrix->xx * x) + (matrix->xy * y) + matrix->xz - pre_x;
+	s->y = (matrix->yx * x) + (matrix->yy * y) + matrix->yz - pre_y;
+	s->dx = matrix->xx;
+	s->dy = matrix->yx;
+}
+
 /**
  * Sampling algorithms,
  * A pixel goes from 0 to 1, with its center placed on the top-left corner,
@@ -24,13 +24,110 @@
  * like Enesim_Matrix_F16p16
  */
 
-#define Enesim_Coord Eina_F16p16
+/* The fixed point coordinates are 16.16 by default. Configuring with
+ * --enable-coord-32p32 makes them 32.32, slower but needed for images drawn
+ * on canvases bigger than 32K pixels or with deep zooms. For now only the
+ * image renderer uses them, the rest still uses the Eina 16.16 ones
+ */
+#ifdef ENESIM_COORD_32P32
+typedef int64_t Enesim_Coord;
+#define ENESIM_COORD_SHIFT 32
+#else
+typedef int32_t Enesim_Coord;
+#define ENESIM_COORD_SHIFT 16
+#endif
+
+#define ENESIM_COORD_ONE ((Enesim_Coord)1 << ENESIM_COORD_SHIFT)
+#define ENESIM_COORD_HALF (ENESIM_COORD_ONE >> 1)
+#define ENESIM_COORD_FRACC_MASK (ENESIM_COORD_ONE - 1)
+
+typedef struct _Enesim_Coord_Matrix
+{
+	Enesim_Coord xx, xy, xz;
+	Enesim_Coord yx, yy, yz;
+	Enesim_Coord zx, zy, zz;
+} Enesim_Coord_Matrix;
+
+static inline Enesim_Coord enesim_coord_int_from(int v)
+{
+	return (Enesim_Coord)v * ENESIM_COORD_ONE;
+}
+
+static inline int enesim_coord_int_to(Enesim_Coord v)
+{
+	return (int)(v >> ENESIM_COORD_SHIFT);
+}
+
+static inline Enesim_Coord enesim_coord_double_from(double v)
+{
+	return (Enesim_Coord)(v * ENESIM_COORD_ONE + (v < 0 ? -0.5 : 0.5));
+}
+
+static inline double enesim_coord_double_to(Enesim_Coord v)
+{
+	return (double)v / ENESIM_COORD_ONE;
+}
+
+static inline Enesim_Coord enesim_coord_mul(Enesim_Coord a, Enesim_Coord b)
+{
+#ifdef ENESIM_COORD_32P32
+#ifdef __SIZEOF_INT128__
+	return (Enesim_Coord)(((__int128)a * b) >> ENESIM_COORD_SHIFT);
+#else
+	/* the partial products are done unsigned, the wrap around gives the
+	 * same low 64 bits of the signed result without any overflow
+	 */
+	uint64_t ah = (uint64_t)(a >> 32), bh = (uint64_t)(b >> 32);
+	uint64_t al = a & 0xffffffff, bl = b & 0xffffffff;
+	uint64_t r;
+
+	r = (ah * bh) << 32;
+	r += (ah * bl) + (al * bh) + ((al * bl) >> 32);
+	return (Enesim_Coord)r;
+#endif
+#else
+	return (Enesim_Coord)(((int64_t)a * b) >> ENESIM_COORD_SHIFT);
+#endif
+}
+
+static inline Enesim_Coord enesim_coord_fracc_get(Enesim_Coord v)
+{
+	return v & ENESIM_COORD_FRACC_MASK;
+}
+
+/* the fractional part on the [1, 256] range used for interpolating */
+static inline uint16_t enesim_coord_fracc_256_get(Enesim_Coord v)
+{
+	return 1 + (enesim_coord_fracc_get(v) >> (ENESIM_COORD_SHIFT - 8));
+}
+
+/* The hot steppers can also work with floating point coordinates. The
+ * coordinates of a span are calculated in chunks by multiplying the
+ * increment by the offset from the start of the span instead of adding it
+ * every pixel, so the error does not accumulate on long spans and the
+ * compiler can vectorize the loop with multiply-adds
+ */
+#define ENESIM_COORD_STEPPER_CHUNK 64
+
+typedef struct _Enesim_Coord_Stepper
+{
+	double x, y;
+	double dx, dy;
+} Enesim_Coord_Stepper;
+
+static inline void enesim_coord_stepper_get(const Enesim_Coord_Stepper *s,
+		int offset, int len, double * restrict xs, double * restrict ys)
+{
+	int i;
 
-#define enesim_coord_subpixel_get 0
-#define enesim_coord_double_from
-#define enesim_coord_double_to
-#define enesim_coord_int_to
-#define enesim_coord_int_from
+	for (i = 0; i < len; i++)
+	{
+		double n = offset + i;
+
+		xs[i] = s->x + n * s->dx;
+		ys[i] = s->y + n * s->dy;
+	}
+}
 
 /* Helper functions needed by other renderers */
 static inline Eina_F16p16 enesim_point_f16p16_transform(Eina_F16p16 x, Eina_F16p16 y,
@@ -80,6 +177,12 @@ void enesim_coord_projective_setup(Eina_F16p16 *fpx, Eina_F16p16 *fpy,
 		Eina_F16p16 *fpz, int x, int y, double pre_x, double pre_y,
 		const Enesim_Matrix_F16p16 *matrix);
 
+void enesim_coord_matrix_from(Enesim_Coord_Matrix *dst,
+		const Enesim_Matrix *m);
+void enesim_coord_stepper_affine_setup(Enesim_Coord_Stepper *s,
+		double x, double y, double pre_x, double pre_y,
+		const Enesim_Matrix *matrix);
+
 uint32_t enesim_coord_sample_good_restrict(uint32_t *data, size_t stride, int sw,
 		int sh, Eina_F16p16 xx, Eina_F16p16 yy);
 uint32_t enesim_coord_sample_good_repeat(uint32_t *data, size_t stride, int sw,
@@ -39,9 +39,13 @@ Eina_Bool enesim_thread_win32_new(HANDLE *thread, LPTHREAD_START_ROUTINE callbac
 Eina_Bool enesim_thread_posix_new(pthread_t *thread, void *(*callback)(void *d), void *data)
 {
 	pthread_attr_t attr;
+	int ret;
 
 	pthread_attr_init(&attr);
-	return pthread_create(thread, &attr, callback, data);
+	ret = pthread_create(thread, &attr, callback, data);
+	pthread_attr_destroy(&attr);
+	/* same as the win32 version, EINA_TRUE on success */
+	return ret == 0;
 }
 
 void enesim_thread_posix_affinity_set(pthread_t thread, int cpunum)
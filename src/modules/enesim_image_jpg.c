@@ -11,6 +11,10 @@
 
 #include <jpeglib.h>
 
+#ifdef ENS_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
 /*============================================================================*
  *                                  Local                                     *
  *============================================================================*/
@@ -33,6 +37,8 @@
 #define DBG(...) EINA_LOG_DOM_DBG(enesim_image_log_dom_jpg, __VA_ARGS__)
 
 #define JPG_BLOCK_SIZE 4096
+/* the number of rows decoded before notifying them */
+#define JPG_BAND_ROWS 16
 
 typedef struct _Jpg_Error_Mgr Jpg_Error_Mgr;
 typedef struct _Jpg_Source Jpg_Source;
@@ -54,6 +60,17 @@ struct _Jpg_Error_Mgr
 
 static int enesim_image_log_dom_jpg = -1;
 
+/* libjpeg can only scale the DCT by 1/2, 1/4 and 1/8 */
+static void _jpg_scale_setup(struct jpeg_decompress_struct *cinfo,
+		Enesim_Image_Scale_Options *options)
+{
+	if (!options)
+		return;
+	cinfo->scale_num = 1;
+	cinfo->scale_denom = enesim_image_scale_options_scale_get(options,
+			cinfo->image_width, cinfo->image_height);
+}
+
 static void _jpg_error_exit_cb(j_common_ptr cinfo)
 {
 	Jpg_Error_Mgr *err;
@@ -76,6 +93,26 @@ static const char * _jpg_name_get(void)
 	return "jpg";
 }
 
+static int _jpg_formats_get(Enesim_Buffer_Format *formats,
+		void *options EINA_UNUSED, Eina_Error *err EINA_UNUSED)
+{
+	/* besides the image format, it can be decoded directly into a
+	 * premultiplied buffer
+	 */
+	formats[0] = ENESIM_BUFFER_FORMAT_ARGB8888_PRE;
+	return 1;
+}
+
+static void * _jpg_options_parse(const char *options)
+{
+	return enesim_image_scale_options_parse(options);
+}
+
+static void _jpg_options_free(void *options)
+{
+	enesim_image_scale_options_free(options);
+}
+
 static void _jpg_enesim_image_src_init(j_decompress_ptr cinfo)
 {
 	/* TODO check if we can mmap the buffer, if so map it and use
@@ -145,7 +182,7 @@ static void _jpg_enesim_image_src(struct jpeg_decompress_struct *cinfo, Enesim_S
  *                         Enesim Image Provider API                          *
  *----------------------------------------------------------------------------*/
 static Eina_Bool _jpg_info_get(Enesim_Stream *data, int *w, int *h,
-		Enesim_Buffer_Format *sfmt, void *options EINA_UNUSED,
+		Enesim_Buffer_Format *sfmt, void *options,
 		Eina_Error *error)
 {
 	Jpg_Error_Mgr err;
@@ -193,8 +230,11 @@ static Eina_Bool _jpg_info_get(Enesim_Stream *data, int *w, int *h,
 		break;
 	}
 
+	_jpg_scale_setup(&cinfo, options);
+	/* no need to start the decompression, the output dimensions and
+	 * components are known at this point
+	 */
 	jpeg_calc_output_dimensions(&(cinfo));
-	jpeg_start_decompress(&cinfo);
 
 	ww = cinfo.output_width;
 	hh = cinfo.output_height;
@@ -223,15 +263,247 @@ static Eina_Bool _jpg_info_get(Enesim_Stream *data, int *w, int *h,
 	return EINA_TRUE;
 }
 
-static Eina_Bool _jpg_load(Enesim_Stream *data, Enesim_Buffer *buffer,
-		void *options EINA_UNUSED, Eina_Error *error)
+#ifdef ENS_HAVE_SSE2
+/* The sse2 versions convert the pixels from the end of the row, four or
+ * sixteen at a time, and return the number of pixels left at the beginning.
+ * The source pixels of a group are always loaded before the group is stored,
+ * the stores never reach the source bytes of the groups still pending
+ */
+static int _jpg_row_convert_cmyk_sse2(uint32_t *dst, const uint8_t *src,
+		int len, Eina_Bool adobe)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c255 = _mm_set1_epi16(255);
+	const __m128i alpha = _mm_set1_epi32(0xff000000);
+
+	while (len >= 4)
+	{
+		__m128i v, lo, hi, klo, khi;
+
+		len -= 4;
+		v = _mm_loadu_si128((const __m128i *)(src + (len * 4)));
+		lo = _mm_unpacklo_epi8(v, zero);
+		hi = _mm_unpackhi_epi8(v, zero);
+		if (!adobe)
+		{
+			lo = _mm_sub_epi16(c255, lo);
+			hi = _mm_sub_epi16(c255, hi);
+		}
+		klo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo,
+				_MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		khi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi,
+				_MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, klo), c255), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, khi), c255), 8);
+		/* swap the r and b components */
+		lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo,
+				_MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+		hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi,
+				_MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+		v = _mm_or_si128(_mm_packus_epi16(lo, hi), alpha);
+		_mm_storeu_si128((__m128i *)(dst + len), v);
+	}
+	return len;
+}
+
+static int _jpg_row_convert_rgb_sse2(uint32_t *dst, const uint8_t *src,
+		int len)
+{
+	const __m128i lane0 = _mm_set_epi32(0, 0, 0, 0xffffffff);
+	const __m128i lane1 = _mm_set_epi32(0, 0, 0xffffffff, 0);
+	const __m128i lane2 = _mm_set_epi32(0, 0xffffffff, 0, 0);
+	const __m128i lane3 = _mm_set_epi32(0xffffffff, 0, 0, 0);
+	const __m128i rb = _mm_set1_epi32(0x000000ff);
+	const __m128i g = _mm_set1_epi32(0x0000ff00);
+	const __m128i alpha = _mm_set1_epi32(0xff000000);
+
+	/* the twelve bytes of a group are loaded together with the four
+	 * previous ones, so the load never goes past the end of the row
+	 */
+	while (len >= 6)
+	{
+		__m128i v, p;
+
+		len -= 4;
+		v = _mm_loadu_si128((const __m128i *)(src + (len * 3) - 4));
+		v = _mm_srli_si128(v, 4);
+		/* move the three bytes of every pixel into its own lane */
+		p = _mm_and_si128(v, lane0);
+		p = _mm_or_si128(p, _mm_and_si128(_mm_slli_si128(v, 1), lane1));
+		p = _mm_or_si128(p, _mm_and_si128(_mm_slli_si128(v, 2), lane2));
+		p = _mm_or_si128(p, _mm_and_si128(_mm_slli_si128(v, 3), lane3));
+		/* swap the r and b components */
+		v = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, rb), 16),
+				_mm_and_si128(_mm_srli_epi32(p, 16), rb));
+		v = _mm_or_si128(v, _mm_and_si128(p, g));
+		v = _mm_or_si128(v, alpha);
+		_mm_storeu_si128((__m128i *)(dst + len), v);
+	}
+	return len;
+}
+
+static int _jpg_row_convert_gray_sse2(uint32_t *dst, const uint8_t *src,
+		int len)
+{
+	const __m128i alpha = _mm_set1_epi32(0xff000000);
+
+	while (len >= 16)
+	{
+		__m128i v, lo, hi;
+
+		len -= 16;
+		v = _mm_loadu_si128((const __m128i *)(src + len));
+		lo = _mm_unpacklo_epi8(v, v);
+		hi = _mm_unpackhi_epi8(v, v);
+		_mm_storeu_si128((__m128i *)(dst + len),
+				_mm_or_si128(_mm_unpacklo_epi16(lo, lo), alpha));
+		_mm_storeu_si128((__m128i *)(dst + len + 4),
+				_mm_or_si128(_mm_unpackhi_epi16(lo, lo), alpha));
+		_mm_storeu_si128((__m128i *)(dst + len + 8),
+				_mm_or_si128(_mm_unpacklo_epi16(hi, hi), alpha));
+		_mm_storeu_si128((__m128i *)(dst + len + 12),
+				_mm_or_si128(_mm_unpackhi_epi16(hi, hi), alpha));
+	}
+	return len;
+}
+#endif
+
+/* Convert a decoded row into argb8888_pre. It is done from the end to the
+ * beginning, so the row can be decoded in place, all the pixels are opaque
+ */
+static void _jpg_row_convert(uint32_t *dst, const uint8_t *src, int len,
+		int components, Eina_Bool adobe)
+{
+#ifdef ENS_HAVE_SSE2
+	switch (components)
+	{
+		case 4:
+		len = _jpg_row_convert_cmyk_sse2(dst, src, len, adobe);
+		break;
+
+		case 3:
+		len = _jpg_row_convert_rgb_sse2(dst, src, len);
+		break;
+
+		case 1:
+		len = _jpg_row_convert_gray_sse2(dst, src, len);
+		break;
+	}
+#endif
+	dst += len - 1;
+	src += (len - 1) * components;
+	switch (components)
+	{
+		case 4:
+		/* see the importer renderer for the cmyk conversion */
+		while (len--)
+		{
+			uint8_t r, g, b;
+
+			if (adobe)
+			{
+				r = (src[0] * src[3] + 255) >> 8;
+				g = (src[1] * src[3] + 255) >> 8;
+				b = (src[2] * src[3] + 255) >> 8;
+			}
+			else
+			{
+				r = ((255 - src[0]) * (255 - src[3]) + 255) >> 8;
+				g = ((255 - src[1]) * (255 - src[3]) + 255) >> 8;
+				b = ((255 - src[2]) * (255 - src[3]) + 255) >> 8;
+			}
+			*dst-- = 0xff000000 | r << 16 | g << 8 | b;
+			src -= 4;
+		}
+		break;
+
+		case 3:
+		while (len--)
+		{
+			*dst-- = 0xff000000 | src[0] << 16 | src[1] << 8 | src[2];
+			src -= 3;
+		}
+		break;
+
+		case 1:
+		while (len--)
+		{
+			*dst-- = 0xff000000 | *src << 16 | *src << 8 | *src;
+			src--;
+		}
+		break;
+	}
+}
+
+/* Read the scanlines of an output pass, only the rows inside the area are
+ * kept, and notify every band of rows written
+ */
+static void _jpg_pass_read(struct jpeg_decompress_struct *cinfo,
+		Enesim_Buffer *buffer, uint8_t *sdata, int stride,
+		const Eina_Rectangle *area, JSAMPROW scratch, Eina_Bool convert,
+		Enesim_Image_Progress cb, void *cb_data, Eina_Bool final)
+{
+	int bpp = cinfo->output_components;
+	int w = area ? area->w : (int)cinfo->output_width;
+	int top = 0;
+	int bottom = cinfo->output_height;
+	int band = 0;
+
+	if (area)
+	{
+		top = area->y;
+		bottom = area->y + area->h;
+	}
+
+	while ((int)cinfo->output_scanline < bottom)
+	{
+		JSAMPROW row;
+		int y = cinfo->output_scanline;
+
+		/* decode directly into the buffer if possible */
+		if (area)
+			row = scratch;
+		else
+			row = sdata + (y * stride);
+		jpeg_read_scanlines(cinfo, &row, 1);
+		if (y < top)
+			continue;
+		if (area)
+		{
+			if (convert)
+				_jpg_row_convert((uint32_t *)(sdata + ((y - top) * stride)),
+						scratch + (area->x * bpp), w, bpp,
+						cinfo->saw_Adobe_marker);
+			else
+				memcpy(sdata + ((y - top) * stride),
+						scratch + (area->x * bpp), w * bpp);
+		}
+		else if (convert)
+		{
+			/* while the row is still on the cache */
+			_jpg_row_convert((uint32_t *)row, row, w, bpp,
+					cinfo->saw_Adobe_marker);
+		}
+		y = y - top + 1;
+		if (cb && (!(y % JPG_BAND_ROWS) || y == bottom - top))
+		{
+			cb(buffer, band, y - band, final, cb_data);
+			band = y;
+		}
+	}
+}
+
+static Eina_Bool _jpg_load_progressive(Enesim_Stream *data,
+		Enesim_Buffer *buffer, const Eina_Rectangle *area,
+		Enesim_Image_Progress cb, void *cb_data, void *options,
+		Eina_Error *error)
 {
 	Jpg_Error_Mgr err;
 	Enesim_Buffer_Sw_Data sw_data;
 	struct jpeg_decompress_struct cinfo;
-	JSAMPROW row;
+	JSAMPROW volatile scratch = NULL;
+	Eina_Bool convert = EINA_FALSE;
 	uint8_t *sdata;
-	uint8_t *line;
 	int stride;
 
 	memset(&cinfo, 0, sizeof(cinfo));
@@ -240,6 +512,7 @@ static Eina_Bool _jpg_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 	if (setjmp(err.setjmp_buffer))
 	{
 		jpeg_destroy_decompress(&cinfo);
+		free(scratch);
 		*error = ENESIM_IMAGE_ERROR_ALLOCATOR;
 		return EINA_FALSE;
 	}
@@ -270,55 +543,99 @@ static Eina_Bool _jpg_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 		break;
 	}
 
+	_jpg_scale_setup(&cinfo, options);
+	/* show every scan of a progressive image as soon as it arrives */
+	if (cb && jpeg_has_multiple_scans(&cinfo))
+		cinfo.buffered_image = TRUE;
 	jpeg_calc_output_dimensions(&(cinfo));
 	jpeg_start_decompress(&cinfo);
 
 	enesim_buffer_sw_data_get(buffer, &sw_data);
-	switch (cinfo.output_components)
+	/* the pixels are converted into the destination rows directly, the
+	 * decoded components always fit on them
+	 */
+	if (enesim_buffer_format_get(buffer) == ENESIM_BUFFER_FORMAT_ARGB8888_PRE)
 	{
-		case 4:
-		sdata = sw_data.cmyk.plane0;
-		stride = sw_data.cmyk.plane0_stride;
-		break;
-
-		case 3:
-		sdata = sw_data.bgr888.plane0;
-		stride = sw_data.bgr888.plane0_stride;
-		break;
+		sdata = (uint8_t *)sw_data.argb8888_pre.plane0;
+		stride = sw_data.argb8888_pre.plane0_stride;
+		convert = EINA_TRUE;
+	}
+	else
+	{
+		switch (cinfo.output_components)
+		{
+			case 4:
+			sdata = sw_data.cmyk.plane0;
+			stride = sw_data.cmyk.plane0_stride;
+			break;
+
+			case 3:
+			sdata = sw_data.bgr888.plane0;
+			stride = sw_data.bgr888.plane0_stride;
+			break;
+
+			case 1:
+			sdata = sw_data.a8.plane0;
+			stride = sw_data.a8.plane0_stride;
+			break;
+
+			default:
+			jpeg_destroy_decompress(&cinfo);
+			*error = ENESIM_IMAGE_ERROR_FORMAT;
+			return EINA_FALSE;
+		}
+	}
 
-		case 1:
-		sdata = sw_data.a8.plane0;
-		stride = sw_data.a8.plane0_stride;
-		break;
+	if (area)
+		scratch = malloc(cinfo.output_width * cinfo.output_components);
 
-		default:
-		jpeg_destroy_decompress(&cinfo);
-		*error = ENESIM_IMAGE_ERROR_FORMAT;
-		return EINA_FALSE;
+	if (cinfo.buffered_image)
+	{
+		/* every output pass is based on the scans read so far, the
+		 * image is final once the whole input is consumed
+		 */
+		while (!jpeg_input_complete(&cinfo))
+		{
+			jpeg_start_output(&cinfo, cinfo.input_scan_number);
+			_jpg_pass_read(&cinfo, buffer, sdata, stride, area,
+					scratch, convert, cb, cb_data, EINA_FALSE);
+			jpeg_finish_output(&cinfo);
+		}
+		cb(buffer, 0, area ? area->h : (int)cinfo.output_height,
+				EINA_TRUE, cb_data);
 	}
-
-	line = sdata;
-	while (cinfo.output_scanline < cinfo.output_height)
+	else
 	{
-		row = line;
-		jpeg_read_scanlines(&cinfo, &row, 1);
-		line += stride;
+		_jpg_pass_read(&cinfo, buffer, sdata, stride, area, scratch,
+				convert, cb, cb_data, EINA_TRUE);
 	}
+	/* in case of an area the decompression might not be complete, no
+	 * need to finish it, destroying it is enough
+	 */
 	jpeg_destroy_decompress(&cinfo);
+	free(scratch);
 	return EINA_TRUE;
 }
 
+static Eina_Bool _jpg_load(Enesim_Stream *data, Enesim_Buffer *buffer,
+		void *options, Eina_Error *error)
+{
+	return _jpg_load_progressive(data, buffer, NULL, NULL, NULL, options,
+			error);
+}
+
 static Enesim_Image_Provider_Descriptor _provider = {
 	/* .version_get = 	*/ _jpg_version_get,
 	/* .name_get =		*/ _jpg_name_get,
-	/* .options_parse =	*/ NULL,
-	/* .options_free =	*/ NULL,
+	/* .options_parse =	*/ _jpg_options_parse,
+	/* .options_free =	*/ _jpg_options_free,
 	/* .loadable =		*/ NULL,
 	/* .saveable =		*/ NULL,
 	/* .info_get =		*/ _jpg_info_get,
-	/* .formats_get =	*/ NULL,
+	/* .formats_get =	*/ _jpg_formats_get,
 	/* .load =		*/ _jpg_load,
 	/* .save =		*/ NULL,
+	/* .load_progressive =	*/ _jpg_load_progressive,
 };
 
 static const char * _jpg_data_from(Enesim_Stream *data)
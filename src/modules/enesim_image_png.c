@@ -6,6 +6,10 @@
 
 #include "Enesim.h"
 #include "png.h"
+
+#ifdef ENS_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 /*============================================================================*
  *                                  Local                                     *
  *============================================================================*/
@@ -33,8 +37,75 @@
 #endif
 #define DBG(...) EINA_LOG_DOM_DBG(enesim_image_log_dom_png, __VA_ARGS__)
 
+/* the number of rows decoded before notifying them */
+#define PNG_BAND_ROWS 16
+
 static int enesim_image_log_dom_png = -1;
 
+/* premultiply a row of argb8888 pixels in place, two channels at once */
+static void _png_row_premul(uint32_t *row, int len)
+{
+#ifdef ENS_HAVE_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	/* the alpha is multiplied by 256 so it is kept as is */
+	const __m128i amask = _mm_set_epi16(0xffff, 0, 0, 0, 0xffff, 0, 0, 0);
+	const __m128i a256 = _mm_set_epi16(256, 0, 0, 0, 256, 0, 0, 0);
+
+	while (len >= 4)
+	{
+		__m128i v, lo, hi, alo, ahi;
+
+		v = _mm_loadu_si128((__m128i *)row);
+		lo = _mm_unpacklo_epi8(v, zero);
+		hi = _mm_unpackhi_epi8(v, zero);
+		alo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo,
+				_MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+		ahi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi,
+				_MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+		alo = _mm_or_si128(_mm_andnot_si128(amask, alo), a256);
+		ahi = _mm_or_si128(_mm_andnot_si128(amask, ahi), a256);
+		lo = _mm_srli_epi16(_mm_mullo_epi16(lo, alo), 8);
+		hi = _mm_srli_epi16(_mm_mullo_epi16(hi, ahi), 8);
+		_mm_storeu_si128((__m128i *)row, _mm_packus_epi16(lo, hi));
+		row += 4;
+		len -= 4;
+	}
+#endif
+	while (len--)
+	{
+		uint32_t p = *row;
+		uint32_t a = (p >> 24) + 1;
+
+		if (a != 256)
+		{
+			*row = (p & 0xff000000) |
+					((((p >> 8) & 0xff) * a) & 0xff00) |
+					((((p & 0x00ff00ff) * a) >> 8) & 0x00ff00ff);
+		}
+		row++;
+	}
+}
+
+/* keep one every scale pixels of a row */
+static void _png_row_decimate(unsigned char *dst, const unsigned char *src,
+		int w, int scale, int src_inc, int dst_inc)
+{
+	int x;
+
+	if (scale == 1 && src_inc == dst_inc)
+	{
+		memcpy(dst, src, w * dst_inc);
+		return;
+	}
+	for (x = 0; x < w; x++)
+	{
+		memcpy(dst, src, dst_inc);
+		dst += dst_inc;
+		src += src_inc * scale;
+	}
+}
+
 static void _png_msg_error_cb(png_structp png_ptr EINA_UNUSED, png_const_charp error_msg)
 {
 	ERR("%s", error_msg);
@@ -110,10 +181,31 @@ static const char * _png_name_get(void)
 	return "png";
 }
 
+static int _png_formats_get(Enesim_Buffer_Format *formats,
+		void *options EINA_UNUSED, Eina_Error *err EINA_UNUSED)
+{
+	/* besides the image format, it can be decoded directly into a
+	 * premultiplied buffer
+	 */
+	formats[0] = ENESIM_BUFFER_FORMAT_ARGB8888_PRE;
+	return 1;
+}
+
+static void * _png_options_parse(const char *options)
+{
+	return enesim_image_scale_options_parse(options);
+}
+
+static void _png_options_free(void *options)
+{
+	enesim_image_scale_options_free(options);
+}
+
 static Eina_Bool _png_info_get(Enesim_Stream *data, int *w, int *h,
-		Enesim_Buffer_Format *sfmt, void *options EINA_UNUSED,
+		Enesim_Buffer_Format *sfmt, void *options,
 		Eina_Error *err)
 {
+	int scale;
 	png_uint_32 w32, h32;
 	png_structp png_ptr = NULL;
 	png_infop info_ptr = NULL;
@@ -136,8 +228,9 @@ static Eina_Bool _png_info_get(Enesim_Stream *data, int *w, int *h,
 	png_get_IHDR(png_ptr, info_ptr, (png_uint_32 *) (&w32),
 			(png_uint_32 *) (&h32), &bit_depth, &color_type,
 			&interlace_type, NULL, NULL);
-	if (w) *w = w32;
-	if (h) *h = h32;
+	scale = enesim_image_scale_options_scale_get(options, w32, h32);
+	if (w) *w = (w32 + scale - 1) / scale;
+	if (h) *h = (h32 + scale - 1) / scale;
 	if (!sfmt)
 		goto error_jmp;
 
@@ -159,23 +252,76 @@ error_read_struct:
 	return EINA_FALSE;
 }
 
-static Eina_Bool _png_load(Enesim_Stream *data, Enesim_Buffer *buffer,
-		void *options EINA_UNUSED, Eina_Error *err)
+/* copy the area of a decoded image, keeping one every scale pixels */
+static void _png_area_copy(unsigned char *dst, int stride,
+		unsigned char **lines, int x, int y, int w, int h, int scale,
+		int src_inc, int dst_inc, Eina_Bool premul)
 {
+	int i;
+
+	for (i = 0; i < h; i++)
+	{
+		_png_row_decimate(dst, lines[(y + i) * scale] +
+				(x * scale * src_inc), w, scale, src_inc,
+				dst_inc);
+		if (premul)
+			_png_row_premul((uint32_t *)dst, w);
+		dst += stride;
+	}
+}
+
+static Eina_Bool _png_load_progressive(Enesim_Stream *data,
+		Enesim_Buffer *buffer, const Eina_Rectangle *area,
+		Enesim_Image_Progress cb, void *cb_data, void *options,
+		Eina_Error *err)
+{
+	png_bytep volatile tmp = NULL;
 	Enesim_Buffer_Sw_Data sw_data;
 	Enesim_Buffer_Format fmt;
 	png_uint_32 w32, h32;
 	png_structp png_ptr = NULL;
 	png_infop info_ptr = NULL;
-	uint32_t *sdata;
-	int bit_depth, color_type, interlace_type;
+	png_size_t rowbytes;
+	unsigned char *sdata;
 	unsigned char **lines;
+	int bit_depth, color_type, interlace_type;
 	char hasa, hasg;
 	unsigned int i;
 	int pixel_inc;
+	int src_inc;
+	int scale;
+	int passes;
+	int stride;
+	int x, y, w, h;
+	Eina_Bool direct;
+	Eina_Bool premul = EINA_FALSE;
+	Eina_Bool hasalpha;
 
 	enesim_buffer_sw_data_get(buffer, &sw_data);
-	sdata = sw_data.argb8888.plane0;
+	switch (enesim_buffer_format_get(buffer))
+	{
+		case ENESIM_BUFFER_FORMAT_ARGB8888_PRE:
+		premul = EINA_TRUE;
+		/* fall through */
+		case ENESIM_BUFFER_FORMAT_ARGB8888:
+		sdata = (unsigned char *)sw_data.argb8888.plane0;
+		stride = sw_data.argb8888.plane0_stride;
+		break;
+
+		case ENESIM_BUFFER_FORMAT_RGB888:
+		sdata = sw_data.rgb888.plane0;
+		stride = sw_data.rgb888.plane0_stride;
+		break;
+
+		case ENESIM_BUFFER_FORMAT_A8:
+		sdata = sw_data.a8.plane0;
+		stride = sw_data.a8.plane0_stride;
+		break;
+
+		default:
+		*err = ENESIM_IMAGE_ERROR_FORMAT;
+		return EINA_FALSE;
+	}
 
 	hasa = 0;
 	hasg = 0;
@@ -221,8 +367,12 @@ static Eina_Bool _png_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 	png_set_strip_16(png_ptr);
 	/* pack all pixels to byte boundaires */
 	png_set_packing(png_ptr);
+	hasalpha = hasa;
 	if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+	{
 		png_set_expand(png_ptr);
+		hasalpha = 1;
+	}
 
 #ifdef WORDS_BIGENDIAN
 	png_set_swap_alpha(png_ptr);
@@ -230,11 +380,28 @@ static Eina_Bool _png_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 	png_set_bgr(png_ptr);
 #endif
 
-	pixel_inc = enesim_buffer_format_rgb_depth_get(fmt) / 8;
-	if (!pixel_inc)
-		goto error_jmp;
-
-	lines = (unsigned char **) alloca(h32 * sizeof(unsigned char *));
+	if (premul)
+	{
+		/* let libpng swizzle every pixel into a 32 bits one, the
+		 * premultiplication is done on each row once decoded
+		 */
+		if (!hasalpha)
+		{
+#ifdef WORDS_BIGENDIAN
+			png_set_filler(png_ptr, 0xff, PNG_FILLER_BEFORE);
+#else
+			png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+#endif
+		}
+		pixel_inc = 4;
+	}
+	else
+	{
+		pixel_inc = enesim_buffer_format_rgb_depth_get(fmt) / 8;
+		if (!pixel_inc)
+			goto error_jmp;
+	}
+	premul = premul && hasalpha;
 
 	if (hasg)
 	{
@@ -247,19 +414,118 @@ static Eina_Bool _png_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 			//png_set_gray_1_2_4_to_8(png_ptr);
 		}
 	}
-	/* setup the pointers */
-	for (i = 0; i < h32; i++)
+	passes = png_set_interlace_handling(png_ptr);
+	png_read_update_info(png_ptr, info_ptr);
+	rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+	src_inc = rowbytes / w32;
+
+	/* the area of the scaled image to keep */
+	scale = enesim_image_scale_options_scale_get(options, w32, h32);
+	if (area)
+	{
+		x = area->x;
+		y = area->y;
+		w = area->w;
+		h = area->h;
+	}
+	else
+	{
+		x = 0;
+		y = 0;
+		w = (w32 + scale - 1) / scale;
+		h = (h32 + scale - 1) / scale;
+	}
+	/* decode directly into the buffer when every pixel is kept as is,
+	 * the passes of an interlaced image can not be premultiplied in place
+	 */
+	direct = !area && scale == 1 && src_inc == pixel_inc &&
+			!(premul && passes > 1);
+
+	if (passes > 1)
+	{
+		/* every pass touches every row, the rows must be kept until
+		 * the last one
+		 */
+		lines = (unsigned char **) alloca(h32 * sizeof(unsigned char *));
+		if (!direct)
+			tmp = malloc(rowbytes * h32);
+		for (i = 0; i < h32; i++)
+		{
+			if (direct)
+				lines[i] = sdata + (i * stride);
+			else
+				lines[i] = tmp + (i * rowbytes);
+		}
+		while (passes--)
+		{
+			/* fill the pixels of the next passes too, that way
+			 * every pass is a coarse version of the image
+			 */
+			for (i = 0; i < h32; i++)
+				png_read_row(png_ptr, NULL, lines[i]);
+			if (!cb && passes)
+				continue;
+			if (!direct)
+				_png_area_copy(sdata, stride, lines, x, y, w, h,
+						scale, src_inc, pixel_inc, premul);
+			if (cb)
+				cb(buffer, 0, h, !passes, cb_data);
+		}
+		png_read_end(png_ptr, info_ptr);
+	}
+	else
 	{
-		lines[i] = ((unsigned char *)(sdata)) + (i * w32
-				* pixel_inc);
+		int band = 0;
+
+		if (!direct)
+			tmp = malloc(rowbytes);
+		for (i = 0; i < h32; i++)
+		{
+			int oy;
+
+			if (direct)
+			{
+				png_read_row(png_ptr, sdata + (i * stride), NULL);
+				/* while the row is still on the cache */
+				if (premul)
+					_png_row_premul((uint32_t *)(sdata + (i * stride)), w);
+				oy = i;
+			}
+			else
+			{
+				/* only keep the rows we need */
+				png_read_row(png_ptr, tmp, NULL);
+				if (i % scale)
+					continue;
+				oy = (i / scale) - y;
+				if (oy < 0)
+					continue;
+				_png_row_decimate(sdata + (oy * stride),
+						tmp + (x * scale * src_inc), w,
+						scale, src_inc, pixel_inc);
+				if (premul)
+					_png_row_premul((uint32_t *)(sdata + (oy * stride)), w);
+			}
+			oy++;
+			if (cb && (!(oy % PNG_BAND_ROWS) || oy == h))
+			{
+				cb(buffer, band, oy - band, EINA_TRUE, cb_data);
+				band = oy;
+			}
+			/* no need to read the rest of the image */
+			if (oy == h)
+				break;
+		}
+		if (i == h32)
+			png_read_end(png_ptr, info_ptr);
 	}
-	png_read_image(png_ptr, lines);
-	png_read_end(png_ptr, info_ptr);
+	free(tmp);
 
 	png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 	return EINA_TRUE;
 
 error_jmp:
+	free(tmp);
 	png_destroy_info_struct(png_ptr, (png_infopp)&info_ptr);
 error_info_struct:
 	png_destroy_read_struct(&png_ptr, NULL, NULL);
@@ -268,6 +534,13 @@ error_read_struct:
 	return EINA_FALSE;
 }
 
+static Eina_Bool _png_load(Enesim_Stream *data, Enesim_Buffer *buffer,
+		void *options, Eina_Error *err)
+{
+	return _png_load_progressive(data, buffer, NULL, NULL, NULL, options,
+			err);
+}
+
 static Eina_Bool _png_save(Enesim_Stream *data, Enesim_Buffer *b,
 		void *options EINA_UNUSED, Eina_Error *err)
 {
@@ -365,14 +638,15 @@ error_write_struct:
 static Enesim_Image_Provider_Descriptor _provider = {
 	/* .version_get = 	*/ _png_version_get,
 	/* .name_get = 		*/ _png_name_get,
-	/* .options_parse = 	*/ NULL,
-	/* .options_free = 	*/ NULL,
+	/* .options_parse = 	*/ _png_options_parse,
+	/* .options_free = 	*/ _png_options_free,
 	/* .loadable = 		*/ NULL,
 	/* .saveable = 		*/ NULL,
 	/* .info_get = 		*/ _png_info_get,
-	/* .formats_get =	*/ NULL,
+	/* .formats_get =	*/ _png_formats_get,
 	/* .load = 		*/ _png_load,
 	/* .save = 		*/ _png_save,
+	/* .load_progressive =	*/ _png_load_progressive,
 };
 
 static const char * _png_data_from(Enesim_Stream *data)
@@ -14,7 +14,10 @@ src/tests/enesim_test_eina_pool \
 src/tests/enesim_test_renderer \
 src/tests/enesim_test_renderer_error \
 src/tests/enesim_test_object01 \
-src/tests/enesim_test_damages
+src/tests/enesim_test_damages \
+src/tests/enesim_test_prepared \
+src/tests/enesim_test_matrix \
+src/tests/enesim_test_image_context
 
 if HAVE_OPENCL
 check_PROGRAMS += \
@@ -43,6 +46,18 @@ src_tests_enesim_test_damages_SOURCES = src/tests/enesim_test_damages.c
 src_tests_enesim_test_damages_LDADD = $(tests_LDADD)
 src_tests_enesim_test_damages_CPPFLAGS = $(tests_CPPFLAGS)
 
+src_tests_enesim_test_prepared_SOURCES = src/tests/enesim_test_prepared.c
+src_tests_enesim_test_prepared_LDADD = $(tests_LDADD)
+src_tests_enesim_test_prepared_CPPFLAGS = $(tests_CPPFLAGS)
+
+src_tests_enesim_test_matrix_SOURCES = src/tests/enesim_test_matrix.c
+src_tests_enesim_test_matrix_LDADD = $(tests_LDADD) -lm
+src_tests_enesim_test_matrix_CPPFLAGS = $(tests_CPPFLAGS)
+
+src_tests_enesim_test_image_context_SOURCES = src/tests/enesim_test_image_context.c
+src_tests_enesim_test_image_context_LDADD = $(tests_LDADD)
+src_tests_enesim_test_image_context_CPPFLAGS = $(tests_CPPFLAGS)
+
 src_tests_enesim_test_opencl_pool_SOURCES = src/tests/enesim_test_opencl_pool.c
 src_tests_enesim_test_opencl_pool_LDADD = $(tests_LDADD)
 src_tests_enesim_test_opencl_pool_CPPFLAGS = $(tests_CPPFLAGS)
@@ -0,0 +1,118 @@
+#include "Enesim.h"
+
+#include <unistd.h>
+
+/* Submit several jobs to a context with workers, dispatch them and free the
+ * context with some jobs still pending, every callback must be called once
+ */
+#define TEST_MIME "image/x-enesim-test"
+#define TEST_JOBS 16
+
+static const char * _test_name_get(void)
+{
+	return "test";
+}
+
+static Eina_Bool _test_info_get(Enesim_Stream *data EINA_UNUSED,
+		int *w EINA_UNUSED, int *h EINA_UNUSED,
+		Enesim_Buffer_Format *sfmt EINA_UNUSED, void *options EINA_UNUSED,
+		Eina_Error *err EINA_UNUSED)
+{
+	return EINA_FALSE;
+}
+
+static Eina_Bool _test_load(Enesim_Stream *data EINA_UNUSED,
+		Enesim_Buffer *b EINA_UNUSED, void *options EINA_UNUSED,
+		Eina_Error *err EINA_UNUSED)
+{
+	return EINA_FALSE;
+}
+
+/* keep the workers busy for a while */
+static Eina_Bool _test_save(Enesim_Stream *data EINA_UNUSED,
+		Enesim_Buffer *b EINA_UNUSED, void *options EINA_UNUSED,
+		Eina_Error *err EINA_UNUSED)
+{
+	usleep(1000);
+	return EINA_TRUE;
+}
+
+static Enesim_Image_Provider_Descriptor _test_provider = {
+	/* .version_get = 	*/ NULL,
+	/* .name_get = 		*/ _test_name_get,
+	/* .options_parse = 	*/ NULL,
+	/* .options_free = 	*/ NULL,
+	/* .loadable = 		*/ NULL,
+	/* .saveable = 		*/ NULL,
+	/* .info_get = 		*/ _test_info_get,
+	/* .formats_get = 	*/ NULL,
+	/* .load = 		*/ _test_load,
+	/* .save = 		*/ _test_save,
+	/* .load_progressive = 	*/ NULL,
+};
+
+static void _test_cb(Enesim_Buffer *b EINA_UNUSED, void *data,
+		Eina_Bool success EINA_UNUSED, Eina_Error error EINA_UNUSED)
+{
+	int *called = data;
+	(*called)++;
+}
+
+static void _submit(Enesim_Image_Context *c, Enesim_Buffer *b, int *called)
+{
+	int i;
+
+	for (i = 0; i < TEST_JOBS; i++)
+	{
+		if (!enesim_image_context_save_async(c, NULL, TEST_MIME, b,
+				_test_cb, called, NULL))
+			printf("Job %d can not be submitted\n", i);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	Enesim_Image_Context *c;
+	Enesim_Buffer *b;
+	Eina_Bool ret = EINA_TRUE;
+	int called = 0;
+	int tries;
+
+	enesim_init();
+	enesim_image_provider_register(&_test_provider,
+			ENESIM_PRIORITY_PRIMARY, TEST_MIME);
+	b = enesim_buffer_new(ENESIM_BUFFER_FORMAT_ARGB8888_PRE, 1, 1);
+
+	/* wait for every job to finish */
+	c = enesim_image_context_new_workers(4);
+	_submit(c, b, &called);
+	for (tries = 0; called < TEST_JOBS && tries < 1000; tries++)
+	{
+		usleep(1000);
+		enesim_image_context_dispatch(c);
+	}
+	if (called != TEST_JOBS)
+	{
+		printf("Only %d of %d jobs dispatched\n", called, TEST_JOBS);
+		ret = EINA_FALSE;
+	}
+	enesim_image_context_free(c);
+
+	/* free the context while the workers are still running */
+	called = 0;
+	c = enesim_image_context_new_workers(4);
+	_submit(c, b, &called);
+	enesim_image_context_free(c);
+	if (called != TEST_JOBS)
+	{
+		printf("Only %d of %d jobs dispatched on free\n", called,
+				TEST_JOBS);
+		ret = EINA_FALSE;
+	}
+
+	enesim_buffer_unref(b);
+	enesim_image_provider_unregister(&_test_provider, TEST_MIME);
+	enesim_shutdown();
+
+	return ret ? 0 : 1;
+}
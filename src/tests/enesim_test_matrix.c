@@ -0,0 +1,89 @@
+#include "Enesim.h"
+
+#include <math.h>
+
+/* Classify a set of matrices and check the type, the hints and the snapped
+ * translation for every quality
+ */
+static Eina_Bool _check(const char *name, const Enesim_Matrix *m,
+		Enesim_Quality quality, Enesim_Matrix_Type type,
+		Enesim_Matrix_Hint hints)
+{
+	Enesim_Matrix snapped;
+	Enesim_Matrix_Type t;
+	Enesim_Matrix_Hint h;
+
+	t = enesim_matrix_classify(m, quality, &snapped, &h);
+	if (t != type || h != hints)
+	{
+		printf("%s with quality %d: type %d hints %d instead of "
+				"type %d hints %d\n", name, quality, t, h,
+				type, hints);
+		return EINA_FALSE;
+	}
+	return EINA_TRUE;
+}
+
+int main(int argc, char **argv)
+{
+	Enesim_Matrix m;
+	Enesim_Matrix snapped;
+	Eina_Bool ret = EINA_TRUE;
+
+	enesim_init();
+
+	enesim_matrix_identity(&m);
+	ret &= _check("identity", &m, ENESIM_QUALITY_BEST,
+			ENESIM_MATRIX_TYPE_IDENTITY, ENESIM_MATRIX_HINT_NONE);
+
+	/* the rounding errors are always discarded */
+	enesim_matrix_values_set(&m, 1, 1e-12, 0, -1e-12, 1, 0, 0, 0, 1);
+	ret &= _check("rounding errors", &m, ENESIM_QUALITY_BEST,
+			ENESIM_MATRIX_TYPE_IDENTITY, ENESIM_MATRIX_HINT_NONE);
+
+	enesim_matrix_translate(&m, 10, -3);
+	ret &= _check("integer translation", &m, ENESIM_QUALITY_BEST,
+			ENESIM_MATRIX_TYPE_AFFINE, ENESIM_MATRIX_HINT_TRANSLATE |
+			ENESIM_MATRIX_HINT_INTEGER_TRANSLATE);
+
+	/* a translation close to a pixel boundary depends on the quality */
+	enesim_matrix_translate(&m, 10.01, 3);
+	ret &= _check("translation", &m, ENESIM_QUALITY_BEST,
+			ENESIM_MATRIX_TYPE_AFFINE, ENESIM_MATRIX_HINT_TRANSLATE);
+	ret &= _check("translation", &m, ENESIM_QUALITY_GOOD,
+			ENESIM_MATRIX_TYPE_AFFINE, ENESIM_MATRIX_HINT_TRANSLATE);
+	ret &= _check("translation", &m, ENESIM_QUALITY_FAST,
+			ENESIM_MATRIX_TYPE_AFFINE, ENESIM_MATRIX_HINT_TRANSLATE |
+			ENESIM_MATRIX_HINT_INTEGER_TRANSLATE);
+	enesim_matrix_classify(&m, ENESIM_QUALITY_FAST, &snapped, NULL);
+	if (snapped.xz != 10 || snapped.yz != 3)
+	{
+		printf("translation snapped to %g %g\n", snapped.xz, snapped.yz);
+		ret = EINA_FALSE;
+	}
+
+	enesim_matrix_scale(&m, 2, 2);
+	ret &= _check("scale", &m, ENESIM_QUALITY_BEST,
+			ENESIM_MATRIX_TYPE_AFFINE, ENESIM_MATRIX_HINT_SCALE);
+
+	/* a tiny rotation is only snapped for the lower qualities */
+	enesim_matrix_values_set(&m, cos(1e-6), -sin(1e-6), 0,
+			sin(1e-6), cos(1e-6), 0, 0, 0, 1);
+	ret &= _check("tiny rotation", &m, ENESIM_QUALITY_BEST,
+			ENESIM_MATRIX_TYPE_AFFINE, ENESIM_MATRIX_HINT_NONE);
+	ret &= _check("tiny rotation", &m, ENESIM_QUALITY_FAST,
+			ENESIM_MATRIX_TYPE_IDENTITY, ENESIM_MATRIX_HINT_NONE);
+
+	enesim_matrix_values_set(&m, cos(M_PI / 4), -sin(M_PI / 4), 0,
+			sin(M_PI / 4), cos(M_PI / 4), 0, 0, 0, 1);
+	ret &= _check("rotation", &m, ENESIM_QUALITY_FAST,
+			ENESIM_MATRIX_TYPE_AFFINE, ENESIM_MATRIX_HINT_NONE);
+
+	enesim_matrix_values_set(&m, 1, 0, 0, 0, 1, 0, 0.5, 0, 1);
+	ret &= _check("projective", &m, ENESIM_QUALITY_FAST,
+			ENESIM_MATRIX_TYPE_PROJECTIVE, ENESIM_MATRIX_HINT_NONE);
+
+	enesim_shutdown();
+
+	return ret ? 0 : 1;
+}
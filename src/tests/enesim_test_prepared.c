@@ -0,0 +1,81 @@
+#include "Enesim.h"
+
+#include <string.h>
+
+/* Draw a renderer kept prepared, move it and draw it again, the pixels must
+ * follow the new geometry
+ */
+static uint32_t _pixel_get(Enesim_Surface *s, int x, int y)
+{
+	uint32_t *data;
+	size_t stride;
+
+	enesim_surface_sw_data_get(s, (void **)&data, &stride);
+	return *(uint32_t *)((uint8_t *)data + (y * stride) + (x * 4));
+}
+
+static void _clear(Enesim_Surface *s)
+{
+	void *data;
+	size_t stride;
+	int h;
+
+	enesim_surface_sw_data_get(s, &data, &stride);
+	enesim_surface_size_get(s, NULL, &h);
+	memset(data, 0, stride * h);
+}
+
+static Eina_Bool _check(Enesim_Surface *s, int x, int y, uint32_t color)
+{
+	uint32_t p;
+
+	p = _pixel_get(s, x, y);
+	if (p != color)
+	{
+		printf("Pixel at %d %d is %08x instead of %08x\n", x, y, p, color);
+		return EINA_FALSE;
+	}
+	return EINA_TRUE;
+}
+
+int main(int argc, char **argv)
+{
+	Enesim_Renderer *r;
+	Enesim_Surface *s;
+	Eina_Bool ret = EINA_TRUE;
+
+	enesim_init();
+	r = enesim_renderer_rectangle_new();
+	enesim_renderer_shape_fill_color_set(r, 0xffffffff);
+	enesim_renderer_shape_draw_mode_set(r, ENESIM_RENDERER_SHAPE_DRAW_MODE_FILL);
+	enesim_renderer_rectangle_x_set(r, 0);
+	enesim_renderer_rectangle_y_set(r, 0);
+	enesim_renderer_rectangle_width_set(r, 50.0);
+	enesim_renderer_rectangle_height_set(r, 50.0);
+	enesim_renderer_keep_prepared_set(r, EINA_TRUE);
+
+	s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, 320, 240);
+
+	/* the first draw prepares the renderer, the second one keeps it */
+	enesim_renderer_draw(r, s, ENESIM_ROP_FILL, NULL, 0, 0, NULL);
+	enesim_renderer_draw(r, s, ENESIM_ROP_FILL, NULL, 0, 0, NULL);
+	ret &= _check(s, 25, 25, 0xffffffff);
+	ret &= _check(s, 125, 25, 0x00000000);
+
+	/* move it */
+	enesim_renderer_rectangle_x_set(r, 100);
+	_clear(s);
+	enesim_renderer_draw(r, s, ENESIM_ROP_FILL, NULL, 0, 0, NULL);
+	ret &= _check(s, 25, 25, 0x00000000);
+	ret &= _check(s, 125, 25, 0xffffffff);
+
+	/* and draw it again without any change */
+	enesim_renderer_draw(r, s, ENESIM_ROP_FILL, NULL, 0, 0, NULL);
+	ret &= _check(s, 125, 25, 0xffffffff);
+
+	enesim_renderer_unref(r);
+	enesim_surface_unref(s);
+	enesim_shutdown();
+
+	return ret ? 0 : 1;
+}